@@ -114,6 +114,10 @@ void initialize_config()
 	#endif
 	config.sound_latency = 1;	// 100msec
 	config.sound_strict_rendering = true;
+	config.sound_parallel_mixing = false;
+	config.sound_native_rate = false;
+	config.sound_audio_thread = false;
+	config.sound_record_registers = 0;	// 1 = vgm, 2 = s98
 	#ifdef USE_FLOPPY_DISK
 		config.sound_noise_fdd = true;
 	#endif
@@ -140,6 +144,11 @@ void initialize_config()
 		config.joy_to_key_buttons[1] = -('X');
 	#endif
 	
+	// printer
+	#ifdef USE_PRINTER
+		config.printer_pnm_output = false;
+	#endif
+	
 	// win32
 	#ifdef _WIN32
 		#ifndef ONE_BOARD_MICRO_COMPUTER
@@ -315,6 +324,10 @@ void load_config(const _TCHAR* config_path)
 	config.sound_frequency = MyGetPrivateProfileInt(_T("Sound"), _T("Frequency"), config.sound_frequency, config_path);
 	config.sound_latency = MyGetPrivateProfileInt(_T("Sound"), _T("Latency"), config.sound_latency, config_path);
 	config.sound_strict_rendering = MyGetPrivateProfileBool(_T("Sound"), _T("StrictRendering"), config.sound_strict_rendering, config_path);
+	config.sound_parallel_mixing = MyGetPrivateProfileBool(_T("Sound"), _T("ParallelMixing"), config.sound_parallel_mixing, config_path);
+	config.sound_native_rate = MyGetPrivateProfileBool(_T("Sound"), _T("NativeRate"), config.sound_native_rate, config_path);
+	config.sound_audio_thread = MyGetPrivateProfileBool(_T("Sound"), _T("AudioThread"), config.sound_audio_thread, config_path);
+	config.sound_record_registers = MyGetPrivateProfileInt(_T("Sound"), _T("RecordRegisters"), config.sound_record_registers, config_path);
 	#ifdef USE_FLOPPY_DISK
 		config.sound_noise_fdd = MyGetPrivateProfileBool(_T("Sound"), _T("NoiseFDD"), config.sound_noise_fdd, config_path);
 	#endif
@@ -374,6 +387,7 @@ void load_config(const _TCHAR* config_path)
 	// printer
 	#ifdef USE_PRINTER
 		MyGetPrivateProfileString(_T("Printer"), _T("PrinterDll"), _T("printer.dll"), config.printer_dll_path, _MAX_PATH, config_path);
+		config.printer_pnm_output = MyGetPrivateProfileBool(_T("Printer"), _T("PnmOutput"), config.printer_pnm_output, config_path);
 	#endif
 	
 	// win32
@@ -559,6 +573,10 @@ void save_config(const _TCHAR* config_path)
 	MyWritePrivateProfileInt(_T("Sound"), _T("Frequency"), config.sound_frequency, config_path);
 	MyWritePrivateProfileInt(_T("Sound"), _T("Latency"), config.sound_latency, config_path);
 	MyWritePrivateProfileBool(_T("Sound"), _T("StrictRendering"), config.sound_strict_rendering, config_path);
+	MyWritePrivateProfileBool(_T("Sound"), _T("ParallelMixing"), config.sound_parallel_mixing, config_path);
+	MyWritePrivateProfileBool(_T("Sound"), _T("NativeRate"), config.sound_native_rate, config_path);
+	MyWritePrivateProfileBool(_T("Sound"), _T("AudioThread"), config.sound_audio_thread, config_path);
+	MyWritePrivateProfileInt(_T("Sound"), _T("RecordRegisters"), config.sound_record_registers, config_path);
 	#ifdef USE_FLOPPY_DISK
 		MyWritePrivateProfileBool(_T("Sound"), _T("NoiseFDD"), config.sound_noise_fdd, config_path);
 	#endif
@@ -596,6 +614,11 @@ void save_config(const _TCHAR* config_path)
 		}
 	#endif
 	
+	// printer
+	#ifdef USE_PRINTER
+		MyWritePrivateProfileBool(_T("Printer"), _T("PnmOutput"), config.printer_pnm_output, config_path);
+	#endif
+	
 	// win32
 	#ifdef _WIN32
 		MyWritePrivateProfileBool(_T("Win32"), _T("UseTelnet"), config.use_telnet, config_path);
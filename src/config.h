@@ -178,6 +178,10 @@ typedef struct {
 	int sound_frequency;
 	int sound_latency;
 	bool sound_strict_rendering;
+	bool sound_parallel_mixing;
+	bool sound_native_rate;
+	bool sound_audio_thread;
+	int sound_record_registers;
 	#if defined(USE_SHARED_DLL) || defined(USE_FLOPPY_DISK)
 		bool sound_noise_fdd;
 	#endif
@@ -213,6 +217,7 @@ typedef struct {
 	// printer
 	#if defined(USE_SHARED_DLL) || defined(USE_PRINTER)
 		_TCHAR printer_dll_path[_MAX_PATH];
+		bool printer_pnm_output;
 	#endif
 	
 	// debug
@@ -15,8 +15,12 @@
 #include "vm/debugger.h"
 #endif
 #include "vm/vm.h"
+#if defined(USE_HARD_DISK)
+#include "vm/harddisk.h"
+#endif
 #include "fifo.h"
 #include "fileio.h"
+#include "vm/vgm_logger.h"
 
 // ----------------------------------------------------------------------------
 // initialize
@@ -48,6 +52,7 @@ EMU::EMU()
 	initialize_debug_log();
 #endif
 	message_count = 0;
+	vgm_logger = NULL;
 	
 #ifdef USE_FLOPPY_DISK
 	// initialize d88 file info
@@ -142,6 +147,11 @@ EMU::~EMU()
 #ifdef USE_DEBUGGER
 	release_debugger();
 #endif
+	osd->finish_render_lines();
+	if(vgm_logger != NULL) {
+		delete vgm_logger;
+		vgm_logger = NULL;
+	}
 	delete vm;
 	osd->release();
 	delete osd;
@@ -250,6 +260,16 @@ int EMU::run()
 #endif
 #endif
 	update_media();
+#ifdef USE_STATE
+	switch(osd->check_save_state()) {
+	case SAVE_STATE_SUCCESS:
+		out_message(_T("Saved State"));
+		break;
+	case SAVE_STATE_ERROR:
+		out_message(_T("Failed to Save State"));
+		break;
+	}
+#endif
 	
 	// virtual machine may be driven to fill sound buffer
 	int extra_frames = 0;
@@ -300,6 +320,7 @@ void EMU::reset()
 		osd->stop_sound();
 		// reinitialize virtual machine
 		osd->lock_vm();
+		osd->finish_render_lines();
 		delete vm;
 		osd->vm = vm = new VM(this);
 #if defined(_USE_QT)
@@ -1515,6 +1536,21 @@ scrntype_t* EMU::get_screen_buffer(int y)
 	return osd->get_vm_screen_buffer(y);
 }
 
+void EMU::start_render_lines(DEVICE* device, int lines)
+{
+	osd->start_render_lines(device, lines);
+}
+
+void EMU::finish_render_lines()
+{
+	osd->finish_render_lines();
+}
+
+void EMU::run_mix_sound(DEVICE** devices, int32_t** buffers, int count, int* samples)
+{
+	osd->run_mix_sound(devices, buffers, count, samples);
+}
+
 #ifdef USE_SCREEN_FILTER
 void EMU::screen_skip_line(bool skip_line)
 {
@@ -1592,11 +1628,27 @@ void EMU::mute_sound()
 void EMU::start_record_sound()
 {
 	osd->start_record_sound();
+	
+	// log registers of sound chips
+	if(vgm_logger == NULL && (config.sound_record_registers == VGM_FORMAT_VGM || config.sound_record_registers == VGM_FORMAT_S98)) {
+		_TCHAR file_path[_MAX_PATH];
+		create_date_file_path(file_path, _MAX_PATH, (config.sound_record_registers == VGM_FORMAT_VGM) ? _T("vgm") : _T("s98"));
+		vgm_logger = new VGM_LOGGER();
+		if(!vgm_logger->open(file_path, config.sound_record_registers)) {
+			delete vgm_logger;
+			vgm_logger = NULL;
+		}
+	}
 }
 
 void EMU::stop_record_sound()
 {
 	osd->stop_record_sound();
+	
+	if(vgm_logger != NULL) {
+		delete vgm_logger;
+		vgm_logger = NULL;
+	}
 }
 
 bool EMU::is_sound_recording()
@@ -1604,6 +1656,16 @@ bool EMU::is_sound_recording()
 	return osd->now_record_sound;
 }
 
+int EMU::get_sound_underrun_count()
+{
+	return osd->get_sound_underrun_count();
+}
+
+int EMU::get_sound_overrun_count()
+{
+	return osd->get_sound_overrun_count();
+}
+
 // ----------------------------------------------------------------------------
 // video
 // ----------------------------------------------------------------------------
@@ -2574,6 +2636,65 @@ bool EMU::create_blank_hard_disk(const _TCHAR* file_path, int sector_size, int s
 	return false;
 }
 
+bool EMU::create_hard_disk_overlay(const _TCHAR* file_path, const _TCHAR* base_file_path)
+{
+	if(check_file_extension(file_path, _T(".hdo"))) {
+		// copy-on-write overlay on the read only base image
+		return HARDDISK::create_overlay(file_path, base_file_path);
+	}
+	// unknown extension
+	return false;
+}
+
+bool EMU::is_hard_disk_overlay(int drv)
+{
+	if(drv < USE_HARD_DISK) {
+		return vm->is_hard_disk_inserted(drv) && check_file_extension(hard_disk_status[drv].path, _T(".hdo"));
+	}
+	return false;
+}
+
+bool EMU::commit_hard_disk_overlay(int drv)
+{
+	bool result = false;
+	
+	if(is_hard_disk_overlay(drv)) {
+		// the overlay is unmounted while its blocks are written back to the base image
+		vm->close_hard_disk(drv);
+		HARDDISK *disk = new HARDDISK(this);
+		disk->open(hard_disk_status[drv].path, 512);
+		result = disk->commit();
+		delete disk;
+		vm->open_hard_disk(drv, hard_disk_status[drv].path);
+#if USE_HARD_DISK > 1
+		out_message(result ? _T("HD%d: Overlay Committed") : _T("HD%d: Failed to Commit Overlay"), drv + BASE_HARD_DISK_NUM);
+#else
+		out_message(result ? _T("HD: Overlay Committed") : _T("HD: Failed to Commit Overlay"));
+#endif
+	}
+	return result;
+}
+
+bool EMU::discard_hard_disk_overlay(int drv)
+{
+	bool result = false;
+	
+	if(is_hard_disk_overlay(drv)) {
+		vm->close_hard_disk(drv);
+		HARDDISK *disk = new HARDDISK(this);
+		disk->open(hard_disk_status[drv].path, 512);
+		result = disk->discard();
+		delete disk;
+		vm->open_hard_disk(drv, hard_disk_status[drv].path);
+#if USE_HARD_DISK > 1
+		out_message(result ? _T("HD%d: Overlay Discarded") : _T("HD%d: Failed to Discard Overlay"), drv + BASE_HARD_DISK_NUM);
+#else
+		out_message(result ? _T("HD: Overlay Discarded") : _T("HD: Failed to Discard Overlay"));
+#endif
+	}
+	return result;
+}
+
 void EMU::open_hard_disk(int drv, const _TCHAR* file_path)
 {
 	if(drv < USE_HARD_DISK) {
@@ -3024,185 +3145,217 @@ void EMU::free_sound_file(int id, int16_t **data)
 
 void EMU::save_state(const _TCHAR* file_path)
 {
+	// serialize into memory here, and compress/write it in the background
 	FILEIO* fio = new FILEIO();
-	osd->lock_vm();
-#ifdef USE_ZLIB
-	if(config.compress_state) {
-		fio->Gzopen(file_path, FILEIO_WRITE_BINARY);
+	if(fio->Memopen(FILEIO_WRITE_BINARY)) {
+		osd->lock_vm();
+		save_state_fio(fio);
+		osd->unlock_vm();
+		size_t size = 0;
+		uint8_t* buffer = fio->Memdetach(&size);
+		osd->start_save_state(file_path, buffer, size, config.compress_state);
 	}
+	delete fio;
+}
+
+void EMU::load_state(const _TCHAR* file_path)
+{
+	// the state file may be still written in the background
+	osd->wait_save_state();
+	
+	if(FILEIO::IsFileExisting(file_path)) {
+#ifdef USE_AUTO_KEY
+		stop_auto_key();
+		config.romaji_to_kana = false;
 #endif
-	if(!fio->IsOpened()) {
-		fio->Fopen(file_path, FILEIO_WRITE_BINARY);
+		
+		// keep the current state in memory to restore it when the state file is broken
+		FILEIO* fio = new FILEIO();
+		if(fio->Memopen(FILEIO_WRITE_BINARY)) {
+			osd->lock_vm();
+			save_state_fio(fio);
+			osd->unlock_vm();
+			size_t size = 0;
+			uint8_t* buffer = fio->Memdetach(&size);
+			fio->Memopen(buffer, size, FILEIO_READ_BINARY);
+		}
+		if(!load_state_tmp(file_path)) {
+			out_debug_log(_T("failed to load state file\n"));
+			if(fio->IsOpened()) {
+				osd->lock_vm();
+				load_state_fio(fio);
+				osd->unlock_vm();
+			}
+		}
+		delete fio;
 	}
-	if(fio->IsOpened()) {
-		// save state file version
-		fio->FputUint32(STATE_VERSION);
-		// save config
-		process_config_state((void *)fio, false);
-		// save inserted medias
+}
+
+void EMU::save_state_fio(FILEIO* fio)
+{
+	// save state file version
+	fio->FputUint32(STATE_VERSION);
+	// save config
+	process_config_state((void *)fio, false);
+	// save inserted medias
 #ifdef USE_CART
-		fio->Fwrite(&cart_status, sizeof(cart_status), 1);
+	fio->Fwrite(&cart_status, sizeof(cart_status), 1);
 #endif
 #ifdef USE_FLOPPY_DISK
-		fio->Fwrite(floppy_disk_status, sizeof(floppy_disk_status), 1);
-		fio->Fwrite(d88_file, sizeof(d88_file), 1);
+	fio->Fwrite(floppy_disk_status, sizeof(floppy_disk_status), 1);
+	fio->Fwrite(d88_file, sizeof(d88_file), 1);
 #endif
 #ifdef USE_QUICK_DISK
-		fio->Fwrite(&quick_disk_status, sizeof(quick_disk_status), 1);
+	fio->Fwrite(&quick_disk_status, sizeof(quick_disk_status), 1);
 #endif
 #ifdef USE_HARD_DISK
-		fio->Fwrite(&hard_disk_status, sizeof(hard_disk_status), 1);
+	fio->Fwrite(&hard_disk_status, sizeof(hard_disk_status), 1);
 #endif
 #ifdef USE_TAPE
-		fio->Fwrite(&tape_status, sizeof(tape_status), 1);
+	fio->Fwrite(&tape_status, sizeof(tape_status), 1);
 #endif
 #ifdef USE_COMPACT_DISC
-		fio->Fwrite(&compact_disc_status, sizeof(compact_disc_status), 1);
+	fio->Fwrite(&compact_disc_status, sizeof(compact_disc_status), 1);
 #endif
 #ifdef USE_LASER_DISC
-		fio->Fwrite(&laser_disc_status, sizeof(laser_disc_status), 1);
+	fio->Fwrite(&laser_disc_status, sizeof(laser_disc_status), 1);
 #endif
 #ifdef USE_BUBBLE
-		fio->Fwrite(&bubble_casette_status, sizeof(bubble_casette_status), 1);
+	fio->Fwrite(&bubble_casette_status, sizeof(bubble_casette_status), 1);
 #endif
-		// save vm state
-		vm->process_state(fio, false);
-		// end of state file
-		fio->FputInt32_LE(-1);
-		fio->Fclose();
-	}
-	osd->unlock_vm();
-	delete fio;
+	// save vm state
+	vm->process_state(fio, false);
+	// end of state file
+	fio->FputInt32_LE(-1);
 }
 
-void EMU::load_state(const _TCHAR* file_path)
-{
-	if(FILEIO::IsFileExisting(file_path)) {
-#ifdef USE_AUTO_KEY
-		stop_auto_key();
-		config.romaji_to_kana = false;
-#endif
-		
-		save_state(create_local_path(_T("$temp$.sta")));
-		if(!load_state_tmp(file_path)) {
-			out_debug_log(_T("failed to load state file\n"));
-			load_state_tmp(create_local_path(_T("$temp$.sta")));
-		}
-		FILEIO::RemoveFile(create_local_path(_T("$temp$.sta")));
-	}
-}
-
-bool EMU::load_state_tmp(const _TCHAR* file_path)
+bool EMU::load_state_fio(FILEIO* fio)
 {
 	bool result = false;
-	FILEIO* fio = new FILEIO();
-	osd->lock_vm();
-#ifdef USE_ZLIB
-//	if(config.compress_state) {
-		fio->Gzopen(file_path, FILEIO_READ_BINARY);
-//	}
-#endif
-	if(!fio->IsOpened()) {
-		fio->Fopen(file_path, FILEIO_READ_BINARY);
-	}
-	if(fio->IsOpened()) {
-		// check state file version
-		if(fio->FgetUint32() == STATE_VERSION) {
-			// load config
-			if(process_config_state((void *)fio, true)) {
-				// load inserted medias
+	
+	// check state file version
+	if(fio->FgetUint32() == STATE_VERSION) {
+		// load config
+		if(process_config_state((void *)fio, true)) {
+			// load inserted medias
 #ifdef USE_CART
-				fio->Fread(&cart_status, sizeof(cart_status), 1);
+			fio->Fread(&cart_status, sizeof(cart_status), 1);
 #endif
 #ifdef USE_FLOPPY_DISK
-				fio->Fread(floppy_disk_status, sizeof(floppy_disk_status), 1);
-				fio->Fread(d88_file, sizeof(d88_file), 1);
+			fio->Fread(floppy_disk_status, sizeof(floppy_disk_status), 1);
+			fio->Fread(d88_file, sizeof(d88_file), 1);
 #endif
 #ifdef USE_QUICK_DISK
-				fio->Fread(&quick_disk_status, sizeof(quick_disk_status), 1);
+			fio->Fread(&quick_disk_status, sizeof(quick_disk_status), 1);
 #endif
 #ifdef USE_HARD_DISK
-				fio->Fread(&hard_disk_status, sizeof(hard_disk_status), 1);
+			fio->Fread(&hard_disk_status, sizeof(hard_disk_status), 1);
 #endif
 #ifdef USE_TAPE
-				fio->Fread(&tape_status, sizeof(tape_status), 1);
+			fio->Fread(&tape_status, sizeof(tape_status), 1);
 #endif
 #ifdef USE_COMPACT_DISC
-				fio->Fread(&compact_disc_status, sizeof(compact_disc_status), 1);
+			fio->Fread(&compact_disc_status, sizeof(compact_disc_status), 1);
 #endif
 #ifdef USE_LASER_DISC
-				fio->Fread(&laser_disc_status, sizeof(laser_disc_status), 1);
+			fio->Fread(&laser_disc_status, sizeof(laser_disc_status), 1);
 #endif
 #ifdef USE_BUBBLE
-				fio->Fread(&bubble_casette_status, sizeof(bubble_casette_status), 1);
+			fio->Fread(&bubble_casette_status, sizeof(bubble_casette_status), 1);
 #endif
-				// check if virtual machine should be reinitialized
-				bool reinitialize = false;
+			// check if virtual machine should be reinitialized
+			bool reinitialize = false;
 #ifdef USE_CPU_TYPE
-				reinitialize |= (cpu_type != config.cpu_type);
-				cpu_type = config.cpu_type;
+			reinitialize |= (cpu_type != config.cpu_type);
+			cpu_type = config.cpu_type;
 #endif
 #ifdef USE_DIPSWITCH
-				reinitialize |= (dipswitch != config.dipswitch);
-				dipswitch = config.dipswitch;
+			reinitialize |= (dipswitch != config.dipswitch);
+			dipswitch = config.dipswitch;
 #endif
 #ifdef USE_SOUND_TYPE
-				reinitialize |= (sound_type != config.sound_type);
-				sound_type = config.sound_type;
+			reinitialize |= (sound_type != config.sound_type);
+			sound_type = config.sound_type;
 #endif
 #ifdef USE_PRINTER_TYPE
-				reinitialize |= (printer_type != config.printer_type);
-				printer_type = config.printer_type;
+			reinitialize |= (printer_type != config.printer_type);
+			printer_type = config.printer_type;
 #endif
 #ifdef USE_SERIAL_TYPE
-				reinitialize |= (serial_type != config.serial_type);
-				serial_type = config.serial_type;
+			reinitialize |= (serial_type != config.serial_type);
+			serial_type = config.serial_type;
 #endif
-				if(!(0 <= config.sound_frequency && config.sound_frequency < 8)) {
-					config.sound_frequency = 6;	// default: 48KHz
-				}
-				if(!(0 <= config.sound_latency && config.sound_latency < 5)) {
-					config.sound_latency = 1;	// default: 100msec
-				}
-				reinitialize |= (sound_frequency != config.sound_frequency);
-				reinitialize |= (sound_latency != config.sound_latency);
-				sound_frequency = config.sound_frequency;
-				sound_latency = config.sound_latency;
-				
-				if(reinitialize) {
-					// stop sound
-					osd->stop_sound();
-					// reinitialize virtual machine
-//					osd->lock_vm();
-					delete vm;
-					osd->vm = vm = new VM(this);
+			if(!(0 <= config.sound_frequency && config.sound_frequency < 8)) {
+				config.sound_frequency = 6;	// default: 48KHz
+			}
+			if(!(0 <= config.sound_latency && config.sound_latency < 5)) {
+				config.sound_latency = 1;	// default: 100msec
+			}
+			reinitialize |= (sound_frequency != config.sound_frequency);
+			reinitialize |= (sound_latency != config.sound_latency);
+			sound_frequency = config.sound_frequency;
+			sound_latency = config.sound_latency;
+			
+			if(reinitialize) {
+				// stop sound
+				osd->stop_sound();
+				// reinitialize virtual machine
+//				osd->lock_vm();
+				osd->finish_render_lines();
+				delete vm;
+				osd->vm = vm = new VM(this);
 #if defined(_USE_QT)
-					osd->reset_vm_node();
+				osd->reset_vm_node();
 #endif
-					sound_rate = sound_frequency_table[config.sound_frequency];
-					sound_samples = (int)(sound_rate * sound_latency_table[config.sound_latency] + 0.5);
-					vm->initialize_sound(sound_rate, sound_samples);
+				sound_rate = sound_frequency_table[config.sound_frequency];
+				sound_samples = (int)(sound_rate * sound_latency_table[config.sound_latency] + 0.5);
+				vm->initialize_sound(sound_rate, sound_samples);
 #ifdef USE_SOUND_VOLUME
-					for(int i = 0; i < USE_SOUND_VOLUME; i++) {
-						vm->set_sound_device_volume(i, config.sound_volume_l[i], config.sound_volume_r[i]);
-					}
-#endif
-					restore_media();
-					vm->reset();
-//					osd->unlock_vm();
-				} else {
-					restore_media();
-				}
-				// load vm state
-				if(vm->process_state(fio, true)) {
-					// check end of state
-					result = (fio->FgetInt32_LE() == -1);
+				for(int i = 0; i < USE_SOUND_VOLUME; i++) {
+					vm->set_sound_device_volume(i, config.sound_volume_l[i], config.sound_volume_r[i]);
 				}
+#endif
+				restore_media();
+				vm->reset();
+//				osd->unlock_vm();
+			} else {
+				restore_media();
+			}
+			// load vm state
+			if(vm->process_state(fio, true)) {
+				// check end of state
+				result = (fio->FgetInt32_LE() == -1);
 			}
 		}
+	}
+	return result;
+}
+
+bool EMU::load_state_tmp(const _TCHAR* file_path)
+{
+	bool result = false;
+	FILEIO* fio = new FILEIO();
+	uint8_t* buffer = NULL;
+	size_t size = 0;
+	
+	// chunked state file is decompressed in parallel
+	if(osd->load_state_image(file_path, &buffer, &size)) {
+		fio->Memopen(buffer, size, FILEIO_READ_BINARY);
+	}
+#ifdef USE_ZLIB
+	if(!fio->IsOpened()) {
+		fio->Gzopen(file_path, FILEIO_READ_BINARY);
+	}
+#endif
+	if(!fio->IsOpened()) {
+		fio->Fopen(file_path, FILEIO_READ_BINARY);
+	}
+	if(fio->IsOpened()) {
+		osd->lock_vm();
+		result = load_state_fio(fio);
+		osd->unlock_vm();
 		fio->Fclose();
 	}
-	osd->unlock_vm();
 	delete fio;
 	return result;
 }
@@ -61,8 +61,10 @@
 
 class EMU;
 class OSD;
+class DEVICE;
 class FIFO;
 class FILEIO;
+class VGM_LOGGER;
 
 #ifdef USE_DEBUGGER
 #if defined(OSD_QT)
@@ -109,6 +111,7 @@ private:
 	// misc
 	int sound_frequency, sound_latency;
 	int sound_rate, sound_samples;
+	VGM_LOGGER* vgm_logger;
 #ifdef USE_CPU_TYPE
 	int cpu_type;
 #endif
@@ -187,6 +190,8 @@ private:
 	
 	// state
 #ifdef USE_STATE
+	void save_state_fio(FILEIO* fio);
+	bool load_state_fio(FILEIO* fio);
 	bool load_state_tmp(const _TCHAR* file_path);
 #endif
 	
@@ -291,6 +296,9 @@ public:
 #endif
 	int draw_screen();
 	scrntype_t* get_screen_buffer(int y);
+	void start_render_lines(DEVICE* device, int lines);
+	void finish_render_lines();
+	void run_mix_sound(DEVICE** devices, int32_t** buffers, int count, int* samples);
 #ifdef USE_SCREEN_FILTER
 	void screen_skip_line(bool skip_line);
 #endif
@@ -316,6 +324,13 @@ public:
 	void start_record_sound();
 	void stop_record_sound();
 	bool is_sound_recording();
+	int get_sound_underrun_count();
+	int get_sound_overrun_count();
+	// logger of sound chip registers while recording sound, NULL if not logging
+	VGM_LOGGER* get_vgm_logger()
+	{
+		return vgm_logger;
+	}
 	
 	// video device
 #if defined(USE_MOVIE_PLAYER) || defined(USE_VIDEO_CAPTURE)
@@ -453,6 +468,10 @@ public:
 #endif
 #ifdef USE_HARD_DISK
 	bool create_blank_hard_disk(const _TCHAR* file_path, int sector_size, int sectors, int surfaces, int cylinders);
+	bool create_hard_disk_overlay(const _TCHAR* file_path, const _TCHAR* base_file_path);
+	bool is_hard_disk_overlay(int drv);
+	bool commit_hard_disk_overlay(int drv);
+	bool discard_hard_disk_overlay(int drv);
 	void open_hard_disk(int drv, const _TCHAR* file_path);
 	void close_hard_disk(int drv);
 	bool is_hard_disk_inserted(int drv);
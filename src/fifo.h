@@ -11,6 +11,7 @@
 #define _FIFO_H_
 
 #include "common.h"
+#include "fileio.h"
 
 class DLL_PREFIX FIFO
 {
@@ -32,5 +33,154 @@ public:
 	bool process_state(void *f, bool loading);
 };
 
+// ring buffer with power-of-two size and element type selection
+// state data is compatible with FIFO
+
+template <class T>
+class RING_BUFFER
+{
+private:
+	int size, mask;
+	T* buf;
+	int cnt, rpt, wpt;
+public:
+	RING_BUFFER(int s)
+	{
+		size = s;
+		for(mask = 1; mask < size; mask <<= 1);
+		buf = (T*)malloc(mask * sizeof(T));
+		mask--;
+		cnt = rpt = wpt = 0;
+	}
+	void release()
+	{
+		free(buf);
+	}
+	void clear()
+	{
+		cnt = rpt = wpt = 0;
+	}
+	void write(T val)
+	{
+		if(cnt < size) {
+			buf[wpt] = val;
+			wpt = (wpt + 1) & mask;
+			cnt++;
+		}
+	}
+	T read()
+	{
+		T val = 0;
+		if(cnt) {
+			val = buf[rpt];
+			rpt = (rpt + 1) & mask;
+			cnt--;
+		}
+		return val;
+	}
+	T read_not_remove(int pt)
+	{
+		if(pt >= 0 && pt < cnt) {
+			return buf[(rpt + pt) & mask];
+		}
+		return 0;
+	}
+	int write_block(const T* src, int length)
+	{
+		// returns the number of written elements
+		if(length > size - cnt) {
+			length = size - cnt;
+		}
+		int length1 = min(length, mask + 1 - wpt);
+		memcpy(buf + wpt, src, length1 * sizeof(T));
+		memcpy(buf, src + length1, (length - length1) * sizeof(T));
+		wpt = (wpt + length) & mask;
+		cnt += length;
+		return length;
+	}
+	int read_block(T* dst, int length)
+	{
+		// returns the number of read elements
+		if(length > cnt) {
+			length = cnt;
+		}
+		int length1 = min(length, mask + 1 - rpt);
+		memcpy(dst, buf + rpt, length1 * sizeof(T));
+		memcpy(dst + length1, buf, (length - length1) * sizeof(T));
+		rpt = (rpt + length) & mask;
+		cnt -= length;
+		return length;
+	}
+	T* peek_span(int *length)
+	{
+		// returns the contiguous elements from the read pointer without removing them,
+		// length is limited to the number of them
+		int length1 = min(cnt, mask + 1 - rpt);
+		if(*length > length1) {
+			*length = length1;
+		}
+		return buf + rpt;
+	}
+	void remove(int length)
+	{
+		if(length > cnt) {
+			length = cnt;
+		}
+		rpt = (rpt + length) & mask;
+		cnt -= length;
+	}
+	int count()
+	{
+		return cnt;
+	}
+	bool full()
+	{
+		return (cnt == size);
+	}
+	bool empty()
+	{
+		return (cnt == 0);
+	}
+	bool process_state(void *f, bool loading)
+	{
+		FILEIO *state_fio = (FILEIO *)f;
+		int tmp_size = size, tmp_cnt = cnt, tmp_rpt = 0, tmp_wpt = cnt % size;
+		bool result = false;
+		
+		// same as FIFO::process_state, elements are stored as int from the read pointer
+		if(!state_fio->StateCheckUint32(1)) {
+			return false;
+		}
+		state_fio->StateValue(tmp_size);
+		if(tmp_size != size) {
+			return false;
+		}
+		int *tmp_buf = (int *)calloc(size, sizeof(int));
+		if(!loading) {
+			for(int i = 0; i < cnt; i++) {
+				tmp_buf[i] = buf[(rpt + i) & mask];
+			}
+		}
+		state_fio->StateArray(tmp_buf, size * sizeof(int), 1);
+		state_fio->StateValue(tmp_cnt);
+		state_fio->StateValue(tmp_rpt);
+		state_fio->StateValue(tmp_wpt);
+		
+		if(!loading) {
+			result = true;
+		} else if(tmp_cnt >= 0 && tmp_cnt <= size && tmp_rpt >= 0 && tmp_rpt < size) {
+			for(int i = 0; i < tmp_cnt; i++) {
+				buf[i] = (T)tmp_buf[(tmp_rpt + i) % size];
+			}
+			cnt = tmp_cnt;
+			rpt = 0;
+			wpt = cnt & mask;
+			result = true;
+		}
+		free(tmp_buf);
+		return result;
+	}
+};
+
 #endif
 
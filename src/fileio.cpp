@@ -73,6 +73,8 @@ FILEIO::FILEIO()
 	gz = NULL;
 #endif
 	fp = NULL;
+	mem = NULL;
+	mem_size = mem_pos = mem_alloc = 0;
 	path[0] = _T('\0');
 }
 
@@ -255,6 +257,66 @@ bool FILEIO::Gzopen(const _TCHAR *file_path, int mode)
 }
 #endif
 
+bool FILEIO::Memopen(int mode)
+{
+	Fclose();
+	
+	switch(mode) {
+	case FILEIO_WRITE_BINARY:
+	case FILEIO_READ_WRITE_NEW_BINARY:
+		open_mode = mode;
+		return mem_reserve(0x100000);
+	}
+	return false;
+}
+
+bool FILEIO::Memopen(uint8_t *buffer, size_t size, int mode)
+{
+	Fclose();
+	
+	if(buffer == NULL) {
+		return false;
+	}
+	switch(mode) {
+	case FILEIO_READ_BINARY:
+	case FILEIO_READ_WRITE_BINARY:
+		open_mode = mode;
+		mem = buffer;
+		mem_size = mem_alloc = size;
+		return true;
+	}
+	return false;
+}
+
+uint8_t *FILEIO::Memdetach(size_t *size)
+{
+	uint8_t *buffer = mem;
+	
+	if(size != NULL) {
+		*size = mem_size;
+	}
+	mem = NULL;
+	mem_size = mem_pos = mem_alloc = 0;
+	return buffer;
+}
+
+bool FILEIO::mem_reserve(size_t size)
+{
+	if(size > mem_alloc) {
+		size_t new_alloc = (mem_alloc != 0) ? mem_alloc : 0x1000;
+		while(new_alloc < size) {
+			new_alloc <<= 1;
+		}
+		uint8_t *new_mem = (uint8_t *)realloc(mem, new_alloc);
+		if(new_mem == NULL) {
+			return false;
+		}
+		mem = new_mem;
+		mem_alloc = new_alloc;
+	}
+	return true;
+}
+
 void FILEIO::Fclose()
 {
 #ifdef USE_ZLIB
@@ -267,6 +329,11 @@ void FILEIO::Fclose()
 		fclose(fp);
 		fp = NULL;
 	}
+	if(mem != NULL) {
+		free(mem);
+		mem = NULL;
+	}
+	mem_size = mem_pos = mem_alloc = 0;
 	path[0] = _T('\0');
 }
 
@@ -836,6 +903,9 @@ int FILEIO::Fgetc()
 		return gzgetc(gz);
 	} else
 #endif
+	if(mem != NULL) {
+		return (mem_pos < mem_size) ? mem[mem_pos++] : EOF;
+	}
 	if(fp != NULL) {
 		return fgetc(fp);
 	}
@@ -849,6 +919,10 @@ int FILEIO::Fputc(int c)
 		return gzputc(gz, c);
 	} else
 #endif
+	if(mem != NULL) {
+		uint8_t data = (uint8_t)c;
+		return (Fwrite(&data, 1, 1) == 1) ? data : EOF;
+	}
 	if(fp != NULL) {
 		return fputc(c, fp);
 	}
@@ -862,6 +936,19 @@ char *FILEIO::Fgets(char *str, int n)
 		return gzgets(gz, str, n);
 	} else
 #endif
+	if(mem != NULL) {
+		if(n <= 0 || mem_pos >= mem_size) {
+			return NULL;
+		}
+		int i = 0;
+		while(i < n - 1 && mem_pos < mem_size) {
+			if((str[i++] = (char)mem[mem_pos++]) == '\n') {
+				break;
+			}
+		}
+		str[i] = '\0';
+		return str;
+	}
 	if(fp != NULL) {
 		return fgets(str, n, fp);
 	}
@@ -883,6 +970,17 @@ _TCHAR *FILEIO::Fgetts(_TCHAR *str, int n)
 #endif
 	} else
 #endif
+	if(mem != NULL) {
+#if defined(_UNICODE) && defined(SUPPORT_TCHAR_TYPE)
+		char *str_mb = (char *)calloc(sizeof(char), n + 1);
+		char *result = Fgets(str_mb, n);
+		my_swprintf_s(str, n, L"%s", char_to_wchar(str_mb));
+		free(str_mb);
+		return (result != NULL) ? str : NULL;
+#else
+		return Fgets(str, n);
+#endif
+	}
 	if(fp != NULL) {
 		return _fgetts(str, n, fp);
 	}
@@ -903,6 +1001,9 @@ int FILEIO::Fprintf(const char* format, ...)
 		return gzprintf(gz, "%s", buffer);
 	} else
 #endif
+	if(mem != NULL) {
+		return (int)Fwrite(buffer, 1, strlen(buffer));
+	}
 	if(fp != NULL) {
 		return my_fprintf_s(fp, "%s", buffer);
 	}
@@ -923,6 +1024,10 @@ int FILEIO::Ftprintf(const _TCHAR* format, ...)
 		return gzprintf(gz, "%s", tchar_to_char(buffer));
 	} else
 #endif
+	if(mem != NULL) {
+		const char *str = tchar_to_char(buffer);
+		return (int)Fwrite(str, 1, strlen(str));
+	}
 	if(fp != NULL) {
 		return my_ftprintf_s(fp, _T("%s"), buffer);
 	}
@@ -936,6 +1041,18 @@ size_t FILEIO::Fread(void* buffer, size_t size, size_t count)
 		return gzfread(buffer, size, count, gz);
 	} else
 #endif
+	if(mem != NULL) {
+		if(size == 0 || mem_pos >= mem_size) {
+			return 0;
+		}
+		size_t items = (mem_size - mem_pos) / size;
+		if(items > count) {
+			items = count;
+		}
+		memcpy(buffer, mem + mem_pos, size * items);
+		mem_pos += size * items;
+		return items;
+	}
 	if(fp != NULL) {
 		return fread(buffer, size, count, fp);
 	}
@@ -949,6 +1066,16 @@ size_t FILEIO::Fwrite(const void* buffer, size_t size, size_t count)
 		return gzfwrite(buffer, size, count, gz);
 	} else
 #endif
+	if(mem != NULL) {
+		if(open_mode == FILEIO_READ_BINARY || !mem_reserve(mem_pos + size * count)) {
+			return 0;
+		}
+		memcpy(mem + mem_pos, buffer, size * count);
+		if((mem_pos += size * count) > mem_size) {
+			mem_size = mem_pos;
+		}
+		return count;
+	}
 	if(fp != NULL) {
 		return fwrite(buffer, size, count, fp);
 	}
@@ -969,6 +1096,25 @@ int FILEIO::Fseek(long offset, int origin)
 		}
 	} else
 #endif
+	if(mem != NULL) {
+		long pos = -1;
+		switch(origin) {
+		case FILEIO_SEEK_CUR:
+			pos = (long)mem_pos + offset;
+			break;
+		case FILEIO_SEEK_END:
+			pos = (long)mem_size + offset;
+			break;
+		case FILEIO_SEEK_SET:
+			pos = offset;
+			break;
+		}
+		if(pos < 0 || pos > (long)mem_size) {
+			return -1;
+		}
+		mem_pos = (size_t)pos;
+		return 0;
+	}
 	if(fp != NULL) {
 		switch(origin) {
 		case FILEIO_SEEK_CUR:
@@ -989,6 +1135,9 @@ long FILEIO::Ftell()
 		return gztell(gz);
 	} else
 #endif
+	if(mem != NULL) {
+		return (long)mem_pos;
+	}
 	if(fp != NULL) {
 		return ftell(fp);
 	}
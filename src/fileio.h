@@ -40,9 +40,13 @@ private:
 	long gz_size;
 #endif
 	FILE* fp;
+	uint8_t *mem;
+	size_t mem_size, mem_pos, mem_alloc;
 	_TCHAR path[_MAX_PATH];
 	int open_mode;
 	
+	bool mem_reserve(size_t size);
+	
 public:
 	FILEIO();
 	~FILEIO();
@@ -56,6 +60,10 @@ public:
 #ifdef USE_ZLIB
 	bool Gzopen(const _TCHAR *file_path, int mode);
 #endif
+	// memory stream: the buffer is owned by FILEIO and released by Fclose() unless detached
+	bool Memopen(int mode);
+	bool Memopen(uint8_t *buffer, size_t size, int mode);
+	uint8_t *Memdetach(size_t *size);
 	void Fclose();
 	bool IsOpened()
 	{
@@ -64,6 +72,9 @@ public:
 			return true;
 		} else
 #endif
+		if(mem != NULL) {
+			return true;
+		}
 		return (fp != NULL);
 	}
 	const _TCHAR *FilePath()
@@ -627,7 +627,10 @@
 #define ID_OPEN_BLANK_20MB_1024_HD1     45004
 #define ID_OPEN_BLANK_40MB_HD1          45005
 #define ID_RECENT_HD1                   45006 // 45006-45013
-#define ID_HD1_MENU_END                 45013
+#define ID_OPEN_OVERLAY_HD1             45014
+#define ID_COMMIT_OVERLAY_HD1           45015
+#define ID_DISCARD_OVERLAY_HD1          45016
+#define ID_HD1_MENU_END                 45016
 
 #define ID_HD2_MENU_START               45021
 #define ID_OPEN_HD2                     45021
@@ -636,7 +639,10 @@
 #define ID_OPEN_BLANK_20MB_1024_HD2     45024
 #define ID_OPEN_BLANK_40MB_HD2          45025
 #define ID_RECENT_HD2                   45026 // 45026-45033
-#define ID_HD2_MENU_END                 45033
+#define ID_OPEN_OVERLAY_HD2             45034
+#define ID_COMMIT_OVERLAY_HD2           45035
+#define ID_DISCARD_OVERLAY_HD2          45036
+#define ID_HD2_MENU_END                 45036
 
 #define ID_HD3_MENU_START               45041
 #define ID_OPEN_HD3                     45041
@@ -645,7 +651,10 @@
 #define ID_OPEN_BLANK_20MB_1024_HD3     45044
 #define ID_OPEN_BLANK_40MB_HD3          45045
 #define ID_RECENT_HD3                   45046 // 45046-45053
-#define ID_HD3_MENU_END                 45053
+#define ID_OPEN_OVERLAY_HD3             45054
+#define ID_COMMIT_OVERLAY_HD3           45055
+#define ID_DISCARD_OVERLAY_HD3          45056
+#define ID_HD3_MENU_END                 45056
 
 #define ID_HD4_MENU_START               45061
 #define ID_OPEN_HD4                     45061
@@ -654,7 +663,10 @@
 #define ID_OPEN_BLANK_20MB_1024_HD4     45064
 #define ID_OPEN_BLANK_40MB_HD4          45065
 #define ID_RECENT_HD4                   45066 // 45066-45073
-#define ID_HD4_MENU_END                 45073
+#define ID_OPEN_OVERLAY_HD4             45074
+#define ID_COMMIT_OVERLAY_HD4           45075
+#define ID_DISCARD_OVERLAY_HD4          45076
+#define ID_HD4_MENU_END                 45076
 
 #define ID_HD5_MENU_START               45081
 #define ID_OPEN_HD5                     45081
@@ -663,7 +675,10 @@
 #define ID_OPEN_BLANK_20MB_1024_HD5     45084
 #define ID_OPEN_BLANK_40MB_HD5          45085
 #define ID_RECENT_HD5                   45086 // 45086-45093
-#define ID_HD5_MENU_END                 45093
+#define ID_OPEN_OVERLAY_HD5             45094
+#define ID_COMMIT_OVERLAY_HD5           45095
+#define ID_DISCARD_OVERLAY_HD5          45096
+#define ID_HD5_MENU_END                 45096
 
 #define ID_HD6_MENU_START               45101
 #define ID_OPEN_HD6                     45101
@@ -672,7 +687,10 @@
 #define ID_OPEN_BLANK_20MB_1024_HD6     45104
 #define ID_OPEN_BLANK_40MB_HD6          45105
 #define ID_RECENT_HD6                   45106 // 45106-45113
-#define ID_HD6_MENU_END                 45113
+#define ID_OPEN_OVERLAY_HD6             45114
+#define ID_COMMIT_OVERLAY_HD6           45115
+#define ID_DISCARD_OVERLAY_HD6          45116
+#define ID_HD6_MENU_END                 45116
 
 #define ID_HD7_MENU_START               45121
 #define ID_OPEN_HD7                     45121
@@ -681,7 +699,10 @@
 #define ID_OPEN_BLANK_20MB_1024_HD7     45124
 #define ID_OPEN_BLANK_40MB_HD7          45125
 #define ID_RECENT_HD7                   45126 // 45126-45133
-#define ID_HD7_MENU_END                 45133
+#define ID_OPEN_OVERLAY_HD7             45134
+#define ID_COMMIT_OVERLAY_HD7           45135
+#define ID_DISCARD_OVERLAY_HD7          45136
+#define ID_HD7_MENU_END                 45136
 
 #define ID_HD8_MENU_START               45141
 #define ID_OPEN_HD8                     45141
@@ -690,7 +711,10 @@
 #define ID_OPEN_BLANK_20MB_1024_HD8     45144
 #define ID_OPEN_BLANK_40MB_HD8          45145
 #define ID_RECENT_HD8                   45146 // 45146-45153
-#define ID_HD8_MENU_END                 45153
+#define ID_OPEN_OVERLAY_HD8             45154
+#define ID_COMMIT_OVERLAY_HD8           45155
+#define ID_DISCARD_OVERLAY_HD8          45156
+#define ID_HD8_MENU_END                 45156
 
 // Next default values for new objects
 // 
@@ -0,0 +1,176 @@
+/*
+	Skelton for retropc emulator
+
+	Author : agent
+	Date   : 2026.10.19-
+
+	[ screen scaler and rgb filter ]
+*/
+
+#ifndef _SCALER_H_
+#define _SCALER_H_
+
+#include <string.h>
+#include "common.h"
+
+// source width of rgb filter
+#define SCALER_MAX_WIDTH	2048
+
+typedef struct scaler_image_s {
+	inline scrntype_t* get_line(int y)
+	{
+		return top + pitch * y;
+	}
+	scrntype_t* top;	// line 0
+	int pitch;		// pixels to next line (negative for bottom-up bitmap)
+	int width, height;
+} scaler_image_t;
+
+// integer scaling with nearest neighbour
+// source lines from y_begin to y_end - 1 are processed
+
+static inline void scaler_stretch(scaler_image_t *source, scaler_image_t *dest, int y_begin, int y_end)
+{
+	int pow_x = dest->width / source->width;
+	int pow_y = dest->height / source->height;
+	int width = source->width;
+
+	for(int y = y_begin, yy = y_begin * pow_y; y < y_end; y++, yy += pow_y) {
+		scrntype_t* src = source->get_line(y);
+		scrntype_t* out = dest->get_line(yy);
+
+		if(pow_x == 1) {
+			memcpy(out, src, width * sizeof(scrntype_t));
+		} else if(pow_x == 2) {
+__DECL_VECTORIZED_LOOP
+			for(int x = 0; x < width; x++) {
+				out[x * 2] = out[x * 2 + 1] = src[x];
+			}
+		} else if(pow_x == 3) {
+__DECL_VECTORIZED_LOOP
+			for(int x = 0; x < width; x++) {
+				out[x * 3] = out[x * 3 + 1] = out[x * 3 + 2] = src[x];
+			}
+		} else {
+			for(int x = 0, xx = 0; x < width; x++, xx += pow_x) {
+				scrntype_t c = src[x];
+				for(int px = 0; px < pow_x; px++) {
+					out[xx + px] = c;
+				}
+			}
+		}
+		for(int py = 1; py < pow_y; py++) {
+			memcpy(dest->get_line(yy + py), out, dest->width * sizeof(scrntype_t));
+		}
+	}
+}
+
+// rgb filter (pow_x and pow_y are 1 to 3)
+// if skip_line is true, odd lines of source are skipped and the alpha of even lines marks the scan line,
+// so y_begin should be even
+
+#define SCALER_3_8(v) (((((v) * 3) >> 3) * 180) >> 8)
+#define SCALER_5_8(v) (((((v) * 3) >> 3) * 180) >> 8)
+#define SCALER_8_8(v) (((v) * 180) >> 8)
+
+static inline void scaler_rgb_filter(scaler_image_t *source, scaler_image_t *dest, int pow_x, int pow_y, bool skip_line, int y_begin, int y_end)
+{
+	uint8_t t0[SCALER_MAX_WIDTH + 2];
+	uint16_t r[SCALER_MAX_WIDTH + 2], g[SCALER_MAX_WIDTH + 2], b[SCALER_MAX_WIDTH + 2];
+	int width = (source->width < SCALER_MAX_WIDTH) ? source->width : SCALER_MAX_WIDTH;
+	int step = skip_line ? 2 : 1;
+	int lines = pow_y * step;
+	// last lines are dimmed if the source pixel is not marked
+	int dim_lines = skip_line ? ((pow_y == 3) ? 2 : 1) : ((pow_y == 1) ? 0 : 1);
+
+	for(int y = y_begin, yy = y_begin * pow_y; y < y_end; y += step, yy += lines) {
+		scrntype_t* src = source->get_line(y);
+		scrntype_t* out = dest->get_line(yy);
+		scrntype_t* out_dim = (dim_lines != 0) ? dest->get_line(yy + lines - dim_lines) : NULL;
+
+		// add 1/8 of left and right pixels
+		t0[0] = t0[width + 1] = 0;
+		r[0] = r[width + 1] = 0;
+		g[0] = g[width + 1] = 0;
+		b[0] = b[width + 1] = 0;
+__DECL_VECTORIZED_LOOP
+		for(int x = 1; x <= width; x++) {
+			scrntype_t c = src[x - 1];
+			t0[x] = A_OF_COLOR(c);
+			r[x] = R_OF_COLOR(c);
+			g[x] = G_OF_COLOR(c);
+			b[x] = B_OF_COLOR(c);
+		}
+		uint16_t r1 = 0, g1 = 0, b1 = 0;
+		for(int x = 1; x <= width; x++) {
+			uint16_t r0 = r[x], g0 = g[x], b0 = b[x];
+			r[x] = r1 + r0 + (r[x + 1] >> 3);
+			g[x] = g1 + g0 + (g[x + 1] >> 3);
+			b[x] = b1 + b0 + (b[x + 1] >> 3);
+			r1 = r0 >> 3;
+			g1 = g0 >> 3;
+			b1 = b0 >> 3;
+		}
+
+		// write the first line and the dimmed line
+		if(pow_x == 3) {
+			for(int x = 1, xx = 0; x <= width; x++, xx += 3) {
+				scrntype_t c0 = (32 + SCALER_8_8(r[x])) << 16;
+				scrntype_t c1 = (32 + SCALER_8_8(g[x])) << 8;
+				scrntype_t c2 = (32 + SCALER_8_8(b[x]));
+				out[xx    ] = c0;
+				out[xx + 1] = c1;
+				out[xx + 2] = c2;
+				if(out_dim != NULL) {
+					if(t0[x]) {
+						out_dim[xx    ] = c0;
+						out_dim[xx + 1] = c1;
+						out_dim[xx + 2] = c2;
+					} else {
+						out_dim[xx    ] = (32 + SCALER_5_8(r[x])) << 16;
+						out_dim[xx + 1] = (32 + SCALER_5_8(g[x])) << 8;
+						out_dim[xx + 2] = (32 + SCALER_5_8(b[x]));
+					}
+				}
+			}
+		} else if(pow_x == 2) {
+			for(int x = 1, xx = 0; x <= width; x++, xx += 2) {
+				scrntype_t c0 = RGB_COLOR(32 + SCALER_8_8(r[x]), 32 + SCALER_8_8(g[x]), 32 + SCALER_8_8(b[x]));
+				scrntype_t c1 = RGB_COLOR(16 + SCALER_5_8(r[x]), 16 + SCALER_5_8(g[x]), 16 + SCALER_5_8(b[x]));
+				out[xx    ] = c0;
+				out[xx + 1] = c1;
+				if(out_dim != NULL) {
+					if(t0[x]) {
+						out_dim[xx    ] = c0;
+						out_dim[xx + 1] = c1;
+					} else {
+						out_dim[xx    ] = RGB_COLOR(32 + SCALER_3_8(r[x]), 32 + SCALER_3_8(g[x]), 32 + SCALER_3_8(b[x]));
+						out_dim[xx + 1] = RGB_COLOR(16 + SCALER_3_8(r[x]), 16 + SCALER_3_8(g[x]), 16 + SCALER_3_8(b[x]));
+					}
+				}
+			}
+		} else {
+			for(int x = 1; x <= width; x++) {
+				scrntype_t c0 = RGB_COLOR(32 + SCALER_8_8(r[x]), 32 + SCALER_8_8(g[x]), 32 + SCALER_8_8(b[x]));
+				out[x - 1] = c0;
+				if(out_dim != NULL) {
+					if(t0[x]) {
+						out_dim[x - 1] = c0;
+					} else {
+						out_dim[x - 1] = RGB_COLOR(32 + SCALER_3_8(r[x]), 32 + SCALER_3_8(g[x]), 32 + SCALER_3_8(b[x]));
+					}
+				}
+			}
+		}
+
+		// copy to other lines
+		for(int py = 1; py < lines - dim_lines; py++) {
+			memcpy(dest->get_line(yy + py), out, width * pow_x * sizeof(scrntype_t));
+		}
+		for(int py = lines - dim_lines + 1; py < lines; py++) {
+			memcpy(dest->get_line(yy + py), out_dim, width * pow_x * sizeof(scrntype_t));
+		}
+	}
+}
+
+#endif
@@ -8,6 +8,7 @@
 */
 
 #include "ay_3_891x.h"
+#include "vgm_logger.h"
 #ifdef USE_DEBUGGER
 #include "debugger.h"
 #endif
@@ -222,8 +223,26 @@ void AY_3_891X::initialize_sound(int rate, int clock, int samples, int decibel_f
 	chip_clock = clock;
 }
 
+void AY_3_891X::log_reg(uint32_t addr, uint32_t data)
+{
+	VGM_LOGGER* logger = emu->get_vgm_logger();
+	uint32_t clock = get_current_clock(), clocks_per_sec = get_event_clocks();
+	
+	// chip_clock is twice as the clock of psg in fmgen
+	if(!logger->is_registered(this)) {
+		// log the current registers except i/o ports
+		for(int i = 0; i < 14; i++) {
+			logger->write(VGM_AY8910, this, chip_clock / 2, clock, clocks_per_sec, 0, i, opn->GetReg(i));
+		}
+	}
+	logger->write(VGM_AY8910, this, chip_clock / 2, clock, clocks_per_sec, 0, addr, data);
+}
+
 void AY_3_891X::set_reg(uint32_t addr, uint32_t data)
 {
+	if(addr < 14 && emu->get_vgm_logger() != NULL) {
+		log_reg(addr, data);
+	}
 	touch_sound();
 	opn->SetReg(addr, data);
 }
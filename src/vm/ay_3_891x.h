@@ -76,6 +76,7 @@ private:
 	
 	void update_count();
 	void update_event();
+	void log_reg(uint32_t addr, uint32_t data);
 	
 public:
 	AY_3_891X(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
@@ -112,6 +113,10 @@ public:
 	void event_vline(int v, int clock);
 	void event_callback(int event_id, int error);
 	void mix(int32_t* buffer, int cnt);
+	bool is_mix_thread_safe()
+	{
+		return true;
+	}
 	void set_volume(int ch, int decibel_l, int decibel_r);
 	void update_timing(int new_clocks, double new_frames_per_sec, int new_lines_per_frame);
 	// for debugging
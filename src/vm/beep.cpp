@@ -15,6 +15,8 @@ void BEEP::reset()
 	signal = true;
 	count = 0;
 	on = mute = false;
+	blep.clear();
+	blep_level = 0;
 }
 
 void BEEP::write_signal(int id, uint32_t data, uint32_t mask)
@@ -30,18 +32,42 @@ void BEEP::write_signal(int id, uint32_t data, uint32_t mask)
 
 void BEEP::mix(int32_t* buffer, int cnt)
 {
-	if(on && !mute) {
-		for(int i = 0; i < cnt; i++) {
-			int sample = (count < 1024) ? (gen_vol * (count - 512)) / 512 : gen_vol;
-			int vol_l = apply_volume(sample, volume_l);
-			int vol_r = apply_volume(sample, volume_r);
-			*buffer++ += signal ? vol_l : -vol_l; // L
-			*buffer++ += signal ? vol_r : -vol_r; // R
-			if((count -= 1024) < 0) {
-				count += diff;
-				signal = !signal;
+	if(!(on && !mute) && blep_level == 0 && blep.is_silent()) {
+		return;
+	}
+	while(cnt > 0) {
+		int samples = min(cnt, BLEP_BLOCK);
+		
+		if(on && !mute) {
+			// tone above the nyquist frequency is not output
+			int32_t volume = (diff >= 1024) ? gen_vol : 0;
+			blep.add_delta(0, (signal ? volume : -volume) - blep_level);
+			
+			// count is decreased by 1024 in each sample, and the signal is changed when it becomes negative
+			int total = samples * 1024;
+			if(volume != 0) {
+				while(count < total) {
+					signal = !signal;
+					blep.add_delta((uint32_t)count << (BLEP_TIME_BITS - 10), signal ? 2 * volume : -2 * volume);
+					count += diff;
+				}
+			} else if(count < total) {
+				// skip the edges that are not output
+				int edges = (total - count + diff - 1) / diff;
+				if(edges & 1) {
+					signal = !signal;
+				}
+				count += edges * diff;
 			}
+			count -= total;
+			blep_level = signal ? volume : -volume;
+		} else {
+			blep.add_delta(0, -blep_level);
+			blep_level = 0;
 		}
+		blep.mix(buffer, samples, volume_l, volume_r);
+		buffer += samples * 2;
+		cnt -= samples;
 	}
 }
 
@@ -61,6 +87,10 @@ void BEEP::initialize_sound(int rate, double frequency, int volume)
 void BEEP::set_frequency(double frequency)
 {
 	diff = (int)(1024.0 * gen_rate / frequency / 2.0 + 0.5);
+	if(diff < 1) {
+		// the frequency may be infinite when the divider is 0
+		diff = 1;
+	}
 }
 
 #define STATE_VERSION	1
@@ -77,6 +107,12 @@ bool BEEP::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(count);
 	state_fio->StateValue(on);
 	state_fio->StateValue(mute);
+	
+	// post process
+	if(loading) {
+		blep.clear();
+		blep_level = 0;
+	}
 	return true;
 }
 
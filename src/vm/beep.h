@@ -13,6 +13,7 @@
 #include "vm.h"
 #include "../emu.h"
 #include "device.h"
+#include "blep_buffer.h"
 
 #define SIG_BEEP_ON	0
 #define SIG_BEEP_MUTE	1
@@ -31,10 +32,15 @@ private:
 	bool on;
 	bool mute;
 	
+	// output level in blep buffer
+	BLEP_BUFFER blep;
+	int32_t blep_level;
+	
 public:
 	BEEP(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
 	{
 		volume_l = volume_r = 1024;
+		blep_level = 0;
 		set_device_name(_T("Beep Generator"));
 	}
 	~BEEP() {}
@@ -43,6 +49,10 @@ public:
 	void reset();
 	void write_signal(int id, uint32_t data, uint32_t mask);
 	void mix(int32_t* buffer, int cnt);
+	bool is_mix_thread_safe()
+	{
+		return true;
+	}
 	void set_volume(int ch, int decibel_l, int decibel_r);
 	bool process_state(FILEIO* state_fio, bool loading);
 	
@@ -0,0 +1,102 @@
+/*
+	Skelton for retropc emulator
+
+	Author : agent
+	Date   : 2026.10.19-
+
+	[ band-limited step buffer ]
+*/
+
+#ifndef _BLEP_BUFFER_H_
+#define _BLEP_BUFFER_H_
+
+#include <math.h>
+#include <string.h>
+#include "../common.h"
+
+// square waves are made from the steps of amplitude at sub-sample positions.
+// each step is added to the delta buffer as a band-limited impulse (windowed sinc),
+// and the output is the running sum of the delta buffer.
+// the output is delayed by BLEP_TAPS / 2 samples.
+
+#define BLEP_BLOCK	1024	// max samples rendered at once
+#define BLEP_TAPS	16
+#define BLEP_PHASE_BITS	6
+#define BLEP_PHASES	(1 << BLEP_PHASE_BITS)
+#define BLEP_SHIFT	12
+#define BLEP_TIME_BITS	16	// time is the sample position in 16.16 fixed point
+
+class BLEP_BUFFER
+{
+private:
+	int32_t deltas[BLEP_BLOCK + BLEP_TAPS];
+	int32_t kernel[BLEP_PHASES][BLEP_TAPS];
+	int32_t accum;
+	
+public:
+	BLEP_BUFFER()
+	{
+		const double pi = 3.14159265358979323846;
+		const double cutoff = 0.9;	// 0.45 * sample rate
+		
+		for(int p = 0; p < BLEP_PHASES; p++) {
+			double h[BLEP_TAPS], sum = 0;
+			for(int t = 0; t < BLEP_TAPS; t++) {
+				double x = t - BLEP_TAPS / 2 - (double)p / BLEP_PHASES + 0.5;
+				double s = (x == 0) ? 1.0 : sin(pi * x * cutoff) / (pi * x * cutoff);
+				double w = 0.42 + 0.5 * cos(2.0 * pi * x / BLEP_TAPS) + 0.08 * cos(4.0 * pi * x / BLEP_TAPS);
+				sum += (h[t] = s * w);
+			}
+			// the sum of each phase should be exactly 1.0 not to make dc offset
+			int32_t total = 0, center = BLEP_TAPS / 2;
+			for(int t = 0; t < BLEP_TAPS; t++) {
+				total += (kernel[p][t] = (int32_t)floor(h[t] / sum * (1 << BLEP_SHIFT) + 0.5));
+			}
+			kernel[p][center - (p >= BLEP_PHASES / 2 ? 0 : 1)] += (1 << BLEP_SHIFT) - total;
+		}
+		clear();
+	}
+	void clear()
+	{
+		memset(deltas, 0, sizeof(deltas));
+		accum = 0;
+	}
+	// returns true if no step remains to be output after the last mix()
+	bool is_silent()
+	{
+		if(accum != 0) {
+			return false;
+		}
+		for(int t = 0; t < BLEP_TAPS; t++) {
+			if(deltas[t] != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+	// time should be less than the samples rendered by the next mix()
+	inline void add_delta(uint32_t time, int32_t delta)
+	{
+		if(delta != 0) {
+			int32_t *dest = deltas + (time >> BLEP_TIME_BITS);
+			const int32_t *k = kernel[(time >> (BLEP_TIME_BITS - BLEP_PHASE_BITS)) & (BLEP_PHASES - 1)];
+			for(int t = 0; t < BLEP_TAPS; t++) {
+				dest[t] += k[t] * delta;
+			}
+		}
+	}
+	// adds the samples to the stereo buffer, cnt should not exceed BLEP_BLOCK
+	void mix(int32_t* buffer, int cnt, int volume_l, int volume_r)
+	{
+		for(int i = 0; i < cnt; i++) {
+			accum += deltas[i];
+			int32_t sample = accum >> BLEP_SHIFT;
+			*buffer++ += apply_volume(sample, volume_l); // L
+			*buffer++ += apply_volume(sample, volume_r); // R
+		}
+		memmove(deltas, deltas + cnt, BLEP_TAPS * sizeof(int32_t));
+		memset(deltas + BLEP_TAPS, 0, cnt * sizeof(int32_t));
+	}
+};
+
+#endif
@@ -21,12 +21,15 @@
 #define DATAREC_FAST_REW_SPEED	10
 #endif
 
+#define DATAREC_WAV_CHUNK_SIZE	0x10000
+
 void DATAREC::initialize()
 {
 	play_fio = new FILEIO();
 	rec_fio = new FILEIO();
 	
 	memset(rec_file_path, sizeof(rec_file_path), 1);
+	play_file_path[0] = _T('\0');
 	play = rec = remote = trigger = false;
 	ff_rew = 0;
 	in_signal = out_signal = false;
@@ -41,6 +44,8 @@ void DATAREC::initialize()
 	buffer_ptr = buffer_length = 0;
 	is_wav = is_tap = is_t77 = false;
 	ave_hi_freq = 0;
+	is_wav_stream = false;
+	wav_chunk_info = NULL;
 	
 	pcm_changed = 0;
 	pcm_last_vol_l = pcm_last_vol_r = 0;
@@ -75,8 +80,7 @@ void DATAREC::reset()
 {
 	touch_sound();
 	close_tape();
-	pcm_prev_clock = get_current_clock();
-	pcm_positive_clocks = pcm_negative_clocks = 0;
+	pcm_edges.clear(get_current_clock(), false);
 }
 
 void DATAREC::release()
@@ -92,14 +96,11 @@ void DATAREC::write_signal(int id, uint32_t data, uint32_t mask)
 	
 	if(id == SIG_DATAREC_MIC) {
 		if(out_signal != signal) {
-			touch_sound();
 			if(rec && remote) {
-				if(out_signal) {
-					pcm_positive_clocks += get_passed_clock(pcm_prev_clock);
-				} else {
-					pcm_negative_clocks += get_passed_clock(pcm_prev_clock);
+				if(pcm_edges.is_full()) {
+					touch_sound();
 				}
-				pcm_prev_clock = get_current_clock();
+				pcm_edges.add(get_current_clock(), signal);
 				pcm_changed = 2;
 				signal_changed++;
 			}
@@ -156,13 +157,13 @@ void DATAREC::event_callback(int event_id, int err)
 			if(is_wav) {
 				if(buffer_ptr >= 0 && buffer_ptr < buffer_length) {
 					if(buffer != NULL) {
-						signal = ((buffer[buffer_ptr] & 0x80) != 0);
+						signal = get_play_signal(buffer_ptr);
 					} else {
 						signal = false;
 					}
 #ifdef DATAREC_SOUND
 					if(sound_buffer != NULL && ff_rew == 0) {
-						sound_sample = sound_buffer[buffer_ptr];
+						sound_sample = get_sound_sample(buffer_ptr);
 					} else {
 						sound_sample = 0;
 					}
@@ -212,16 +213,13 @@ void DATAREC::event_callback(int event_id, int err)
 			}
 			// notify the signal is changed
 			if(signal != in_signal) {
-				if(in_signal) {
-					pcm_positive_clocks += get_passed_clock(pcm_prev_clock);
-				} else {
-					pcm_negative_clocks += get_passed_clock(pcm_prev_clock);
+				if(pcm_edges.is_full()) {
+					touch_sound();
 				}
-				pcm_prev_clock = get_current_clock();
+				pcm_edges.add(get_current_clock(), signal);
 				pcm_changed = 2;
 				in_signal = signal;
 				signal_changed++;
-				touch_sound();
 				write_signals(&outputs_ear, in_signal ? 0xffffffff : 0);
 			}
 			// chek apss state
@@ -448,7 +446,12 @@ void DATAREC::update_event()
 
 void DATAREC::update_realtime_render()
 {
-	bool value = (remote && (play || rec) && ff_rew == 0 && (config.sound_tape_signal || config.sound_tape_voice));
+	// the tape signal is logged with the clock, and only the voice needs realtime rendering
+#ifdef DATAREC_SOUND
+	bool value = (remote && play && ff_rew == 0 && config.sound_tape_voice);
+#else
+	bool value = false;
+#endif
 	
 	if(realtime != value) {
 		set_realtime_render(this, value);
@@ -460,6 +463,7 @@ bool DATAREC::play_tape(const _TCHAR* file_path)
 {
 	close_tape();
 	
+	my_tcscpy_s(play_file_path, _MAX_PATH, file_path);
 	if(play_fio->Fopen(file_path, FILEIO_READ_BINARY)) {
 		if(check_file_extension(play_fio->FilePath(), _T(".wav")) || check_file_extension(play_fio->FilePath(), _T(".mti"))) {
 			// standard PCM wave file
@@ -525,7 +529,9 @@ bool DATAREC::play_tape(const _TCHAR* file_path)
 				play = is_wav = true;
 			}
 		}
-		play_fio->Fclose();
+		if(!is_wav_stream) {
+			play_fio->Fclose();
+		}
 	}
 	if(play) {
 		if(!is_wav && buffer_length != 0) {
@@ -534,7 +540,7 @@ bool DATAREC::play_tape(const _TCHAR* file_path)
 		}
 		
 		// get the first signal
-		bool signal = ((buffer[0] & 0x80) != 0);
+		bool signal = get_play_signal(0);
 		if(signal != in_signal) {
 			touch_sound();
 			write_signals(&outputs_ear, signal ? 0xffffffff : 0);
@@ -657,6 +663,11 @@ void DATAREC::close_file()
 		free(apss_buffer);
 		apss_buffer = NULL;
 	}
+	if(wav_chunk_info != NULL) {
+		free(wav_chunk_info);
+		wav_chunk_info = NULL;
+	}
+	is_wav_stream = false;
 }
 
 // standard PCM wave file
@@ -712,7 +723,22 @@ int DATAREC::load_wav_image(int offset)
 	sample_usec = 1000000. / sample_rate;
 	
 	// load samples
-	if(samples > 0) {
+#ifdef DATAREC_SOUND
+	if(!config.wave_shaper[drive_num] || header.channels > 1) {
+#else
+	if(!config.wave_shaper[drive_num]) {
+#endif
+		// samples are decoded by chunk while playing
+		if(samples > 0) {
+			wav_data_offset = (int)play_fio->Ftell();
+			wav_channels = header.channels;
+			wav_sample_bits = header.sample_bits;
+			buffer_length = samples;
+			if(open_wav_stream()) {
+				loaded_samples = samples;
+			}
+		}
+	} else if(samples > 0) {
 		#define TMP_LENGTH (0x10000 * header.channels)
 		
 		uint8_t *tmp_buffer = (uint8_t *)malloc(TMP_LENGTH);
@@ -740,220 +766,328 @@ int DATAREC::load_wav_image(int offset)
 			} \
 		}
 		
-#ifdef DATAREC_SOUND
-		if(!config.wave_shaper[drive_num] || header.channels > 1) {
-#else
-		if(!config.wave_shaper[drive_num]) {
-#endif
-			// load samples
-#ifdef DATAREC_SOUND
-			if(header.channels > 1) {
-				sound_buffer_length = samples * sizeof(int16_t);
-				sound_buffer = (int16_t *)malloc(sound_buffer_length);
-			}
-#endif
-			int16_t *wav_buffer = (int16_t *)malloc(samples * sizeof(int16_t));
-			for(int i = 0, tmp_ptr = 0; i < samples; i++) {
-				int16_t sample[16];
-				GET_SAMPLE
-				int16_t sample_signal = sample[0];
-#ifdef DATAREC_SOUND
-				if(header.channels > 1) {
-#ifdef DATAREC_SOUND_LEFT
-					sample_signal = sample[1];
-					sound_buffer[i] = sample[0];
-#else
-					sound_buffer[i] = sample[1];
-#endif
-				}
-#endif
-				wav_buffer[i] = sample_signal;
-			}
-			adjust_zero_position(wav_buffer, samples, header.sample_rate);
-			
-			// copy to dest buffer
-			buffer = (uint8_t *)malloc(samples);
+		// load samples
+		int16_t *wav_buffer = (int16_t *)malloc(samples * sizeof(int16_t));
+		for(int i = 0, tmp_ptr = 0; i < samples; i++) {
+			int16_t sample[16];
+			GET_SAMPLE
+			wav_buffer[i] = sample[0];
+		}
+		adjust_zero_position(wav_buffer, samples, header.sample_rate);
+		
+		// t=0 : get thresholds
+		// t=1 : get number of samples
+		// t=2 : load samples
+		#define FREQ_SCALE 16
+		int min_threshold = (int)(header.sample_rate * FREQ_SCALE / 2400.0 / 2.0 / 3.0 + 0.5);
+		int max_threshold = (int)(header.sample_rate * FREQ_SCALE / 1200.0 / 2.0 * 3.0 + 0.5);
+		int half_threshold, hi_count, lo_count;
+		int *counts = (int *)calloc(max_threshold, sizeof(int));
+		
+		for(int t = 0; t < 3; t++) {
+			int count_positive = 0, count_negative = 0;
 			bool prev_signal = false;
-			int top_index = 0;
-			int16_t max_sample = 0, min_sample = 0;
 			
-			for(int i = 0, tmp_ptr = 0; i < samples; i++) {
-				int16_t sample_signal = wav_buffer[i];
-				bool signal = (sample_signal > 0);
-				
-				if(!prev_signal && signal) {
-					if(!(min_sample < -2048)) {
-						for(int j = top_index; j < i; j++) {
-							buffer[j] = 0;
+			for(int i = 0; i < samples - 1; i++) {
+				int prev = wav_buffer[i], next = wav_buffer[i + 1];
+				double diff = (double)(next - prev) / FREQ_SCALE;
+				for(int j = 0; j < FREQ_SCALE; j++) {
+					int sample = prev + (int)(diff * j + 0.5);
+					bool signal = (sample > 0);
+					
+					if(!prev_signal && signal) {
+						if(t == 0) {
+							if(count_positive < max_threshold && count_positive > min_threshold && count_negative > min_threshold) {
+								counts[count_positive]++;
+							}
+						} else {
+							int count_p = count_positive / FREQ_SCALE;
+							int count_n = count_negative / FREQ_SCALE;
+							if(count_positive < max_threshold && count_positive > min_threshold && count_negative > min_threshold) {
+								count_p = (count_positive > half_threshold) ? hi_count : lo_count;
+								if(count_negative < max_threshold) {
+									count_n = count_p;
+								}
+							}
+							if(buffer != NULL) {
+								for(int j = 0; j < count_p; j++) buffer[loaded_samples++] = 0xff;
+								for(int j = 0; j < count_n; j++) buffer[loaded_samples++] = 0x00;
+							} else {
+								loaded_samples += count_p + count_n;
+							}
 						}
+						count_positive = count_negative = 0;
 					}
-				} else if(prev_signal && !signal) {
-					if(!(max_sample > 2048)) {
-						for(int j = top_index; j < i; j++) {
-							buffer[j] = 0;
-						}
+					if(signal) {
+						count_positive++;
+					} else {
+						count_negative++;
 					}
+					prev_signal = signal;
 				}
-				if(prev_signal != signal) {
-					top_index = i;
-					max_sample = min_sample = 0;
+			}
+			if(t == 0) {
+				long sum_value = 0, sum_count = 0, half_tmp;
+				for(int i = 0; i < max_threshold; i++) {
+					sum_value += i * counts[i];
+					sum_count += counts[i];
 				}
-				if(signal) {
-					if(max_sample < sample_signal) {
-						max_sample = sample_signal;
-					}
+				// 1920 = 2400 * 0.6 + 1200 * 0.4
+				if(sum_count > 60 * 1920) {
+					half_tmp = (int)((double)sum_value / (double)sum_count + 0.5);
 				} else {
-					if(min_sample > sample_signal) {
-						min_sample = sample_signal;
-					}
+					half_tmp = (int)(header.sample_rate * FREQ_SCALE / 1920.0 / 2.0 + 0.5);
 				}
-				buffer[i] = (signal ? 0xff : 0);
-				prev_signal = signal;
-			}
-			if(!prev_signal) {
-				if(!(min_sample < -2048)) {
-					for(int j = top_index; j < samples; j++) {
-						buffer[j] = 0;
-					}
+				
+				sum_value = sum_count = 0;
+				for(int i = 0; i < half_tmp; i++) {
+					sum_value += i * counts[i];
+					sum_count += counts[i];
 				}
-			} else {
-				if(!(max_sample > 2048)) {
-					for(int j = top_index; j < samples; j++) {
-						buffer[j] = 0;
-					}
+				double lo_tmp = (double)sum_value / (double)sum_count;
+				
+				sum_value = sum_count = 0;
+				for(int i = half_tmp; i < half_tmp * 2; i++) {
+					sum_value += i * counts[i];
+					sum_count += counts[i];
 				}
-			}
-			free(wav_buffer);
-			
-			loaded_samples = samples;
-		} else {
-			// load samples
-			int16_t *wav_buffer = (int16_t *)malloc(samples * sizeof(int16_t));
-			for(int i = 0, tmp_ptr = 0; i < samples; i++) {
-				int16_t sample[16];
-				GET_SAMPLE
-				wav_buffer[i] = sample[0];
-			}
-			adjust_zero_position(wav_buffer, samples, header.sample_rate);
-			
-			// t=0 : get thresholds
-			// t=1 : get number of samples
-			// t=2 : load samples
-			#define FREQ_SCALE 16
-			int min_threshold = (int)(header.sample_rate * FREQ_SCALE / 2400.0 / 2.0 / 3.0 + 0.5);
-			int max_threshold = (int)(header.sample_rate * FREQ_SCALE / 1200.0 / 2.0 * 3.0 + 0.5);
-			int half_threshold, hi_count, lo_count;
-			int *counts = (int *)calloc(max_threshold, sizeof(int));
-			
-			for(int t = 0; t < 3; t++) {
-				int count_positive = 0, count_negative = 0;
-				bool prev_signal = false;
+				double hi_tmp = (double)sum_value / (double)sum_count;
 				
-				for(int i = 0; i < samples - 1; i++) {
-					int prev = wav_buffer[i], next = wav_buffer[i + 1];
-					double diff = (double)(next - prev) / FREQ_SCALE;
-					for(int j = 0; j < FREQ_SCALE; j++) {
-						int sample = prev + (int)(diff * j + 0.5);
-						bool signal = (sample > 0);
-						
-						if(!prev_signal && signal) {
-							if(t == 0) {
-								if(count_positive < max_threshold && count_positive > min_threshold && count_negative > min_threshold) {
-									counts[count_positive]++;
-								}
-							} else {
-								int count_p = count_positive / FREQ_SCALE;
-								int count_n = count_negative / FREQ_SCALE;
-								if(count_positive < max_threshold && count_positive > min_threshold && count_negative > min_threshold) {
-									count_p = (count_positive > half_threshold) ? hi_count : lo_count;
-									if(count_negative < max_threshold) {
-										count_n = count_p;
-									}
-								}
-								if(buffer != NULL) {
-									for(int j = 0; j < count_p; j++) buffer[loaded_samples++] = 0xff;
-									for(int j = 0; j < count_n; j++) buffer[loaded_samples++] = 0x00;
-								} else {
-									loaded_samples += count_p + count_n;
-								}
-							}
-							count_positive = count_negative = 0;
-						}
-						if(signal) {
-							count_positive++;
-						} else {
-							count_negative++;
-						}
-						prev_signal = signal;
+				half_threshold = (int)((lo_tmp + hi_tmp) / 2 + 0.5);
+				min_threshold = (int)(2 * lo_tmp - half_threshold + 0.5);
+				max_threshold = (int)(2 * hi_tmp - half_threshold + 0.5);
+				lo_count = (int)(lo_tmp / FREQ_SCALE + 0.5);
+				hi_count = (int)(hi_tmp / FREQ_SCALE + 0.5);
+			} else {
+				int count_p = count_positive / FREQ_SCALE;
+				int count_n = count_negative / FREQ_SCALE;
+				if(count_positive < max_threshold && count_positive > min_threshold && count_negative > min_threshold) {
+					count_p = (count_positive > half_threshold) ? hi_count : lo_count;
+					if(count_negative < max_threshold) {
+						count_n = count_p;
 					}
 				}
-				if(t == 0) {
-					long sum_value = 0, sum_count = 0, half_tmp;
-					for(int i = 0; i < max_threshold; i++) {
-						sum_value += i * counts[i];
-						sum_count += counts[i];
-					}
-					// 1920 = 2400 * 0.6 + 1200 * 0.4
-					if(sum_count > 60 * 1920) {
-						half_tmp = (int)((double)sum_value / (double)sum_count + 0.5);
-					} else {
-						half_tmp = (int)(header.sample_rate * FREQ_SCALE / 1920.0 / 2.0 + 0.5);
-					}
-					
-					sum_value = sum_count = 0;
-					for(int i = 0; i < half_tmp; i++) {
-						sum_value += i * counts[i];
-						sum_count += counts[i];
-					}
-					double lo_tmp = (double)sum_value / (double)sum_count;
-					
-					sum_value = sum_count = 0;
-					for(int i = half_tmp; i < half_tmp * 2; i++) {
-						sum_value += i * counts[i];
-						sum_count += counts[i];
-					}
-					double hi_tmp = (double)sum_value / (double)sum_count;
-					
-					half_threshold = (int)((lo_tmp + hi_tmp) / 2 + 0.5);
-					min_threshold = (int)(2 * lo_tmp - half_threshold + 0.5);
-					max_threshold = (int)(2 * hi_tmp - half_threshold + 0.5);
-					lo_count = (int)(lo_tmp / FREQ_SCALE + 0.5);
-					hi_count = (int)(hi_tmp / FREQ_SCALE + 0.5);
+				if(buffer != NULL) {
+					for(int j = 0; j < count_p; j++) buffer[loaded_samples++] = 0xff;
+					for(int j = 0; j < count_n; j++) buffer[loaded_samples++] = 0x00;
 				} else {
-					int count_p = count_positive / FREQ_SCALE;
-					int count_n = count_negative / FREQ_SCALE;
-					if(count_positive < max_threshold && count_positive > min_threshold && count_negative > min_threshold) {
-						count_p = (count_positive > half_threshold) ? hi_count : lo_count;
-						if(count_negative < max_threshold) {
-							count_n = count_p;
-						}
-					}
-					if(buffer != NULL) {
-						for(int j = 0; j < count_p; j++) buffer[loaded_samples++] = 0xff;
-						for(int j = 0; j < count_n; j++) buffer[loaded_samples++] = 0x00;
-					} else {
-						loaded_samples += count_p + count_n;
-					}
+					loaded_samples += count_p + count_n;
 				}
-				if(t == 1) {
-					buffer = (uint8_t *)malloc(loaded_samples);
+			}
+			if(t == 1) {
+				buffer = (uint8_t *)malloc(loaded_samples);
 #ifdef DATAREC_SOUND
-					if(header.channels > 1) {
-						sound_buffer_length = loaded_samples * sizeof(int16_t);
-						sound_buffer = (int16_t *)malloc(sound_buffer_length);
-					}
-#endif
-					loaded_samples = 0;
+				if(header.channels > 1) {
+					sound_buffer_length = loaded_samples * sizeof(int16_t);
+					sound_buffer = (int16_t *)malloc(sound_buffer_length);
 				}
+#endif
+				loaded_samples = 0;
 			}
-			free(counts);
-			free(wav_buffer);
 		}
+		free(counts);
+		free(wav_buffer);
 		free(tmp_buffer);
 	}
 	return loaded_samples;
 }
 
+bool DATAREC::open_wav_stream()
+{
+	if(!play_fio->IsOpened()) {
+		if(!play_fio->Fopen(play_file_path, FILEIO_READ_BINARY)) {
+			return false;
+		}
+	}
+	wav_chunk_num = (buffer_length + DATAREC_WAV_CHUNK_SIZE - 1) / DATAREC_WAV_CHUNK_SIZE;
+	wav_chunk_info = (datarec_chunk_t *)malloc(wav_chunk_num * sizeof(datarec_chunk_t));
+	for(int i = 0; i < wav_chunk_num; i++) {
+		wav_chunk_info[i].transitions = -1;
+		wav_chunk_info[i].first_signal = false;
+	}
+	wav_chunk_index = -1;
+	buffer = (uint8_t *)malloc(DATAREC_WAV_CHUNK_SIZE);
+#ifdef DATAREC_SOUND
+	if(wav_channels > 1) {
+		sound_buffer_length = DATAREC_WAV_CHUNK_SIZE * sizeof(int16_t);
+		sound_buffer = (int16_t *)malloc(sound_buffer_length);
+	}
+#endif
+	is_wav_stream = true;
+	return true;
+}
+
+void DATAREC::read_wav_samples(int top, int count, int16_t *signal_buffer, int16_t *voice_buffer)
+{
+	int sample_bytes = wav_sample_bits / 8;
+	int block_size = sample_bytes * wav_channels;
+	uint8_t *tmp_buffer = (uint8_t *)calloc(count, block_size);
+	
+	play_fio->Fseek(wav_data_offset + top * block_size, FILEIO_SEEK_SET);
+	play_fio->Fread(tmp_buffer, block_size, count);
+	
+	for(int i = 0; i < count; i++) {
+		int16_t sample[2] = {0, 0};
+		for(int ch = 0; ch < wav_channels && ch < 2; ch++) {
+			uint8_t *p = tmp_buffer + block_size * i + sample_bytes * ch;
+			if(wav_sample_bits == 16) {
+				sample[ch] = (int16_t)(p[0] | (p[1] << 8));
+			} else {
+				sample[ch] = ((int)p[0] - 128) * 256;
+			}
+		}
+#if defined(DATAREC_SOUND) && defined(DATAREC_SOUND_LEFT)
+		if(wav_channels > 1) {
+			signal_buffer[i] = sample[1];
+			if(voice_buffer != NULL) {
+				voice_buffer[i] = sample[0];
+			}
+			continue;
+		}
+#endif
+		signal_buffer[i] = sample[0];
+		if(voice_buffer != NULL) {
+			voice_buffer[i] = sample[1];
+		}
+	}
+	free(tmp_buffer);
+}
+
+void DATAREC::decode_wav_chunk(int index)
+{
+	int start = index * DATAREC_WAV_CHUNK_SIZE;
+	int end = min(start + DATAREC_WAV_CHUNK_SIZE, buffer_length);
+	int width = (int)((double)sample_rate / 1000.0 + 0.5);
+	int margin = 0x1000;
+	
+	while(1) {
+		// the zero position depends on the neighbor samples and the level check depends on
+		// the whole positive half wave, so decode some samples around the chunk together
+		int top = max(start - margin, 0);
+		int bottom = min(end + margin, buffer_length);
+		int raw_top = max(top - width * 2, 0);
+		int raw_bottom = min(bottom + width * 2, buffer_length);
+		int16_t *raw_buffer = (int16_t *)malloc((raw_bottom - raw_top) * sizeof(int16_t));
+		int16_t *wav_buffer = (int16_t *)malloc((bottom - top) * sizeof(int16_t));
+		int16_t *voice_buffer = NULL;
+#ifdef DATAREC_SOUND
+		if(sound_buffer != NULL) {
+			voice_buffer = (int16_t *)malloc((raw_bottom - raw_top) * sizeof(int16_t));
+		}
+#endif
+		read_wav_samples(raw_top, raw_bottom - raw_top, raw_buffer, voice_buffer);
+		
+		// same as adjust_zero_position()
+		for(int i = top; i < bottom; i++) {
+			int center = (i < width) ? width : (i < buffer_length - width) ? i : (buffer_length - width - 1);
+			int16_t zero = 0;
+			if(center >= width && center < buffer_length - width) {
+				int max_sample = -65536, min_sample = 65536;
+				for(int j = center - width; j < center + width; j++) {
+					int sample = raw_buffer[j - raw_top];
+					if(max_sample < sample) max_sample = sample;
+					if(min_sample > sample) min_sample = sample;
+				}
+				if(max_sample - min_sample > 4096) {
+					zero = (int16_t)((max_sample + min_sample) / 2);
+				} else {
+					zero = raw_buffer[center - raw_top];
+				}
+			}
+			wav_buffer[i - top] = raw_buffer[i - raw_top] - zero;
+		}
+		
+		// find the half waves across the chunk boundaries
+		int first = start, last = end;
+		if(wav_buffer[start - top] > 0) {
+			while(first > top && wav_buffer[first - 1 - top] > 0) {
+				first--;
+			}
+		}
+		if(wav_buffer[end - 1 - top] > 0) {
+			while(last < bottom && wav_buffer[last - top] > 0) {
+				last++;
+			}
+		}
+		if((first == top && top > 0) || (last == bottom && bottom < buffer_length)) {
+			// the half wave is too long, retry with the larger margin
+			free(raw_buffer);
+			free(wav_buffer);
+			if(voice_buffer != NULL) {
+				free(voice_buffer);
+			}
+			margin <<= 1;
+			continue;
+		}
+		
+		// positive half wave that is lower than the threshold is noise
+		for(int i = first; i < last;) {
+			bool signal = (wav_buffer[i - top] > 0);
+			int16_t max_sample = 0;
+			int j = i;
+			for(; j < last && (wav_buffer[j - top] > 0) == signal; j++) {
+				if(max_sample < wav_buffer[j - top]) {
+					max_sample = wav_buffer[j - top];
+				}
+			}
+			uint8_t value = (signal && max_sample > 2048) ? 0xff : 0;
+			for(int k = max(i, start); k < min(j, end); k++) {
+				buffer[k - start] = value;
+			}
+			i = j;
+		}
+#ifdef DATAREC_SOUND
+		if(voice_buffer != NULL) {
+			memcpy(sound_buffer, voice_buffer + (start - raw_top), (end - start) * sizeof(int16_t));
+			free(voice_buffer);
+		}
+#endif
+		free(raw_buffer);
+		free(wav_buffer);
+		break;
+	}
+	
+	// update the index
+	wav_chunk_info[index].first_signal = ((buffer[0] & 0x80) != 0);
+	wav_chunk_info[index].transitions = 0;
+	for(int i = 1; i < end - start; i++) {
+		if((buffer[i] ^ buffer[i - 1]) & 0x80) {
+			wav_chunk_info[index].transitions++;
+		}
+	}
+	wav_chunk_index = index;
+}
+
+bool DATAREC::get_play_signal(int ptr)
+{
+	if(is_wav_stream) {
+		int index = ptr / DATAREC_WAV_CHUNK_SIZE;
+		if(wav_chunk_info[index].transitions == 0) {
+			// no need to decode the chunk again
+			return wav_chunk_info[index].first_signal;
+		}
+		if(wav_chunk_index != index) {
+			decode_wav_chunk(index);
+		}
+		ptr -= index * DATAREC_WAV_CHUNK_SIZE;
+	}
+	return ((buffer[ptr] & 0x80) != 0);
+}
+
+#ifdef DATAREC_SOUND
+int16_t DATAREC::get_sound_sample(int ptr)
+{
+	if(is_wav_stream) {
+		int index = ptr / DATAREC_WAV_CHUNK_SIZE;
+		if(wav_chunk_index != index) {
+			decode_wav_chunk(index);
+		}
+		ptr -= index * DATAREC_WAV_CHUNK_SIZE;
+	}
+	return sound_buffer[ptr];
+}
+#endif
+
 void DATAREC::save_wav_image()
 {
 	// write samples remained in buffer
@@ -1602,22 +1736,15 @@ int DATAREC::load_msx_cas_image()
 
 void DATAREC::mix(int32_t* buffer, int cnt)
 {
+	bool signal = ((play && in_signal) || (rec && out_signal));
+	
 	if(config.sound_tape_signal && pcm_changed && remote && (play || rec) && ff_rew == 0) {
-		bool signal = ((play && in_signal) || (rec && out_signal));
-		if(signal) {
-			pcm_positive_clocks += get_passed_clock(pcm_prev_clock);
-		} else {
-			pcm_negative_clocks += get_passed_clock(pcm_prev_clock);
-		}
-		int clocks = pcm_positive_clocks + pcm_negative_clocks;
-		int sample = clocks ? (pcm_max_vol * pcm_positive_clocks - pcm_max_vol * pcm_negative_clocks) / clocks : signal ? pcm_max_vol : -pcm_max_vol;
+		// convert the logged edges to samples
+		pcm_edges.mix(buffer, cnt, get_current_clock(), pcm_max_vol, pcm_volume_l, pcm_volume_r);
 		
-		pcm_last_vol_l = apply_volume(sample, pcm_volume_l);
-		pcm_last_vol_r = apply_volume(sample, pcm_volume_r);
-		
-		for(int i = 0; i < cnt; i++) {
-			buffer[i] += pcm_last_vol_l; // L
-			buffer[i] += pcm_last_vol_r; // R
+		if(cnt > 0) {
+			pcm_last_vol_l = apply_volume(pcm_edges.get_last_sample(), pcm_volume_l);
+			pcm_last_vol_r = apply_volume(pcm_edges.get_last_sample(), pcm_volume_r);
 		}
 	} else if(pcm_last_vol_l || pcm_last_vol_r) {
 		// suppress petite noise when go to mute
@@ -1637,8 +1764,8 @@ void DATAREC::mix(int32_t* buffer, int cnt)
 			}
 		}
 	}
-	pcm_prev_clock = get_current_clock();
-	pcm_positive_clocks = pcm_negative_clocks = 0;
+	// the level may be changed by play/rec without logging edges
+	pcm_edges.clear(get_current_clock(), signal);
 	
 #ifdef DATAREC_SOUND
 	if(config.sound_tape_voice && remote && play && ff_rew == 0) {
@@ -1684,14 +1811,14 @@ void DATAREC::set_volume(int ch, int decibel_l, int decibel_r)
 
 double DATAREC::get_ave_hi_freq()
 {
-	if(ave_hi_freq == 0 && play && is_wav) {
+	if(ave_hi_freq == 0 && play && is_wav && buffer != NULL) {
 		bool prev_signal = false;
 		int positive = 0, negative = 0, pulse_count = 0;
 		double sum = 0;
 		double base_usec = 1000000.0 / (double)sample_rate;
 		
 		for(int i=0; i < buffer_length; i++) {
-			bool next_signal = ((buffer[i] & 0x80) != 0);
+			bool next_signal = get_play_signal(i);
 			if(!prev_signal && next_signal) {
 				double usec = base_usec * (positive + negative);
 				if(316.667 <= usec && usec < 516.667) {
@@ -1735,7 +1862,7 @@ void DATAREC::update_config()
 	update_realtime_render();
 }
 
-#define STATE_VERSION	8
+#define STATE_VERSION	10
 
 bool DATAREC::process_state(FILEIO* state_fio, bool loading)
 {
@@ -1798,7 +1925,20 @@ bool DATAREC::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(sample_rate);
 	state_fio->StateValue(sample_usec);
 	state_fio->StateValue(buffer_ptr);
-	if(loading) {
+	state_fio->StateValue(is_wav_stream);
+	if(is_wav_stream) {
+		// reopen the wave file instead of saving the decoded samples
+		state_fio->StateArray(play_file_path, sizeof(play_file_path), 1);
+		state_fio->StateValue(buffer_length);
+		state_fio->StateValue(wav_data_offset);
+		state_fio->StateValue(wav_channels);
+		state_fio->StateValue(wav_sample_bits);
+		if(loading) {
+			if(!open_wav_stream()) {
+				is_wav_stream = false;
+			}
+		}
+	} else if(loading) {
 		if((buffer_length = state_fio->FgetInt32_LE()) != 0) {
 			buffer = (uint8_t *)malloc(buffer_length);
 			state_fio->Fread(buffer, buffer_length, 1);
@@ -1859,12 +1999,10 @@ bool DATAREC::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(apss_remain);
 	state_fio->StateValue(apss_signals);
 	state_fio->StateValue(pcm_changed);
-	state_fio->StateValue(pcm_prev_clock);
-	state_fio->StateValue(pcm_positive_clocks);
-	state_fio->StateValue(pcm_negative_clocks);
 	
 	// post process
 	if(loading) {
+		pcm_edges.clear(get_current_clock(), (play && in_signal) || (rec && out_signal));
 		pcm_last_vol_l = pcm_last_vol_r = 0;
 #ifdef DATAREC_SOUND
 		sound_last_vol_l = sound_last_vol_r = 0;
@@ -13,6 +13,7 @@
 #include "vm.h"
 #include "../emu.h"
 #include "device.h"
+#include "edge_buffer.h"
 
 #define SIG_DATAREC_MIC		0
 #define SIG_DATAREC_REMOTE	1
@@ -21,6 +22,12 @@
 class FILEIO;
 class NOISE;
 
+// sparse index of the streamed wave image
+typedef struct {
+	int transitions;	// number of signal transitions in the chunk, -1 if not decoded yet
+	bool first_signal;
+} datarec_chunk_t;
+
 class DATAREC : public DEVICE
 {
 private:
@@ -62,14 +69,20 @@ private:
 	bool is_wav, is_tap, is_t77;
 	double ave_hi_freq;
 	
+	// standard PCM wave file is decoded by chunk while playing
+	bool is_wav_stream;
+	_TCHAR play_file_path[_MAX_PATH];
+	int wav_data_offset, wav_channels, wav_sample_bits;
+	int wav_chunk_num, wav_chunk_index;
+	datarec_chunk_t *wav_chunk_info;
+	
 	int apss_buffer_length;
 	bool *apss_buffer;
 	int apss_ptr, apss_count, apss_remain;
 	bool apss_signals;
 	
 	int pcm_changed;
-	uint32_t pcm_prev_clock;
-	int pcm_positive_clocks, pcm_negative_clocks;
+	EDGE_BUFFER pcm_edges;
 	int pcm_max_vol;
 	int32_t pcm_last_vol_l, pcm_last_vol_r;
 	int pcm_volume_l, pcm_volume_r;
@@ -84,6 +97,13 @@ private:
 	void close_file();
 	
 	int load_wav_image(int offset);
+	bool open_wav_stream();
+	void read_wav_samples(int top, int count, int16_t *signal_buffer, int16_t *voice_buffer);
+	void decode_wav_chunk(int index);
+	bool get_play_signal(int ptr);
+#ifdef DATAREC_SOUND
+	int16_t get_sound_sample(int ptr);
+#endif
 	void save_wav_image();
 	int load_t77_image();
 	int load_tap_image();
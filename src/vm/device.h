@@ -42,6 +42,7 @@
 #define SIG_SCSI_ATN		308
 #define SIG_SCSI_ACK		309
 #define SIG_SCSI_RST		310
+#define SIG_SCSI_DMAE		311
 
 class DEVICE
 {
@@ -204,6 +205,20 @@ public:
 			return val;
 		}
 	}
+	// run of 16bit writes with the same value (rep stosw), addr is stepped by step bytes for each word.
+	// get_data16w_run() returns the number of words that write_data16w_run() can write at once,
+	// and the wait of each word, or 0 if the bus does not support it at the address
+	virtual int get_data16w_run(uint32_t addr, int step, int count, int* wait)
+	{
+		return 0;
+	}
+	virtual void write_data16w_run(uint32_t addr, int step, uint32_t data, int count)
+	{
+		for(int i = 0; i < count; i++, addr += step) {
+			int wait = 0;
+			write_data16w(addr, data, &wait);
+		}
+	}
 	virtual uint32_t fetch_op(uint32_t addr, int *wait)
 	{
 		return read_data8w(addr, wait);
@@ -533,6 +548,18 @@ public:
 			return val;
 		}
 	}
+	// returns the number of words that write_memory_mapped_io16_run() can write at once, or 0
+	virtual int get_memory_mapped_io16_run(uint32_t addr, int step, int count, int *wait)
+	{
+		return 0;
+	}
+	virtual void write_memory_mapped_io16_run(uint32_t addr, int step, uint32_t data, int count)
+	{
+		for(int i = 0; i < count; i++, addr += step) {
+			int wait = 0;
+			write_memory_mapped_io16w(addr, data, &wait);
+		}
+	}
 	
 	// device to device
 	typedef struct {
@@ -825,6 +852,19 @@ public:
 		}
 		event_manager->touch_sound();
 	}
+	// returns the number of samples that touch_sound() will render now
+	virtual int get_sound_pending_samples()
+	{
+		return get_sound_pending_samples(this);
+	}
+	// the number is counted at the rate of the device if it is set by set_sound_native_rate()
+	virtual int get_sound_pending_samples(DEVICE* device)
+	{
+		if(event_manager == NULL) {
+			event_manager = vm->first_device->next_device;
+		}
+		return event_manager->get_sound_pending_samples(device);
+	}
 	virtual void set_realtime_render(DEVICE* device, bool flag)
 	{
 		if(event_manager == NULL) {
@@ -832,6 +872,15 @@ public:
 		}
 		event_manager->set_realtime_render(device, flag);
 	}
+	// the device renders samples at the rate, and they are resampled to the host rate
+	// by the sound manager. rate = 0 means the host rate
+	virtual void set_sound_native_rate(DEVICE* device, int rate)
+	{
+		if(event_manager == NULL) {
+			event_manager = vm->first_device->next_device;
+		}
+		event_manager->set_sound_native_rate(device, rate);
+	}
 	virtual void update_timing(int new_clocks, double new_frames_per_sec, int new_lines_per_frame) {}
 	
 	// event callback
@@ -841,8 +890,19 @@ public:
 	virtual void event_vline(int v, int clock) {}
 	virtual void event_hsync(int v, int h, int clock) {}
 	
+	// screen
+	// this is called from worker threads after emu->start_render_lines(),
+	// so refer only the snapshot taken before it, and write only the lines from top to bottom - 1
+	virtual void render_lines(int top, int bottom) {}
+	
 	// sound
 	virtual void mix(int32_t* buffer, int cnt) {}
+	// return true if mix() refers only this device and adds the samples to the buffer,
+	// then it may be called from a worker thread in parallel with other sound devices
+	virtual bool is_mix_thread_safe()
+	{
+		return false;
+	}
 	virtual void set_volume(int ch, int decibel_l, int decibel_r) {} // +1 equals +0.5dB (same as fmgen)
 	
 #ifdef USE_DEBUGGER
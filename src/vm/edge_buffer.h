@@ -0,0 +1,155 @@
+/*
+	Skelton for retropc emulator
+
+	Author : agent
+	Date   : 2026.10.19-
+
+	[ 1bit edge buffer ]
+*/
+
+#ifndef _EDGE_BUFFER_H_
+#define _EDGE_BUFFER_H_
+
+#include "../common.h"
+#include "blep_buffer.h"
+
+// the changes of 1bit signal are logged with the cpu clock when they happen,
+// and they are converted to pcm samples when the sound is mixed.
+// each sample is the average level of the signal in its period (box filter),
+// so the sound is correct without realtime rendering.
+// mix_blep() puts the edges to the blep buffer as band-limited steps instead.
+
+#define EDGE_BUFFER_SIZE	4096
+
+class EDGE_BUFFER
+{
+private:
+	uint32_t clocks[EDGE_BUFFER_SIZE];
+	bool levels[EDGE_BUFFER_SIZE];
+	int count;
+	uint32_t start_clock;
+	bool start_level, last_level;
+	int32_t last_sample;
+	
+public:
+	EDGE_BUFFER()
+	{
+		clear(0, false);
+		last_sample = 0;
+	}
+	// discard the logged edges, and start the next period at the clock
+	void clear(uint32_t clock, bool level)
+	{
+		count = 0;
+		start_clock = clock;
+		start_level = last_level = level;
+	}
+	bool is_full()
+	{
+		return (count == EDGE_BUFFER_SIZE);
+	}
+	bool get_level()
+	{
+		return last_level;
+	}
+	int32_t get_last_sample()
+	{
+		return last_sample;
+	}
+	void add(uint32_t clock, bool level)
+	{
+		if(level != last_level) {
+			if(count == EDGE_BUFFER_SIZE) {
+				// the last edge is moved to keep the current level
+				count--;
+			}
+			clocks[count] = clock;
+			levels[count] = level;
+			count++;
+			last_level = level;
+		}
+	}
+	// convert the edges from the start clock to the end clock to cnt samples,
+	// and add them to the stereo buffer
+	void mix(int32_t* buffer, int cnt, uint32_t end_clock, int max_vol, int volume_l, int volume_r)
+	{
+		if(cnt > 0) {
+			uint32_t total = end_clock - start_clock;
+			uint32_t prev = 0;
+			bool level = start_level;
+			int index = 0;
+			
+			for(int i = 0; i < cnt; i++) {
+				uint32_t next = (uint32_t)((uint64_t)total * (i + 1) / cnt);
+				uint32_t positive = 0, time = prev;
+				
+				while(index < count && clocks[index] - start_clock < next) {
+					uint32_t edge = clocks[index] - start_clock;
+					if(edge > time) {
+						if(level) {
+							positive += edge - time;
+						}
+						time = edge;
+					}
+					level = levels[index++];
+				}
+				if(level) {
+					positive += next - time;
+				}
+				uint32_t length = next - prev;
+				if(length != 0) {
+					last_sample = (int32_t)((int64_t)max_vol * (int64_t)(2 * (int64_t)positive - length) / length);
+				} else {
+					last_sample = level ? max_vol : -max_vol;
+				}
+				*buffer++ += apply_volume(last_sample, volume_l); // L
+				*buffer++ += apply_volume(last_sample, volume_r); // R
+				prev = next;
+			}
+		}
+		clear(end_clock, last_level);
+	}
+	// convert the edges to the band-limited steps at their sub-sample positions,
+	// and add cnt samples rendered with the blep buffer to the stereo buffer
+	void mix_blep(BLEP_BUFFER* blep, int32_t* blep_level, int32_t* buffer, int cnt, uint32_t end_clock, int max_vol, int volume_l, int volume_r)
+	{
+		if(cnt > 0) {
+			uint32_t total = end_clock - start_clock;
+			int32_t level = start_level ? max_vol : -max_vol;
+			int index = 0;
+			
+			if(level != *blep_level) {
+				blep->add_delta(0, level - *blep_level);
+				*blep_level = level;
+			}
+			for(int pos = 0; pos < cnt;) {
+				int samples = min(cnt - pos, BLEP_BLOCK);
+				uint64_t block_start = (uint64_t)pos << BLEP_TIME_BITS;
+				uint64_t block_end = (uint64_t)(pos + samples) << BLEP_TIME_BITS;
+				
+				while(index < count) {
+					uint64_t time = 0;
+					if(total != 0) {
+						time = ((uint64_t)(clocks[index] - start_clock) * cnt << BLEP_TIME_BITS) / total;
+					}
+					if(time >= block_end) {
+						if(pos + samples < cnt) {
+							break;
+						}
+						time = block_end - 1;
+					}
+					level = levels[index++] ? max_vol : -max_vol;
+					blep->add_delta((uint32_t)(time - block_start), level - *blep_level);
+					*blep_level = level;
+				}
+				blep->mix(buffer, samples, volume_l, volume_r);
+				buffer += samples * 2;
+				pos += samples;
+			}
+			last_sample = *blep_level;
+		}
+		clear(end_clock, last_level);
+	}
+};
+
+#endif
@@ -8,6 +8,7 @@
 */
 
 #include "event.h"
+#include "resampler.h"
 
 #define EVENT_VLINE	0
 #define EVENT_MIX	1
@@ -23,6 +24,7 @@ void EVENT::initialize()
 	// initialize sound buffer
 	sound_buffer = NULL;
 	sound_tmp = NULL;
+	sound_mix_tmp = NULL;
 	
 	dont_skip_frames = 0;
 	prev_skip = next_skip = false;
@@ -39,12 +41,16 @@ void EVENT::initialize()
 void EVENT::initialize_sound(int rate, int samples)
 {
 	// initialize sound
+	sound_rate = rate;
 	sound_samples = samples;
 	sound_tmp_samples = samples * 2;
 	sound_buffer = (uint16_t*)malloc(sound_samples * sizeof(uint16_t) * 2);
 	memset(sound_buffer, 0, sound_samples * sizeof(uint16_t) * 2);
 	sound_tmp = (int32_t*)malloc(sound_tmp_samples * sizeof(int32_t) * 2);
 	memset(sound_tmp, 0, sound_tmp_samples * sizeof(int32_t) * 2);
+	if(dcount_sound > 1) {
+		sound_mix_tmp = (int32_t*)malloc(sound_tmp_samples * sizeof(int32_t) * 2 * dcount_sound);
+	}
 	buffer_ptr = 0;
 	mix_counter = 1;
 	mix_limit = (int)((double)(emu->get_sound_rate() / 2000.0)); // per 0.5ms.
@@ -62,6 +68,15 @@ void EVENT::release()
 	if(sound_tmp) {
 		free(sound_tmp);
 	}
+	if(sound_mix_tmp) {
+		free(sound_mix_tmp);
+	}
+	for(int i = 0; i < dcount_sound; i++) {
+		if(sound_resampler[i] != NULL) {
+			delete sound_resampler[i];
+			sound_resampler[i] = NULL;
+		}
+	}
 }
 
 void EVENT::reset()
@@ -83,6 +98,11 @@ void EVENT::reset()
 	if(sound_tmp) {
 		memset(sound_tmp, 0, sound_tmp_samples * sizeof(int32_t) * 2);
 	}
+	for(int i = 0; i < dcount_sound; i++) {
+		if(sound_resampler[i] != NULL) {
+			sound_resampler[i]->clear();
+		}
+	}
 //	buffer_ptr = 0;
 	
 #ifdef _DEBUG_LOG
@@ -511,6 +531,25 @@ void EVENT::touch_sound()
 	}
 }
 
+int EVENT::get_sound_pending_samples(DEVICE* device)
+{
+	if(!(config.sound_strict_rendering || (need_mix > 0))) {
+		int samples = mix_counter;
+		if(samples >= (sound_tmp_samples - buffer_ptr)) {
+			samples = sound_tmp_samples - buffer_ptr;
+		}
+		if(samples > 0) {
+			for(int i = 0; i < dcount_sound; i++) {
+				if(d_sound[i] == device && sound_resampler[i] != NULL) {
+					return sound_resampler[i]->get_input_samples(samples);
+				}
+			}
+			return samples;
+		}
+	}
+	return 0;
+}
+
 void EVENT::set_realtime_render(DEVICE* device, bool flag)
 {
 	assert(device != NULL && device->this_device_id < MAX_DEVICE);
@@ -526,6 +565,22 @@ void EVENT::set_realtime_render(DEVICE* device, bool flag)
 	}
 }
 
+void EVENT::set_sound_native_rate(DEVICE* device, int rate)
+{
+	for(int i = 0; i < dcount_sound; i++) {
+		if(d_sound[i] == device) {
+			if(sound_resampler[i] != NULL) {
+				delete sound_resampler[i];
+				sound_resampler[i] = NULL;
+			}
+			if(rate > 0 && rate != sound_rate) {
+				sound_resampler[i] = new RESAMPLER(rate, sound_rate, sound_tmp_samples);
+			}
+			break;
+		}
+	}
+}
+
 void EVENT::event_callback(int event_id, int err)
 {
 	if(event_id == EVENT_VLINE) {
@@ -571,8 +626,12 @@ void EVENT::mix_sound(int samples)
 	if(samples > 0) {
 		int32_t* buffer = sound_tmp + buffer_ptr * 2;
 		memset(buffer, 0, samples * sizeof(int32_t) * 2);
-		for(int i = 0; i < dcount_sound; i++) {
-			d_sound[i]->mix(buffer, samples);
+		if(config.sound_parallel_mixing && sound_mix_tmp != NULL) {
+			mix_sound_parallel(buffer, samples);
+		} else {
+			for(int i = 0; i < dcount_sound; i++) {
+				mix_device_sound(i, buffer, samples);
+			}
 		}
 		if(!sound_changed) {
 			for(int i = 0; i < samples * 2; i += 2) {
@@ -591,6 +650,70 @@ void EVENT::mix_sound(int samples)
 	}
 }
 
+void EVENT::mix_sound_parallel(int32_t* buffer, int samples)
+{
+	DEVICE* devices[MAX_SOUND];
+	int32_t* buffers[MAX_SOUND];
+	int counts[MAX_SOUND];
+	int indexes[MAX_SOUND];
+	int count = 0;
+	
+	// thread safe devices are mixed to their own buffers on worker threads
+	for(int i = 0; i < dcount_sound; i++) {
+		if(d_sound[i]->is_mix_thread_safe()) {
+			devices[count] = d_sound[i];
+			indexes[count] = i;
+			if(sound_resampler[i] != NULL) {
+				counts[count] = sound_resampler[i]->get_input_samples(samples);
+				buffers[count] = sound_resampler[i]->get_render_buffer(counts[count]);
+			} else {
+				counts[count] = samples;
+				buffers[count] = sound_mix_tmp + sound_tmp_samples * 2 * count;
+				memset(buffers[count], 0, samples * sizeof(int32_t) * 2);
+			}
+			count++;
+		}
+	}
+	if(count > 1) {
+		emu->run_mix_sound(devices, buffers, count, counts);
+	} else if(count == 1) {
+		devices[0]->mix(buffers[0], counts[0]);
+	}
+	
+	// sum them in the order of devices, other devices are mixed here as before
+	// so that they see the same buffer as the serial mixing
+	for(int i = 0, j = 0; i < dcount_sound; i++) {
+		if(j < count && indexes[j] == i) {
+			if(sound_resampler[i] != NULL) {
+				sound_resampler[i]->mix(buffer, samples, counts[j]);
+			} else {
+				int32_t* src = buffers[j];
+__DECL_VECTORIZED_LOOP
+				for(int k = 0; k < samples * 2; k++) {
+					buffer[k] += src[k];
+				}
+			}
+			j++;
+		} else {
+			mix_device_sound(i, buffer, samples);
+		}
+	}
+}
+
+void EVENT::mix_device_sound(int index, int32_t* buffer, int samples)
+{
+	RESAMPLER* resampler = sound_resampler[index];
+	
+	if(resampler != NULL) {
+		// render at the rate of device, and resample it to the host rate
+		int input_samples = resampler->get_input_samples(samples);
+		d_sound[index]->mix(resampler->get_render_buffer(input_samples), input_samples);
+		resampler->mix(buffer, samples, input_samples);
+	} else {
+		d_sound[index]->mix(buffer, samples);
+	}
+}
+
 uint16_t* EVENT::create_sound(int* extra_frames)
 {
 	if(prev_skip && dont_skip_frames == 0 && !sound_changed) {
@@ -613,19 +736,11 @@ uint16_t* EVENT::create_sound(int* extra_frames)
 	}
 #endif
 	// copy to buffer
+__DECL_VECTORIZED_LOOP
 	for(int i = 0; i < sound_samples * 2; i++) {
 		int dat = sound_tmp[i];
-		uint16_t highlow = (uint16_t)(dat & 0x0000ffff);
-		
-		if((dat > 0) && (highlow >= 0x8000)) {
-			sound_buffer[i] = 0x7fff;
-			continue;
-		}
-		if((dat < 0) && (highlow < 0x8000)) {
-			sound_buffer[i] = 0x8000;
-			continue;
-		}
-		sound_buffer[i] = highlow;
+		dat = (dat > 32767) ? 32767 : (dat < -32768) ? -32768 : dat;
+		sound_buffer[i] = (uint16_t)dat;
 	}
 	if(buffer_ptr > sound_samples) {
 		buffer_ptr -= sound_samples;
@@ -740,6 +855,11 @@ bool EVENT::process_state(FILEIO* state_fio, bool loading)
 		if(sound_tmp) {
 			memset(sound_tmp, 0, sound_tmp_samples * sizeof(int32_t) * 2);
 		}
+		for(int i = 0; i < dcount_sound; i++) {
+			if(sound_resampler[i] != NULL) {
+				sound_resampler[i]->clear();
+			}
+		}
 		buffer_ptr = 0;
 		mix_counter = 1;
 		mix_limit = (int)((double)(emu->get_sound_rate() / 2000.0));  // per 0.5ms.
@@ -21,6 +21,8 @@
 #define MAX_EVENT	64
 #define NO_EVENT	-1
 
+class RESAMPLER;
+
 class EVENT : public DEVICE
 {
 private:
@@ -75,6 +77,9 @@ private:
 	
 	uint16_t* sound_buffer;
 	int32_t* sound_tmp;
+	int32_t* sound_mix_tmp;	// for each device in parallel mixing
+	RESAMPLER* sound_resampler[MAX_SOUND];	// for each device rendered at its own rate
+	int sound_rate;
 	int buffer_ptr;
 	int sound_samples;
 	int sound_tmp_samples;
@@ -89,6 +94,8 @@ private:
 	int need_mix;
 	
 	void mix_sound(int samples);
+	void mix_sound_parallel(int32_t* buffer, int samples);
+	void mix_device_sound(int index, int32_t* buffer, int samples);
 	void* get_event(int index);
 	
 #ifdef _DEBUG_LOG
@@ -122,6 +129,7 @@ public:
 		// reset before other device may call set_realtime_render()
 		memset(dev_need_mix, 0, sizeof(dev_need_mix));
 		need_mix = 0;
+		memset(sound_resampler, 0, sizeof(sound_resampler));
 		
 #ifdef _DEBUG_LOG
 		initialize_done = false;
@@ -203,7 +211,9 @@ public:
 	uint32_t get_cpu_pc(int index);
 	void request_skip_frames();
 	void touch_sound();
+	int get_sound_pending_samples(DEVICE* device);
 	void set_realtime_render(DEVICE* device, bool flag);
+	void set_sound_native_rate(DEVICE* device, int rate);
 	
 	// unique functions
 	double get_frame_rate()
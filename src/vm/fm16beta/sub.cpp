@@ -126,6 +126,9 @@ void SUB::reset()
 	
 	cmdreg = maskreg = compbit = bankdis = 0;
 	memset(compreg, 0xff, sizeof(compreg));
+	
+	screen_redraw = true;
+	txt_blink = blink;
 }
 
 void SUB::write_data8(uint32_t addr, uint32_t data)
@@ -188,9 +191,18 @@ void SUB::write_memory(uint32_t addr, uint32_t data)
 			addr &= 0x3fff;
 			addr |= bank << 14;
 		}
-		if(update & 1) gvram[addr | 0x00000] = data;
-		if(update & 2) gvram[addr | 0x10000] = data;
-		if(update & 4) gvram[addr | 0x20000] = data;
+		if(update & 1) {
+			gvram[addr | 0x00000] = data;
+			gvram_dirty[(addr | 0x00000) >> 4] = 1;
+		}
+		if(update & 2) {
+			gvram[addr | 0x10000] = data;
+			gvram_dirty[(addr | 0x10000) >> 4] = 1;
+		}
+		if(update & 4) {
+			gvram[addr | 0x20000] = data;
+			gvram_dirty[(addr | 0x20000) >> 4] = 1;
+		}
 	} else if(addr >= 0xff80 && addr < 0xffe0) {
 		uint8_t change;
 		
@@ -260,9 +272,11 @@ void SUB::write_memory(uint32_t addr, uint32_t data)
 			break;
 		case 0xff96:
 			kanji16[(kj_ofs | ((kj_row & 0xf) << 1)) & 0x3ffff] = data;
+			screen_redraw = true;
 			break;
 		case 0xff97:
 			kanji16[(kj_ofs | ((kj_row++ & 0xf) << 1) | 1) & 0x3ffff] = data;
+			screen_redraw = true;
 			break;
 
 		case 0xff98:
@@ -353,6 +367,13 @@ void SUB::write_memory(uint32_t addr, uint32_t data)
 #endif
 		}
 	} else {
+		if(addr >= 0x8000 && addr < 0x9000 && !(pagesel & 0x20)) {
+			// cvram
+			tvram_dirty[(addr & 0xfff) >> 4] = 1;
+		} else if(addr >= 0xa000 && addr < 0xb000) {
+			// kvram (ank8 is mapped only to read)
+			tvram_dirty[(addr & 0xfff) >> 4] = 1;
+		}
 		MEMORY::write_data8(addr, data);
 	}
 }
@@ -611,6 +632,7 @@ void SUB::point(int x, int y, int col)
 				} else {
 					gvram[0x8000 * pl + ofs] &= ~bit;
 				}
+				gvram_dirty[(0x8000 * pl + ofs) >> 4] = 1;
 			}
 		}
 	}
@@ -654,10 +676,24 @@ void SUB::line()
 
 void SUB::draw_screen()
 {
-	// render screen
-	memset(screen_txt, 0, sizeof(screen_txt));
-	memset(screen_cg, 0, sizeof(screen_cg));
+	// redraw all lines when the screen mode is changed
+	// cursor address (chreg[14-15]) is checked in each row
+	if(screen_redraw || memcmp(chreg, chreg_copy, sizeof(chreg_copy)) != 0 || ((mix ^ mix_copy) & 8) || outctrl != outctrl_copy || dispctrl != dispctrl_copy || dispaddr != dispaddr_copy) {
+		memset(screen_txt, 0, sizeof(screen_txt));
+		memset(screen_cg, 0, sizeof(screen_cg));
+		for(int y = 0; y < 256; y++) {
+			txt_row_begin[y] = -1;
+		}
+		memcpy(chreg_copy, chreg, sizeof(chreg_copy));
+		mix_copy = mix;
+		outctrl_copy = outctrl;
+		dispctrl_copy = dispctrl;
+		dispaddr_copy = dispaddr;
+		txt_caddr = -1;
+		screen_redraw = true;
+	}
 	
+	// render screen
 	if(outctrl & 1) {
 		if(mix & 8) {
 			draw_text80();
@@ -672,6 +708,9 @@ void SUB::draw_screen()
 	} else if(outctrl & 8) {
 		// green graphics
 	}
+	memset(gvram_dirty, 0, sizeof(gvram_dirty));
+	memset(tvram_dirty, 0, sizeof(tvram_dirty));
+	screen_redraw = false;
 	
 	for(int y = 0; y < SCREEN_HEIGHT; y++) {
 		scrntype_t* dest = emu->get_screen_buffer(y);
@@ -685,6 +724,29 @@ void SUB::draw_screen()
 	emu->screen_skip_line(false);
 }
 
+bool SUB::check_text_row(int y, int src, int caddr)
+{
+	// the row is redrawn when its address is moved, its vram is written,
+	// or the cursor or blinking characters in it are changed
+	if(txt_row_begin[y] != src) {
+		return true;
+	}
+	if(blink != txt_blink && txt_row_blink[y]) {
+		return true;
+	}
+	bool cursor_moved = (caddr != txt_caddr);
+	
+	for(int i = src; i != txt_row_end[y]; i = (i + 1) & 0xfff) {
+		if(tvram_dirty[i >> 4]) {
+			return true;
+		}
+		if(cursor_moved && ((i >> 1) == caddr || (i >> 1) == txt_caddr)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void SUB::draw_text40()
 {
 	int src = ((chreg[12] << 9) | (chreg[13] << 1)) & 0xfff;
@@ -693,6 +755,17 @@ void SUB::draw_text40()
 	int yofs = 400 / ymax;
 	
 	for(int y = 0; y < ymax; y++) {
+		// skip the row if nothing is changed
+		int begin = src;
+		if(!check_text_row(y, src, caddr)) {
+			src = txt_row_end[y];
+			continue;
+		}
+		for(int yy = y * yofs; yy < (y + 1) * yofs && yy < 400; yy++) {
+			memset(screen_txt[yy], 0, sizeof(screen_txt[yy]));
+		}
+		txt_row_blink[y] = 0;
+		
 		for(int x = 0; x < 40; x++) {
 			bool cursor = ((src >> 1) == caddr);
 			int cx = x;
@@ -775,8 +848,15 @@ void SUB::draw_text40()
 					}
 				}
 			}
+			if(cursor || (attr & 0x10)) {
+				txt_row_blink[y] = 1;
+			}
 		}
+		txt_row_begin[y] = begin;
+		txt_row_end[y] = src;
 	}
+	txt_caddr = caddr;
+	txt_blink = blink;
 }
 
 void SUB::draw_text80()
@@ -787,6 +867,17 @@ void SUB::draw_text80()
 	int yofs = 400 / ymax;
 	
 	for(int y = 0; y < 25; y++) {
+		// skip the row if nothing is changed
+		int begin = src;
+		if(!check_text_row(y, src, caddr)) {
+			src = txt_row_end[y];
+			continue;
+		}
+		for(int yy = y * yofs; yy < (y + 1) * yofs && yy < 400; yy++) {
+			memset(screen_txt[yy], 0, sizeof(screen_txt[yy]));
+		}
+		txt_row_blink[y] = 0;
+		
 		for(int x = 0; x < 80; x++) {
 			bool cursor = ((src >> 1) == caddr);
 			int cx = x;
@@ -869,8 +960,31 @@ void SUB::draw_text80()
 					}
 				}
 			}
+			if(cursor || (attr & 0x10)) {
+				txt_row_blink[y] = 1;
+			}
+		}
+		txt_row_begin[y] = begin;
+		txt_row_end[y] = src;
+	}
+	txt_caddr = caddr;
+	txt_blink = blink;
+}
+
+bool SUB::check_cg_line(uint8_t* plane, int ptr, int mask)
+{
+	// the plane is not displayed
+	if(plane < gvram || plane >= gvram + sizeof(gvram)) {
+		return false;
+	}
+	int base = (int)(plane - gvram);
+	
+	for(int i = 0; i < 80; i += 16) {
+		if(base + ((ptr + i) & mask) < (int)sizeof(gvram) && gvram_dirty[(base + ((ptr + i) & mask)) >> 4]) {
+			return true;
 		}
 	}
+	return (base + ((ptr + 79) & mask) < (int)sizeof(gvram) && gvram_dirty[(base + ((ptr + 79) & mask)) >> 4]);
 }
 
 void SUB::draw_cg()
@@ -884,6 +998,11 @@ void SUB::draw_cg()
 		int ptr = dispaddr & 0x7ffe;
 		
 		for(int y = 0; y < 400; y++) {
+			// skip the line if its vram is not written
+			if(!screen_redraw && !check_cg_line(p0, ptr, 0x7fff) && !check_cg_line(p1, ptr, 0x7fff) && !check_cg_line(p2, ptr, 0x7fff)) {
+				ptr = (ptr + 80) & 0x7fff;
+				continue;
+			}
 			for(int x = 0; x < 640; x += 8) {
 				uint8_t r = p0[ptr];
 				uint8_t g = p1[ptr];
@@ -910,6 +1029,11 @@ void SUB::draw_cg()
 		int ptr = dispaddr & 0x3ffe;
 		
 		for(int y = 0; y < 400; y += 2) {
+			// skip the line if its vram is not written
+			if(!screen_redraw && !check_cg_line(p0, ptr, 0x3fff) && !check_cg_line(p1, ptr, 0x3fff) && !check_cg_line(p2, ptr, 0x3fff)) {
+				ptr = (ptr + 80) & 0x3fff;
+				continue;
+			}
 			for(int x = 0; x < 640; x += 8) {
 				uint8_t r = p0[ptr];
 				uint8_t g = p1[ptr];
@@ -941,6 +1065,9 @@ bool SUB::process_state(FILEIO* state_fio, bool loading)
 	if(!state_fio->StateCheckInt32(this_device_id)) {
 		return false;
 	}
+	if(loading) {
+		screen_redraw = true;
+	}
 	return MEMORY::process_state(state_fio, loading);
 }
 
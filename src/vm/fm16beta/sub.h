@@ -79,6 +79,19 @@ private:
 	scrntype_t palette_txt[8];
 	scrntype_t palette_cg[8];
 	
+	// dirty flags per 16 bytes to redraw only the changed rows and lines
+	uint8_t gvram_dirty[0x30000 >> 4];
+	uint8_t tvram_dirty[0x1000 >> 4];
+	uint8_t chreg_copy[14];
+	uint8_t mix_copy, outctrl_copy, dispctrl_copy;
+	uint16_t dispaddr_copy;
+	bool screen_redraw;
+	int txt_row_begin[256], txt_row_end[256];
+	uint8_t txt_row_blink[256];
+	int txt_caddr, txt_blink;
+	
+	bool check_text_row(int y, int src, int caddr);
+	bool check_cg_line(uint8_t* plane, int ptr, int mask);
 	void draw_text40();
 	void draw_text80();
 	void draw_cg();
@@ -8,6 +8,7 @@
 #include "../vm.h"
 #include "../../emu.h"
 #include "fm7_display.h"
+#include "../planar.h"
 #if defined(_FM77L4)
 #include "../hd46505.h"
 #endif
@@ -513,24 +514,11 @@ void DISPLAY::GETVRAM_8_200L(int yoff, scrntype_t *p,
 	if(!multimode_dispflags[1]) r = gvram_shadow[yoff_d + 0x04000];
 	if(!multimode_dispflags[2]) g = gvram_shadow[yoff_d + 0x08000];
 
-	uint16_t *pg = &(bit_trans_table_0[g][0]);
-	uint16_t *pr = &(bit_trans_table_1[r][0]);
-	uint16_t *pb = &(bit_trans_table_2[b][0]);
-	uint16_t tmp_d[8];
+	uint8_t tmp_d[8];
 	scrntype_t tmp_dd[8];
 
-__DECL_VECTORIZED_LOOP
-	for(int i = 0; i < 8; i++) {
-		tmp_d[i] = pr[i];
-		tmp_d[i]  = tmp_d[i] | pg[i];
-		tmp_d[i]  = tmp_d[i] | pb[i];
-		tmp_d[i] = tmp_d[i] >> 5;
-	}
-
-__DECL_VECTORIZED_LOOP
-	for(int i = 0; i < 8; i++) {
-		tmp_dd[i] = dpalette_pixel[tmp_d[i]];
-	}
+	planar_to_chunky_msb(tmp_d, b, r, g);
+	chunky_to_rgb(tmp_dd, tmp_d, dpalette_pixel, 8);
 #if defined(FIXED_FRAMEBUFFER_SIZE)
 	if(scan_line) {
 /* Fancy scanline */
@@ -718,6 +718,81 @@ inline FM::ISample FM::Operator::CalcFBL(uint fb)
 	return out_;
 }
 
+//	OP block calculation without LFO
+//	dest[0] = output before the block, dest[i+1] = output of i-th sample
+//	in[i] = input of i-th sample, or NULL if no input
+//	envelope is not changed and phase increases linearly until the next EGCalc(),
+//	so the samples between them are calculated in a loop that can be vectorized
+void FM::Operator::CalcBlock(ISample* dest, const ISample* in, int n)
+{
+	dest[0] = out_;
+	for (int i=0; i<n; )
+	{
+		// number of samples before the envelope is changed
+		int run;
+		if (eg_count_diff_ > 0)
+			run = (eg_count_ > 0) ? Min((eg_count_ - 1) / eg_count_diff_, n - i) : 0;
+		else
+			run = (eg_count_ - eg_count_diff_ > 0) ? n - i : 0;
+
+		if (run > 0)
+		{
+			int eg = eg_out_;
+			uint32 pg = pg_count_;
+			uint32 pgd = pg_diff_;
+			ISample* d = dest + i + 1;
+			if (in)
+			{
+				const ISample* s = in + i;
+__DECL_VECTORIZED_LOOP
+				for (int j=0; j<run; j++)
+				{
+					int pgin = (pg + pgd * j) >> (20+FM_PGBITS-FM_OPSINBITS);
+					pgin += s[j] >> (20+FM_PGBITS-FM_OPSINBITS-(2+IS2EC_SHIFT));
+					d[j] = LogToLin(eg + SINE(pgin));
+				}
+			}
+			else
+			{
+__DECL_VECTORIZED_LOOP
+				for (int j=0; j<run; j++)
+				{
+					int pgin = (pg + pgd * j) >> (20+FM_PGBITS-FM_OPSINBITS);
+					d[j] = LogToLin(eg + SINE(pgin));
+				}
+			}
+			eg_count_ -= eg_count_diff_ * run;
+			pg_count_ += pgd * run;
+			i += run;
+		}
+		if (i < n)
+		{
+			// envelope is changed in this sample
+			EGStep();
+			int pgin = PGCalc() >> (20+FM_PGBITS-FM_OPSINBITS);
+			if (in)
+				pgin += in[i] >> (20+FM_PGBITS-FM_OPSINBITS-(2+IS2EC_SHIFT));
+			dest[i+1] = LogToLin(eg_out_ + SINE(pgin));
+			i++;
+		}
+	}
+	out2_ = dest[n-1];
+	out_ = dest[n];
+	dbgopout_ = out_;
+}
+
+//	OP (FB) block calculation without LFO
+//	dest[0] = output before the block, dest[i+1] = output of i-th sample
+void FM::Operator::CalcFBBlock(ISample* dest, uint fb, int n)
+{
+	dest[0] = out_;
+	for (int i=0; i<n; i++)
+	{
+		CalcFB(fb);
+		dest[i+1] = out_;
+	}
+}
+
 // ---------------------------------------------------------------------------
 //	Xe[gZ[u
 //
@@ -1015,6 +1090,81 @@ ISample Channel4::CalcL()
 	return r;
 }
 
+//  block calculation without LFO
+//  each operator is calculated for all samples in the block in the order of
+//  dependency, the result is same as calling Calc() for each sample
+void Channel4::CalcBlock(ISample* dest, int n)
+{
+	ISample o[4][FM_BLOCKSIZE + 1];
+	ISample m[FM_BLOCKSIZE];
+	int i;
+
+	// o[x][i] = output of op[x] before i-th sample, o[x][i+1] = after it
+	op[0].CalcFBBlock(o[0], fb, n);
+	switch (algo_)
+	{
+	case 0:
+		op[1].CalcBlock(o[1], o[0], n);
+		op[2].CalcBlock(o[2], o[1], n);
+		op[3].CalcBlock(o[3], o[2] + 1, n);
+		memcpy(dest, o[3] + 1, n * sizeof(ISample));
+		break;
+	case 1:
+		op[1].CalcBlock(o[1], NULL, n);
+		for (i=0; i<n; i++)
+			m[i] = o[0][i] + o[1][i];
+		op[2].CalcBlock(o[2], m, n);
+		op[3].CalcBlock(o[3], o[2] + 1, n);
+		memcpy(dest, o[3] + 1, n * sizeof(ISample));
+		break;
+	case 2:
+		op[1].CalcBlock(o[1], NULL, n);
+		op[2].CalcBlock(o[2], o[1], n);
+		for (i=0; i<n; i++)
+			m[i] = o[0][i] + o[2][i+1];
+		op[3].CalcBlock(o[3], m, n);
+		memcpy(dest, o[3] + 1, n * sizeof(ISample));
+		break;
+	case 3:
+		op[2].CalcBlock(o[2], NULL, n);
+		op[1].CalcBlock(o[1], o[0], n);
+		for (i=0; i<n; i++)
+			m[i] = o[1][i+1] + o[2][i+1];
+		op[3].CalcBlock(o[3], m, n);
+		memcpy(dest, o[3] + 1, n * sizeof(ISample));
+		break;
+	case 4:
+		op[2].CalcBlock(o[2], NULL, n);
+		op[1].CalcBlock(o[1], o[0], n);
+		op[3].CalcBlock(o[3], o[2] + 1, n);
+		for (i=0; i<n; i++)
+			dest[i] = o[1][i+1] + o[3][i+1];
+		break;
+	case 5:
+		op[2].CalcBlock(o[2], o[0], n);
+		op[1].CalcBlock(o[1], o[0], n);
+		op[3].CalcBlock(o[3], o[0], n);
+		for (i=0; i<n; i++)
+			dest[i] = o[2][i+1] + o[1][i+1] + o[3][i+1];
+		break;
+	case 6:
+		op[2].CalcBlock(o[2], NULL, n);
+		op[1].CalcBlock(o[1], o[0], n);
+		op[3].CalcBlock(o[3], NULL, n);
+		for (i=0; i<n; i++)
+			dest[i] = o[2][i+1] + o[1][i+1] + o[3][i+1];
+		break;
+	case 7:
+		op[2].CalcBlock(o[2], NULL, n);
+		op[1].CalcBlock(o[1], NULL, n);
+		op[3].CalcBlock(o[3], NULL, n);
+		// CalcFB() returns the output before the sample
+		for (i=0; i<n; i++)
+			dest[i] = o[2][i+1] + o[1][i+1] + o[3][i+1] + o[0][i];
+		break;
+	}
+}
+
 //  
 ISample Channel4::CalcN(uint noise)
 {
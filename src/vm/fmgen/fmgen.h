@@ -30,6 +30,9 @@
 //	TCg̐x 2^(1/256)
 #define FM_CLENTS		(0x1000 * 2)	// sin + TL + LFO
 
+//	number of samples rendered at once by CalcBlock()
+#define FM_BLOCKSIZE	64
+
 // ---------------------------------------------------------------------------
 
 namespace FM
@@ -58,6 +61,8 @@ namespace FM
 		ISample CalcFB(uint fb);
 		ISample CalcFBL(uint fb);
 		ISample CalcN(uint noise);
+		void	CalcBlock(ISample* dest, const ISample* in, int n);
+		void	CalcFBBlock(ISample* dest, uint fb, int n);
 		void	Prepare();
 		void	KeyOn();
 		void	KeyOff();
@@ -205,6 +210,7 @@ namespace FM
 		ISample CalcL();
 		ISample CalcN(uint noise);
 		ISample CalcLN(uint noise);
+		void CalcBlock(ISample* dest, int n);
 		void SetFNum(uint fnum);
 		void SetFB(uint fb);
 		void SetKCKF(uint kc, uint kf);
@@ -405,18 +405,30 @@ void OPN::Mix(Sample* buffer, int nsamples)
 	int actch = (((ch[2].Prepare() << 2) | ch[1].Prepare()) << 2) | ch[0].Prepare();
 	if (actch & 0x15)
 	{
-		Sample* limit = buffer + nsamples * 2;
-		for (Sample* dest = buffer; dest < limit; dest+=2)
+		// each channel is calculated by blocks of samples
+		ISample sbuf[FM_BLOCKSIZE];
+		ISample cbuf[FM_BLOCKSIZE];
+		for (Sample* dest = buffer; nsamples > 0; )
 		{
-			ISample s = 0;
-			ISample s_l, s_r;
-			if (actch & 0x01) s  = ch[0].Calc();
-			if (actch & 0x04) s += ch[1].Calc();
-			if (actch & 0x10) s += ch[2].Calc();
-			s_l = IStoSampleL(s);
-			s_r = IStoSampleR(s);
-			StoreSample(dest[0], s_l);
-			StoreSample(dest[1], s_r);
+			int n = Min(nsamples, FM_BLOCKSIZE);
+			memset(sbuf, 0, sizeof(sbuf));
+			for (int c=0; c<3; c++)
+			{
+				if (actch & (1 << (c * 2)))
+				{
+					ch[c].CalcBlock(cbuf, n);
+__DECL_VECTORIZED_LOOP
+					for (int i=0; i<n; i++)
+						sbuf[i] += cbuf[i];
+				}
+			}
+			for (int i=0; i<n; i++)
+			{
+				StoreSample(dest[0], IStoSampleL(sbuf[i]));
+				StoreSample(dest[1], IStoSampleR(sbuf[i]));
+				dest += 2;
+			}
+			nsamples -= n;
 		}
 	}
 #undef IStoSampleL
@@ -1255,6 +1267,13 @@ void OPNABase::Mix6(Sample* buffer, int nsamples, int activech)
 	idest[4] = &ibuf[pan[4]];
 	idest[5] = &ibuf[pan[5]];
 
+	if (!(activech & 0xaaa))
+	{
+		// without LFO, each channel is calculated by blocks of samples
+		Mix6Block(buffer, nsamples, activech);
+		return;
+	}
+
 	Sample* limit = buffer + nsamples * 2;
 	for (Sample* dest = buffer; dest < limit; dest+=2)
 	{
@@ -1268,6 +1287,36 @@ void OPNABase::Mix6(Sample* buffer, int nsamples, int activech)
 	}
 }
 
+void OPNABase::Mix6Block(Sample* buffer, int nsamples, int activech)
+{
+	ISample ibuf[4][FM_BLOCKSIZE];
+	ISample cbuf[FM_BLOCKSIZE];
+
+	while (nsamples > 0)
+	{
+		int n = Min(nsamples, FM_BLOCKSIZE);
+		memset(ibuf, 0, sizeof(ibuf));
+		for (int c=0; c<6; c++)
+		{
+			if (activech & (1 << (c * 2)))
+			{
+				ch[c].CalcBlock(cbuf, n);
+				ISample* dest = ibuf[pan[c]];
+__DECL_VECTORIZED_LOOP
+				for (int i=0; i<n; i++)
+					dest[i] += cbuf[i];
+			}
+		}
+		for (int i=0; i<n; i++)
+		{
+			StoreSample(buffer[i*2+0], IStoSampleL(ibuf[2][i] + ibuf[3][i]));
+			StoreSample(buffer[i*2+1], IStoSampleR(ibuf[1][i] + ibuf[3][i]));
+		}
+		buffer += n * 2;
+		nsamples -= n;
+	}
+}
+
 // ---------------------------------------------------------------------------
 //	Xe[gZ[u
 //
@@ -103,6 +103,8 @@ void MEMBUS::reset()
 	dcr1 = dcr2 = 0;
 	kj_l = kj_h = kj_ofs = kj_row = 0;
 	blinkcnt = 0;
+	screen_redraw = true;
+	txt_blink = false;
 	
 	// reset memory
 	mcr1 = 2;
@@ -250,9 +252,21 @@ void MEMBUS::update_bank()
 
 void MEMBUS::draw_screen()
 {
+	// redraw all lines when the screen mode is changed
+	// cursor address (lcdreg[14-15]) is checked in each row
+	if(screen_redraw || dcr1 != dcr1_copy || memcmp(lcdreg, lcdreg_copy, 14) != 0 || memcmp(lcdreg + 16, lcdreg_copy + 16, 16) != 0) {
+		memset(screen_txt, 0, sizeof(screen_txt));
+		memset(screen_cg, 0, sizeof(screen_cg));
+		for(int y = 0; y < 400; y++) {
+			txt_row_begin[y] = -1;
+		}
+		dcr1_copy = dcr1;
+		memcpy(lcdreg_copy, lcdreg, sizeof(lcdreg));
+		txt_caddr = -1;
+		screen_redraw = true;
+	}
+	
 	// render screen
-	memset(screen_txt, 0, sizeof(screen_txt));
-	memset(screen_cg, 0, sizeof(screen_cg));
 	if(dcr1 & 2) {
 		if(dcr1 & 8) {
 			draw_text40();
@@ -263,6 +277,7 @@ void MEMBUS::draw_screen()
 	if(dcr1 & 1) {
 		draw_cg();
 	}
+	screen_redraw = false;
 	
 	scrntype_t cd = RGB_COLOR(48, 56, 16);
 	scrntype_t cb = RGB_COLOR(160, 168, 160);
@@ -277,6 +292,29 @@ void MEMBUS::draw_screen()
 	}
 }
 
+bool MEMBUS::check_text_row(int y, int src, int caddr)
+{
+	// the row is redrawn when its address is moved, its vram is changed,
+	// or the cursor or blinking characters in it are changed
+	if(txt_row_begin[y] != src) {
+		return true;
+	}
+	if(txt_blink_changed && txt_row_blink[y]) {
+		return true;
+	}
+	bool cursor_moved = (caddr != txt_caddr);
+	
+	for(int i = src; i != txt_row_end[y]; i = (i + 1) & 0xfff) {
+		if(cvram[i] != cvram_copy[i] || kvram[i] != kvram_copy[i]) {
+			return true;
+		}
+		if(cursor_moved && (i == caddr || i == txt_caddr)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void MEMBUS::draw_text40()
 {
 	uint8_t *ank8 = ipl;
@@ -289,7 +327,19 @@ void MEMBUS::draw_text40()
 	int freq = (dcr1 >> 4) & 3;
 	bool blink = !((freq == 3) || (blinkcnt & (32 >> freq)));
 	
+	txt_blink_changed = (blink != txt_blink);
 	for(int y = 0; y < ymax; y++) {
+		// skip the row if nothing is changed
+		int begin = src;
+		if(!check_text_row(y, src, caddr)) {
+			src = txt_row_end[y];
+			continue;
+		}
+		for(int yy = y * yofs; yy < (y + 1) * yofs && yy < 400; yy++) {
+			memset(screen_txt[yy], 0, sizeof(screen_txt[yy]));
+		}
+		txt_row_blink[y] = 0;
+		
 		for(int x = 0; x < 40; x++) {
 			bool cursor = (src == caddr);
 			int cx = x;
@@ -371,8 +421,17 @@ void MEMBUS::draw_text40()
 					memset(&screen_txt[y * yofs + i][cx << 4], 7, 8);
 				}
 			}
+			if(cursor || (attr & 0x10)) {
+				txt_row_blink[y] = 1;
+			}
 		}
+		txt_row_begin[y] = begin;
+		txt_row_end[y] = src;
 	}
+	memcpy(cvram_copy, cvram, sizeof(cvram));
+	memcpy(kvram_copy, kvram, sizeof(kvram));
+	txt_caddr = caddr;
+	txt_blink = blink;
 }
 
 void MEMBUS::draw_text80()
@@ -387,7 +446,19 @@ void MEMBUS::draw_text80()
 	int freq = (dcr1 >> 4) & 3;
 	bool blink = !((freq == 3) || (blinkcnt & (32 >> freq)));
 	
+	txt_blink_changed = (blink != txt_blink);
 	for(int y = 0; y < ymax; y++) {
+		// skip the row if nothing is changed
+		int begin = src;
+		if(!check_text_row(y, src, caddr)) {
+			src = txt_row_end[y];
+			continue;
+		}
+		for(int yy = y * yofs; yy < (y + 1) * yofs && yy < 400; yy++) {
+			memset(screen_txt[yy], 0, sizeof(screen_txt[yy]));
+		}
+		txt_row_blink[y] = 0;
+		
 		for(int x = 0; x < 80; x++) {
 			bool cursor = (src == caddr);
 			int cx = x;
@@ -469,16 +540,31 @@ void MEMBUS::draw_text80()
 					memset(&screen_txt[y * yofs + i][cx << 3], 7, 8);
 				}
 			}
+			if(cursor || (attr & 0x10)) {
+				txt_row_blink[y] = 1;
+			}
 		}
+		txt_row_begin[y] = begin;
+		txt_row_end[y] = src;
 	}
+	memcpy(cvram_copy, cvram, sizeof(cvram));
+	memcpy(kvram_copy, kvram, sizeof(kvram));
+	txt_caddr = caddr;
+	txt_blink = blink;
 }
 
 void MEMBUS::draw_cg()
 {
 	uint8_t* plane = vram + ((dcr1 >> 8) & 3) * 0x8000;
-	int ptr = 0;
 	
 	for(int y = 0; y < 400; y++) {
+		// convert only the changed line
+		int ptr = y * 80;
+		if(!screen_redraw && memcmp(plane + ptr, vram_copy + ptr, 80) == 0) {
+			continue;
+		}
+		memcpy(vram_copy + ptr, plane + ptr, 80);
+		
 		for(int x = 0; x < 640; x += 8) {
 			uint8_t pat = plane[ptr++];
 			uint8_t* d = &screen_cg[y][x];
@@ -528,6 +614,7 @@ bool MEMBUS::process_state(FILEIO* state_fio, bool loading)
 	// post process
 	if(loading) {
 		update_bank();
+		screen_redraw = true;
 	}
 	return true;
 }
@@ -41,7 +41,21 @@ private:
 	uint8_t screen_txt[400][648];
 	uint8_t screen_cg[400][640];
 	
+	// vram is also written by the pseudo bios directly,
+	// so the changed lines are found by comparing with the copy of the last frame
+	uint8_t vram_copy[0x8000];
+	uint8_t cvram_copy[0x1000];
+	uint8_t kvram_copy[0x1000];
+	uint8_t lcdreg_copy[32];
+	uint16_t dcr1_copy;
+	bool screen_redraw;
+	int txt_row_begin[400], txt_row_end[400];
+	uint8_t txt_row_blink[400];
+	int txt_caddr;
+	bool txt_blink, txt_blink_changed;
+	
 	void update_bank();
+	bool check_text_row(int y, int src, int caddr);
 	void draw_text40();
 	void draw_text80();
 	void draw_cg();
@@ -105,6 +105,7 @@ void SUB::reset()
 	color_reg = 0x70;
 	hsync = wait = false;
 	cblink = 0;
+	screen_redraw = true;
 	
 	c15.in_b = ((pa & 0x40) != 0);
 	c15.in_c = ((pa & 0x80) != 0);
@@ -139,6 +140,7 @@ void SUB::write_data8(uint32_t addr, uint32_t data)
 				wait = true;
 			}
 			data = ~data;
+			vram_dirty[((addr - 0x2000) & 0x3fff) >> 4] = 1;
 		}
 		wbank[addr >> 7][addr & 0x7f] = data;
 		break;
@@ -190,6 +192,7 @@ void SUB::write_io8(uint32_t addr, uint32_t data)
 			memset(vram_b, (fore_color & 1) ? 0xff : 0, sizeof(vram_b));
 			memset(vram_r, (fore_color & 2) ? 0xff : 0, sizeof(vram_r));
 			memset(vram_g, (fore_color & 4) ? 0xff : 0, sizeof(vram_g));
+			screen_redraw = true;
 		}
 		// update crtc character clock
 		if(data & 8) {
@@ -377,6 +380,20 @@ void SUB::key_update()
 	}
 }
 
+bool SUB::check_row(uint16_t src, int cols, int cursor_addr, bool cursor_changed)
+{
+	for(int i = 0; i < cols; i++) {
+		if(vram_dirty[src >> 4]) {
+			return true;
+		}
+		if(cursor_changed && (src == cursor_addr || src == prev_cursor_addr)) {
+			return true;
+		}
+		src = (src + 8) & 0x3fff;
+	}
+	return false;
+}
+
 void SUB::draw_screen()
 {
 	// render screen
@@ -386,7 +403,24 @@ void SUB::draw_screen()
 	uint16_t src = ((regs[12] << 11) | (regs[13] << 3)) & 0x3fff;
 	uint16_t cursor = ((regs[14] << 11) | (regs[15] << 3)) & 0x3fff;
 	
-	memset(screen, 0, sizeof(screen));
+	// redraw all rows when the screen mode is changed
+	if(screen_redraw || memcmp(regs, regs_copy, sizeof(regs_copy)) != 0 || ((pa ^ pa_copy) & 0x1f)) {
+		memset(screen, 0, sizeof(screen));
+		memcpy(regs_copy, regs, sizeof(regs_copy));
+		pa_copy = pa;
+		screen_redraw = true;
+	}
+	
+	// rows with the cursor are redrawn when it is moved, blinked or its color is changed
+	int cursor_addr = -1;
+	if((regs[8] & 0xc0) != 0xc0) {
+		uint8_t bp = regs[10] & 0x60;
+		if(bp == 0 || (bp == 0x40 && (cblink & 8)) || (bp == 0x60 && (cblink & 0x10))) {
+			cursor_addr = cursor;
+		}
+	}
+	uint8_t cursor_color = (color_reg & 0x80) ? 7 : ((color_reg >> 4) & 7);
+	bool cursor_changed = (cursor_addr != prev_cursor_addr || (cursor_addr != -1 && cursor_color != prev_cursor_color));
 	
 //	emu->set_vm_screen_lines((ymax > 400) ? 400 : ymax);
 	
@@ -394,6 +428,11 @@ void SUB::draw_screen()
 		if(pa & 8) {
 			// 40 column
 			for(int y = 0; y < ymax && y < 400; y += lmax) {
+				// skip the row if nothing is changed
+				if(!screen_redraw && !check_row(src, 40, cursor_addr, cursor_changed)) {
+					src = (src + 40 * 8) & 0x3fff;
+					continue;
+				}
 				for(int x = 0; x < 640; x += 16) {
 					for(int l = 0; l < lmax; l++) {
 						uint16_t src2 = src | (l & 7);
@@ -443,6 +482,11 @@ void SUB::draw_screen()
 		} else {
 			// 80 column
 			for(int y = 0; y < ymax && y < 400; y += lmax) {
+				// skip the row if nothing is changed
+				if(!screen_redraw && !check_row(src, 80, cursor_addr, cursor_changed)) {
+					src = (src + 80 * 8) & 0x3fff;
+					continue;
+				}
 				for(int x = 0; x < 640; x += 8) {
 					for(int l = 0; l < lmax; l++) {
 						uint16_t src2 = src | (l & 7);
@@ -491,6 +535,10 @@ void SUB::draw_screen()
 			}
 		}
 	}
+	memset(vram_dirty, 0, sizeof(vram_dirty));
+	screen_redraw = false;
+	prev_cursor_addr = cursor_addr;
+	prev_cursor_color = cursor_color;
 	
 	// copy to real screen
 	if(ymax > 200) {
@@ -611,6 +659,11 @@ bool SUB::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(hsync);
 	state_fio->StateValue(wait);
 	state_fio->StateValue(cblink);
+	
+	// post process
+	if(loading) {
+		screen_redraw = true;
+	}
 	return true;
 }
 
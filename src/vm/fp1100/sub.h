@@ -170,7 +170,16 @@ private:
 	uint8_t screen[400][640];
 	scrntype_t palette_pc[8];
 	
+	// dirty flags per 16 bytes to redraw only the changed rows
+	uint8_t vram_dirty[0x4000 >> 4];
+	uint8_t regs_copy[14];
+	uint8_t pa_copy;
+	bool screen_redraw;
+	int prev_cursor_addr;
+	uint8_t prev_cursor_color;
+	
 	void key_update();
+	bool check_row(uint16_t src, int cols, int cursor_addr, bool cursor_changed);
 	
 public:
 	SUB(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
@@ -0,0 +1,117 @@
+/*
+	Skelton for retropc emulator
+
+	Author : agent
+	Date   : 2026.10.19-
+
+	[ glyph raster cache ]
+*/
+
+#ifndef _GLYPH_CACHE_H_
+#define _GLYPH_CACHE_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include "../common.h"
+
+// pixel rows of characters expanded from font rom/ram with their attributes.
+// the key is made from the font source, the character code (or the offset in the font),
+// the attribute bits that change the pixels, and the line in the cell.
+// each set has 4 ways and the least recently used way is replaced.
+// when pcg/font ram of a source is written, all rows of the source are invalidated.
+
+#define GLYPH_CACHE_WAYS	4
+#define GLYPH_CACHE_SOURCES	8
+
+static inline uint64_t glyph_key(int source, uint32_t code, uint32_t attr, int line)
+{
+	return ((uint64_t)(source & 7) << 61) | ((uint64_t)(attr & 0x1fffff) << 40) | ((uint64_t)(code & 0xffffff) << 16) | (uint64_t)(line & 0xffff);
+}
+
+class GLYPH_CACHE
+{
+private:
+	int width, mask;
+	uint64_t* keys;
+	uint32_t* stamps;	// last used time, 0 = empty
+	uint32_t* generations;
+	uint8_t* rows;
+	uint32_t generation[GLYPH_CACHE_SOURCES];
+	uint32_t time;
+
+	inline int get_set(uint64_t key)
+	{
+		return (int)((key * 0x9e3779b97f4a7c15ULL) >> 40) & mask;
+	}
+public:
+	// w = bytes of one row, s = number of sets
+	GLYPH_CACHE(int w, int s)
+	{
+		width = w;
+		for(mask = 1; mask < s; mask <<= 1);
+		keys = (uint64_t*)malloc(mask * GLYPH_CACHE_WAYS * sizeof(uint64_t));
+		stamps = (uint32_t*)malloc(mask * GLYPH_CACHE_WAYS * sizeof(uint32_t));
+		generations = (uint32_t*)malloc(mask * GLYPH_CACHE_WAYS * sizeof(uint32_t));
+		rows = (uint8_t*)malloc(mask * GLYPH_CACHE_WAYS * width);
+		mask--;
+		clear();
+	}
+	void release()
+	{
+		free(keys);
+		free(stamps);
+		free(generations);
+		free(rows);
+	}
+	void clear()
+	{
+		memset(stamps, 0, (mask + 1) * GLYPH_CACHE_WAYS * sizeof(uint32_t));
+		memset(generation, 0, sizeof(generation));
+		time = 0;
+	}
+	void invalidate(int source)
+	{
+		generation[source & 7]++;
+	}
+	// returns the cached row, or NULL if the row should be expanded by insert()
+	uint8_t* find(uint64_t key)
+	{
+		int index = get_set(key) * GLYPH_CACHE_WAYS;
+		uint32_t gen = generation[key >> 61];
+
+		for(int i = index; i < index + GLYPH_CACHE_WAYS; i++) {
+			if(stamps[i] != 0 && keys[i] == key && generations[i] == gen) {
+				if(++time == 0) {
+					// time is wrapped around
+					clear();
+					return NULL;
+				}
+				stamps[i] = time;
+				return rows + i * width;
+			}
+		}
+		return NULL;
+	}
+	// returns the row buffer for the key, the caller should fill it
+	uint8_t* insert(uint64_t key)
+	{
+		int index = get_set(key) * GLYPH_CACHE_WAYS;
+		int oldest = index;
+
+		for(int i = index + 1; i < index + GLYPH_CACHE_WAYS; i++) {
+			if(stamps[i] < stamps[oldest]) {
+				oldest = i;
+			}
+		}
+		if(++time == 0) {
+			clear();
+			time = 1;
+		}
+		keys[oldest] = key;
+		stamps[oldest] = time;
+		generations[oldest] = generation[key >> 61];
+		return rows + oldest * width;
+	}
+};
+
+#endif
@@ -10,17 +10,56 @@
 #include "harddisk.h"
 #include "../fileio.h"
 
+// copy-on-write overlay image
+/*
+	typedef struct hdo_header_s {
+		char sig[16];		// +  0
+		int32_t table_offset;	// + 16
+		int32_t data_offset;	// + 20
+		int32_t block_size;	// + 24
+		int32_t block_num;	// + 28
+		char base_path[480];	// + 32
+	} hdo_header_t;
+	
+	uint32_t table[block_num];	// 0 = not allocated, n = (n - 1)th block in data area
+*/
+#define OVERLAY_HEADER_SIZE	512
+#define OVERLAY_BLOCK_SIZE	0x10000
+
+static const char sig_hdo[16] = "CSPHDDOVERLAY.0";
+
 void HARDDISK::open(const _TCHAR* file_path, int default_sector_size)
+{
+	close();
+	
+	if(FILEIO::IsFileExisting(file_path)) {
+		if(check_file_extension(file_path, _T(".hdo"))) {
+			// the base image is opened as read only, and all writes go to the overlay
+			if(open_overlay(file_path)) {
+				open_image(base_path, default_sector_size, FILEIO_READ_BINARY);
+				if(mounted()) {
+					base_length = fio->FileLength();
+					if((base_length + overlay_block_size - 1) / overlay_block_size == overlay_block_num) {
+						return;
+					}
+				}
+			}
+			close();
+		} else {
+			open_image(file_path, default_sector_size, FILEIO_READ_WRITE_BINARY);
+		}
+	}
+}
+
+void HARDDISK::open_image(const _TCHAR* file_path, int default_sector_size, int mode)
 {
 	uint8_t header[512];
 	pair32_t tmp;
 	
-	close();
-	
 	if(FILEIO::IsFileExisting(file_path)) {
 		fio = new FILEIO();
 		
-		if(fio->Fopen(file_path, FILEIO_READ_WRITE_BINARY)) {
+		if(fio->Fopen(file_path, mode)) {
 			// from NP2 sxsihdd.c
 			const char sig_vhd[8] = "VHD1.00";
 			const char sig_nhd[15] = "T98HDDIMAGE.R0";
@@ -139,6 +178,57 @@ void HARDDISK::open(const _TCHAR* file_path, int default_sector_size)
 	}
 }
 
+bool HARDDISK::open_overlay(const _TCHAR* file_path)
+{
+	uint8_t header[OVERLAY_HEADER_SIZE];
+	pair32_t tmp;
+	
+	overlay_fio = new FILEIO();
+	
+	if(!overlay_fio->Fopen(file_path, FILEIO_READ_WRITE_BINARY)) {
+		return false;
+	}
+	if(overlay_fio->Fread(header, sizeof(header), 1) != 1 || memcmp(header, sig_hdo, 16) != 0) {
+		return false;
+	}
+	tmp.read_4bytes_le_from(header + 16);
+	overlay_table_offset = tmp.sd;
+	tmp.read_4bytes_le_from(header + 20);
+	overlay_data_offset = tmp.sd;
+	tmp.read_4bytes_le_from(header + 24);
+	overlay_block_size = tmp.sd;
+	tmp.read_4bytes_le_from(header + 28);
+	overlay_block_num = tmp.sd;
+	
+	if(overlay_block_size <= 0 || overlay_block_num <= 0) {
+		return false;
+	}
+	header[OVERLAY_HEADER_SIZE - 1] = 0;
+	const _TCHAR *path = char_to_tchar((char *)(header + 32));
+	
+	if(is_absolute_path(path)) {
+		my_tcscpy_s(base_path, _MAX_PATH, path);
+	} else {
+		// relative to the overlay image
+		my_stprintf_s(base_path, _MAX_PATH, _T("%s%s"), get_parent_dir(file_path), path);
+	}
+	
+	// load block table
+	overlay_table = (uint32_t *)calloc(overlay_block_num, sizeof(uint32_t));
+	overlay_block_used = 0;
+	
+	if(overlay_fio->Fseek(overlay_table_offset, FILEIO_SEEK_SET) != 0) {
+		return false;
+	}
+	for(int i = 0; i < overlay_block_num; i++) {
+		overlay_table[i] = overlay_fio->FgetUint32_LE();
+		if(overlay_block_used < overlay_table[i]) {
+			overlay_block_used = overlay_table[i];
+		}
+	}
+	return true;
+}
+
 void HARDDISK::close()
 {
 	// write disk image
@@ -149,6 +239,17 @@ void HARDDISK::close()
 		delete fio;
 		fio = NULL;
 	}
+	if(overlay_fio != NULL) {
+		if(overlay_fio->IsOpened()) {
+			overlay_fio->Fclose();
+		}
+		delete overlay_fio;
+		overlay_fio = NULL;
+	}
+	if(overlay_table != NULL) {
+		free(overlay_table);
+		overlay_table = NULL;
+	}
 }
 
 bool HARDDISK::mounted()
@@ -166,6 +267,10 @@ bool HARDDISK::accessed()
 bool HARDDISK::read_buffer(long position, int length, uint8_t *buffer)
 {
 	if(mounted()) {
+		if(overlay_fio != NULL) {
+			access = true;
+			return read_overlay(header_size + position, length, buffer);
+		}
 		if(fio->Fseek(header_size + position, FILEIO_SEEK_SET) == 0) {
 			access = true;
 			return (fio->Fread(buffer, length, 1) == 1);
@@ -177,6 +282,10 @@ bool HARDDISK::read_buffer(long position, int length, uint8_t *buffer)
 bool HARDDISK::write_buffer(long position, int length, uint8_t *buffer)
 {
 	if(mounted()) {
+		if(overlay_fio != NULL) {
+			access = true;
+			return write_overlay(header_size + position, length, buffer);
+		}
 		if(fio->Fseek(header_size + position, FILEIO_SEEK_SET) == 0) {
 			access = true;
 			return (fio->Fwrite(buffer, length, 1) == 1);
@@ -185,3 +294,216 @@ bool HARDDISK::write_buffer(long position, int length, uint8_t *buffer)
 	return false;
 }
 
+
+// copy-on-write overlay
+
+bool HARDDISK::read_overlay(long offset, int length, uint8_t *buffer)
+{
+	while(length > 0) {
+		int block = (int)(offset / overlay_block_size);
+		int block_offset = (int)(offset % overlay_block_size);
+		int count = min(length, overlay_block_size - block_offset);
+		
+		if(block >= overlay_block_num) {
+			return false;
+		}
+		if(overlay_table[block] != 0) {
+			if(overlay_fio->Fseek(overlay_data_offset + (long)(overlay_table[block] - 1) * overlay_block_size + block_offset, FILEIO_SEEK_SET) != 0) {
+				return false;
+			}
+			if(overlay_fio->Fread(buffer, count, 1) != 1) {
+				return false;
+			}
+		} else {
+			if(fio->Fseek(offset, FILEIO_SEEK_SET) != 0) {
+				return false;
+			}
+			if(fio->Fread(buffer, count, 1) != 1) {
+				return false;
+			}
+		}
+		offset += count;
+		buffer += count;
+		length -= count;
+	}
+	return true;
+}
+
+bool HARDDISK::write_overlay(long offset, int length, uint8_t *buffer)
+{
+	while(length > 0) {
+		int block = (int)(offset / overlay_block_size);
+		int block_offset = (int)(offset % overlay_block_size);
+		int count = min(length, overlay_block_size - block_offset);
+		
+		if(block >= overlay_block_num) {
+			return false;
+		}
+		if(overlay_table[block] == 0) {
+			if(!allocate_overlay_block(block)) {
+				return false;
+			}
+		}
+		if(overlay_fio->Fseek(overlay_data_offset + (long)(overlay_table[block] - 1) * overlay_block_size + block_offset, FILEIO_SEEK_SET) != 0) {
+			return false;
+		}
+		if(overlay_fio->Fwrite(buffer, count, 1) != 1) {
+			return false;
+		}
+		offset += count;
+		buffer += count;
+		length -= count;
+	}
+	return true;
+}
+
+bool HARDDISK::allocate_overlay_block(int block)
+{
+	// copy the whole block from the base image before it is modified
+	uint8_t *data = (uint8_t *)calloc(overlay_block_size, 1);
+	long offset = (long)block * overlay_block_size;
+	long count = base_length - offset;
+	
+	if(count > overlay_block_size) {
+		count = overlay_block_size;
+	}
+	bool result = false;
+	
+	if(count > 0 && fio->Fseek(offset, FILEIO_SEEK_SET) == 0) {
+		fio->Fread(data, count, 1);
+	}
+	if(overlay_fio->Fseek(overlay_data_offset + (long)overlay_block_used * overlay_block_size, FILEIO_SEEK_SET) == 0) {
+		if(overlay_fio->Fwrite(data, overlay_block_size, 1) == 1) {
+			// update block table after the data is written
+			if(overlay_fio->Fseek(overlay_table_offset + block * 4, FILEIO_SEEK_SET) == 0) {
+				overlay_fio->FputUint32_LE(++overlay_block_used);
+				overlay_table[block] = overlay_block_used;
+				result = true;
+			}
+		}
+	}
+	free(data);
+	return result;
+}
+
+bool HARDDISK::write_overlay_image(const _TCHAR* file_path, const _TCHAR* base_file_path, int block_size, int block_num)
+{
+	uint8_t header[OVERLAY_HEADER_SIZE];
+	pair32_t tmp;
+	bool result = false;
+	
+	memset(header, 0, sizeof(header));
+	memcpy(header, sig_hdo, 16);
+	tmp.sd = OVERLAY_HEADER_SIZE;
+	tmp.write_4bytes_le_to(header + 16);
+	tmp.sd = OVERLAY_HEADER_SIZE + block_num * 4;
+	tmp.write_4bytes_le_to(header + 20);
+	tmp.sd = block_size;
+	tmp.write_4bytes_le_to(header + 24);
+	tmp.sd = block_num;
+	tmp.write_4bytes_le_to(header + 28);
+	strncpy((char *)(header + 32), tchar_to_char(base_file_path), OVERLAY_HEADER_SIZE - 32 - 1);
+	
+	FILEIO *fio = new FILEIO();
+	if(fio->Fopen(file_path, FILEIO_WRITE_BINARY)) {
+		fio->Fwrite(header, sizeof(header), 1);
+		void *empty = calloc(block_num, 4);
+		fio->Fwrite(empty, 4, block_num);
+		free(empty);
+		fio->Fclose();
+		result = true;
+	}
+	delete fio;
+	return result;
+}
+
+bool HARDDISK::create_overlay(const _TCHAR* file_path, const _TCHAR* base_file_path)
+{
+	// the base image must be an existing hdi/nhd/thd/hdd or solid image
+	FILEIO *fio = new FILEIO();
+	long length = 0;
+	
+	if(fio->Fopen(base_file_path, FILEIO_READ_BINARY)) {
+		length = fio->FileLength();
+		fio->Fclose();
+	}
+	delete fio;
+	
+	if(length <= 0) {
+		return false;
+	}
+	return write_overlay_image(file_path, base_file_path, OVERLAY_BLOCK_SIZE, (int)((length + OVERLAY_BLOCK_SIZE - 1) / OVERLAY_BLOCK_SIZE));
+}
+
+bool HARDDISK::commit()
+{
+	// write all modified blocks back to the base image
+	if(!(mounted() && overlay_fio != NULL)) {
+		return false;
+	}
+	uint8_t *data = (uint8_t *)malloc(overlay_block_size);
+	bool result = true;
+	
+	fio->Fclose();
+	
+	if(fio->Fopen(base_path, FILEIO_READ_WRITE_BINARY)) {
+		for(int i = 0; i < overlay_block_num && result; i++) {
+			if(overlay_table[i] != 0) {
+				long offset = (long)i * overlay_block_size;
+				long count = base_length - offset;
+				if(count > overlay_block_size) {
+					count = overlay_block_size;
+				}
+				
+				result = false;
+				if(overlay_fio->Fseek(overlay_data_offset + (long)(overlay_table[i] - 1) * overlay_block_size, FILEIO_SEEK_SET) == 0 && overlay_fio->Fread(data, count, 1) == 1) {
+					if(fio->Fseek(offset, FILEIO_SEEK_SET) == 0 && fio->Fwrite(data, count, 1) == 1) {
+						result = true;
+					}
+				}
+			}
+		}
+		fio->Fclose();
+	} else {
+		result = false;
+	}
+	free(data);
+	
+	// the base image is read only again
+	fio->Fopen(base_path, FILEIO_READ_BINARY);
+	
+	if(result) {
+		result = discard();
+	}
+	return result;
+}
+
+bool HARDDISK::discard()
+{
+	// drop all modified blocks and restart from the base image
+	if(!(mounted() && overlay_fio != NULL)) {
+		return false;
+	}
+	_TCHAR file_path[_MAX_PATH];
+	_TCHAR base_file_path[_MAX_PATH];
+	
+	my_tcscpy_s(file_path, _MAX_PATH, overlay_fio->FilePath());
+	if(overlay_fio->Fseek(32, FILEIO_SEEK_SET) == 0) {
+		// keep the base image path as it was written (may be relative)
+		char tmp[OVERLAY_HEADER_SIZE - 32];
+		overlay_fio->Fread(tmp, sizeof(tmp), 1);
+		tmp[sizeof(tmp) - 1] = 0;
+		my_tcscpy_s(base_file_path, _MAX_PATH, char_to_tchar(tmp));
+	} else {
+		my_tcscpy_s(base_file_path, _MAX_PATH, base_path);
+	}
+	overlay_fio->Fclose();
+	
+	if(!write_overlay_image(file_path, base_file_path, overlay_block_size, overlay_block_num)) {
+		return false;
+	}
+	memset(overlay_table, 0, overlay_block_num * sizeof(uint32_t));
+	overlay_block_used = 0;
+	
+	return overlay_fio->Fopen(file_path, FILEIO_READ_WRITE_BINARY);
+}
@@ -23,10 +23,30 @@ private:
 	FILEIO *fio;
 	int header_size;
 	
+	// copy-on-write overlay
+	FILEIO *overlay_fio;
+	_TCHAR base_path[_MAX_PATH];
+	uint32_t *overlay_table;
+	int overlay_block_size;
+	int overlay_block_num;
+	uint32_t overlay_block_used;
+	long overlay_table_offset;
+	long overlay_data_offset;
+	long base_length;
+	
+	void open_image(const _TCHAR* file_path, int default_sector_size, int mode);
+	bool open_overlay(const _TCHAR* file_path);
+	bool read_overlay(long offset, int length, uint8_t *buffer);
+	bool write_overlay(long offset, int length, uint8_t *buffer);
+	bool allocate_overlay_block(int block);
+	static bool write_overlay_image(const _TCHAR* file_path, const _TCHAR* base_file_path, int block_size, int block_num);
+	
 public:
 	HARDDISK(EMU* parent_emu) : emu(parent_emu)
 	{
 		fio = NULL;
+		overlay_fio = NULL;
+		overlay_table = NULL;
 		access = false;
 		static int num = 0;
 		drive_num = num++;
@@ -44,6 +64,15 @@ public:
 	bool read_buffer(long position, int length, uint8_t *buffer);
 	bool write_buffer(long position, int length, uint8_t *buffer);
 	
+	// copy-on-write overlay
+	static bool create_overlay(const _TCHAR* file_path, const _TCHAR* base_file_path);
+	bool is_overlay()
+	{
+		return (overlay_fio != NULL);
+	}
+	bool commit();
+	bool discard();
+	
 //	int cylinders;
 	int surfaces;
 	int sectors;
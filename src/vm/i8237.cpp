@@ -30,6 +30,7 @@ void I8237::reset()
 	cmd = req = tc = 0;
 	mask = 0xff;
 	running = false;
+	now_dma = rescan_dma = false;
 }
 
 void I8237::write_io8(uint32_t addr, uint32_t data)
@@ -184,78 +185,91 @@ uint32_t I8237::read_signal(int id)
 
 void I8237::do_dma()
 {
-	for(int ch = 0; ch < 4; ch++) {
-		uint8_t bit = 1 << ch;
-		if((req & bit) && !(mask & bit)) {
-			// execute dma
-			while(req & bit) {
-				int wait = 0, wait_r = 0, wait_w = 0;
-				bool compressed = ((cmd & 0x09) == 0x08);
-				bool exptended = ((cmd & 0x20) == 0x20) && !compressed;
-				
-				if(!running) {
-					wait += 2; // S0
-					running = true;
-				}
-				switch(dma[ch].mode & 0x0c) {
-				case 0x00:
-					// verify
-					tmp = read_io(ch, &wait_r);
-					wait += compressed ? 5 : 7;
-					break;
-				case 0x04:
-					// io -> memory
-					tmp = read_io(ch, &wait_r);
-					write_mem(dma[ch].areg | (dma[ch].bankreg << 16), tmp, &wait_w);
-					wait += compressed ? 5 : 7;
-					if(exptended) wait += wait_r + wait_w;
-					break;
-				case 0x08:
-					// memory -> io
-					tmp = read_mem(dma[ch].areg | (dma[ch].bankreg << 16), &wait_r);
-					write_io(ch, tmp, &wait_w);
-					wait += compressed ? 5 : 7;
-					if(exptended) wait += wait_r + wait_w;
-					break;
-				}
-				if(d_cpu != NULL) d_cpu->set_extra_clock(wait);
-				
-				if(dma[ch].mode & 0x20) {
-					dma[ch].areg--;
-					if(dma[ch].areg == 0xffff) {
-						dma[ch].bankreg = (dma[ch].bankreg & ~dma[ch].incmask) | ((dma[ch].bankreg - 1) & dma[ch].incmask);
+	// the device may raise the request again while the transfer is running (scsi burst transfer)
+	// in this case the channels are scanned again after the current transfer
+	if(now_dma) {
+		rescan_dma = true;
+		return;
+	}
+	now_dma = true;
+	
+	do {
+		rescan_dma = false;
+		for(int ch = 0; ch < 4; ch++) {
+			uint8_t bit = 1 << ch;
+			if((req & bit) && !(mask & bit)) {
+				// execute dma
+				while(req & bit) {
+					int wait = 0, wait_r = 0, wait_w = 0;
+					bool compressed = ((cmd & 0x09) == 0x08);
+					bool exptended = ((cmd & 0x20) == 0x20) && !compressed;
+					
+					if(!running) {
+						wait += 2; // S0
+						running = true;
 					}
-				} else {
-					dma[ch].areg++;
-					if(dma[ch].areg == 0) {
-						dma[ch].bankreg = (dma[ch].bankreg & ~dma[ch].incmask) | ((dma[ch].bankreg + 1) & dma[ch].incmask);
+					switch(dma[ch].mode & 0x0c) {
+					case 0x00:
+						// verify
+						tmp = read_io(ch, &wait_r);
+						wait += compressed ? 5 : 7;
+						break;
+					case 0x04:
+						// io -> memory
+						tmp = read_io(ch, &wait_r);
+						write_mem(dma[ch].areg | (dma[ch].bankreg << 16), tmp, &wait_w);
+						wait += compressed ? 5 : 7;
+						if(exptended) wait += wait_r + wait_w;
+						break;
+					case 0x08:
+						// memory -> io
+						tmp = read_mem(dma[ch].areg | (dma[ch].bankreg << 16), &wait_r);
+						write_io(ch, tmp, &wait_w);
+						wait += compressed ? 5 : 7;
+						if(exptended) wait += wait_r + wait_w;
+						break;
 					}
-				}
-				
-				// check dma condition
-				if(dma[ch].creg-- == 0) {
-					// TC
-					if(dma[ch].mode & 0x10) {
-						// self initialize
-						dma[ch].areg = dma[ch].bareg;
-						dma[ch].creg = dma[ch].bcreg;
+					if(d_cpu != NULL) d_cpu->set_extra_clock(wait);
+					
+					if(dma[ch].mode & 0x20) {
+						dma[ch].areg--;
+						if(dma[ch].areg == 0xffff) {
+							dma[ch].bankreg = (dma[ch].bankreg & ~dma[ch].incmask) | ((dma[ch].bankreg - 1) & dma[ch].incmask);
+						}
 					} else {
-						mask |= bit;
+						dma[ch].areg++;
+						if(dma[ch].areg == 0) {
+							dma[ch].bankreg = (dma[ch].bankreg & ~dma[ch].incmask) | ((dma[ch].bankreg + 1) & dma[ch].incmask);
+						}
 					}
-					req &= ~bit;
-					tc |= bit;
-					running = false;
-					write_signals(&dma[ch].outputs_tc, 0xffffffff);
-				} else if((dma[ch].mode & 0xc0) == 0x40) {
-					// single mode
-					running = false;
+					
+					// check dma condition
+					if(dma[ch].creg-- == 0) {
+						// TC
+						if(dma[ch].mode & 0x10) {
+							// self initialize
+							dma[ch].areg = dma[ch].bareg;
+							dma[ch].creg = dma[ch].bcreg;
+						} else {
+							mask |= bit;
+						}
+						req &= ~bit;
+						tc |= bit;
+						running = false;
+						write_signals(&dma[ch].outputs_tc, 0xffffffff);
+					} else if((dma[ch].mode & 0xc0) == 0x40) {
+						// single mode
+						running = false;
 #ifdef SINGLE_MODE_DMA
-					break;
+						break;
 #endif
+					}
 				}
 			}
 		}
-	}
+	} while(rescan_dma);
+	now_dma = false;
+	
 #ifdef SINGLE_MODE_DMA
 	if(d_dma) {
 		d_dma->do_dma();
@@ -67,6 +67,7 @@ private:
 	bool mode_word;
 	uint32_t addr_mask;
 	bool running;
+	bool now_dma, rescan_dma;
 	
 	void write_mem(uint32_t addr, uint32_t data, int *wait);
 	uint32_t read_mem(uint32_t addr, int *wait);
@@ -38,8 +38,8 @@
 
 void I8251::initialize()
 {
-	recv_buffer = new FIFO(BUFFER_SIZE);
-	send_buffer = new FIFO(4);
+	recv_buffer = new RING_BUFFER<int16_t>(BUFFER_SIZE);
+	send_buffer = new RING_BUFFER<uint8_t>(4);
 	status = TXRDY | TXE;
 }
 
@@ -20,7 +20,7 @@
 #define SIG_I8251_CLEAR		3
 #define SIG_I8251_LOOPBACK	4
 
-class FIFO;
+template <class T> class RING_BUFFER;
 
 class I8251 : public DEVICE
 {
@@ -40,8 +40,8 @@ private:
 	outputs_t outputs_rts;
 	
 	// buffer
-	FIFO *recv_buffer;
-	FIFO *send_buffer;
+	RING_BUFFER<int16_t> *recv_buffer;
+	RING_BUFFER<uint8_t> *send_buffer;
 	int recv_id, send_id;
 	
 public:
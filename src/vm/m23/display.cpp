@@ -320,6 +320,7 @@ void DISPLAY::initialize()
 	
 	// initialize
 	vd_control = 1;
+	screen_redraw = true;
 	
 	// register event
 	register_frame_event(this);
@@ -355,7 +356,14 @@ void DISPLAY::event_frame()
 
 void DISPLAY::draw_screen()
 {
-	memset(screen, (vd_control >> 4) & 7, sizeof(screen));
+	// redraw all rows when the screen mode is changed
+	if(screen_redraw || memcmp(regs, regs_copy, sizeof(regs_copy)) != 0 || vd_control != vd_control_copy) {
+		memset(screen, (vd_control >> 4) & 7, sizeof(screen));
+		memcpy(regs_copy, regs, sizeof(regs_copy));
+		vd_control_copy = vd_control;
+		prev_cursor_addr = -1;
+		screen_redraw = true;
+	}
 	
 	if((regs[8] & 0x30) != 0x30 && (vd_control & 1) != 0) {
 		if(vd_control & 4) {
@@ -364,6 +372,7 @@ void DISPLAY::draw_screen()
 			draw_text();
 		}
 	}
+	screen_redraw = false;
 	
 	// copy to real screen
 	emu->set_vm_screen_lines(200);
@@ -398,12 +407,35 @@ void DISPLAY::draw_text()
 	int cursor = -1;
 	
 	if((regs[8] & 0xc0) != 0xc0) {
-		cursor = ((regs[14] << 8) | regs[15]) & 0x7ff;
+		if(bp == 0 || (bp == 0x40 && (cblink & 8)) || (bp == 0x60 && (cblink & 0x10))) {
+			cursor = ((regs[14] << 8) | regs[15]) & 0x7ff;
+		}
 	}
 	for(int y = 0; y < vt; y++) {
+		// skip the row if its vram and cursor are not changed
+		bool changed = screen_redraw;
+		for(int x = 0; x < hz && !changed; x++) {
+			uint16_t addr = (src + x) & 0x7ff;
+			if(vram_t[addr] != prev_vram_t[addr] || vram_a[addr] != prev_vram_a[addr]) {
+				changed = true;
+			} else if(cursor != prev_cursor_addr && (addr == cursor || addr == prev_cursor_addr)) {
+				changed = true;
+			}
+		}
+		if(!changed) {
+			src = (src + hz) & 0x7ff;
+			continue;
+		}
+		for(int l = 0; l < ht; l++) {
+			int yy = y * ht + l;
+			if(yy >= 200) {
+				break;
+			}
+			memset(screen[yy], (vd_control >> 4) & 7, sizeof(screen[yy]));
+		}
 		for(int x = 0; x < hz; x++) {
-			uint8_t code = vram_t[src];
-			uint8_t attr = vram_a[src];
+			uint8_t code = prev_vram_t[src] = vram_t[src];
+			uint8_t attr = prev_vram_a[src] = vram_a[src];
 			
 			// check attribute
 			bool reverse = ((attr & 0x01) != 0);
@@ -439,18 +471,17 @@ void DISPLAY::draw_text()
 			if(src == cursor) {
 				int s = regs[10] & 0x1f;
 				int e = regs[11] & 0x1f;
-				if(bp == 0 || (bp == 0x40 && (cblink & 8)) || (bp == 0x60 && (cblink & 0x10))) {
-					for(int l = s; l <= e && l < ht; l++) {
-						int yy = y * ht + l;
-						if(yy < 200) {
-							memset(&screen[yy][x << 3], 7, 8);
-						}
+				for(int l = s; l <= e && l < ht; l++) {
+					int yy = y * ht + l;
+					if(yy < 200) {
+						memset(&screen[yy][x << 3], 7, 8);
 					}
 				}
 			}
 			src = (src + 1) & 0x7ff;
 		}
 	}
+	prev_cursor_addr = cursor;
 }
 
 #define STATE_VERSION	1
@@ -469,6 +500,11 @@ bool DISPLAY::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(display);
 	state_fio->StateValue(blink);
 	state_fio->StateValue(vd_control);
+	
+	// post process
+	if(loading) {
+		screen_redraw = true;
+	}
 	return true;
 }
 
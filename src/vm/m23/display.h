@@ -29,6 +29,14 @@ private:
 	uint8_t* vram_a;
 	scrntype_t palette_pc[8];
 	
+	// vram is in membus, so compare with the copy to redraw only the changed rows
+	uint8_t prev_vram_t[0x800];
+	uint8_t prev_vram_a[0x800];
+	uint8_t regs_copy[14];
+	uint8_t vd_control_copy;
+	int prev_cursor_addr;
+	bool screen_redraw;
+	
 	void draw_text();
 	
 public:
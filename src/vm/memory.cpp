@@ -329,6 +329,53 @@ void MEMORY::write_data16w(uint32_t addr, uint32_t data, int* wait)
 	}
 }
 
+int MEMORY::get_data16w_run(uint32_t addr, int step, int count, int* wait)
+{
+	uint32_t addr2 = addr & BANK_MASK;
+	
+	if(bus_width < 16 || (addr & 1) || (step != 2 && step != -2) || count < 1) {
+		return 0;
+	}
+	int bank = get_bank(addr);
+	
+	if(wr_table[bank].device != NULL) {
+		int wait_tmp = 0;
+		if((count = wr_table[bank].device->get_memory_mapped_io16_run(addr, step, count, &wait_tmp)) < 1) {
+			return 0;
+		}
+		*wait = wr_table[bank].wait_registered ? wr_table[bank].wait * bus_access_times_16(addr2) : wait_tmp;
+	} else {
+		*wait = wr_table[bank].wait * bus_access_times_16(addr2);
+	}
+	
+	// the run should be in this bank
+	if(step > 0) {
+		return min(count, (int)((bank_size - addr2) >> 1));
+	} else {
+		return min(count, (int)(addr2 >> 1) + 1);
+	}
+}
+
+void MEMORY::write_data16w_run(uint32_t addr, int step, uint32_t data, int count)
+{
+	int bank = get_bank(addr);
+	
+	if(wr_table[bank].device != NULL) {
+		wr_table[bank].device->write_memory_mapped_io16_run(addr, step, data, count);
+	} else {
+		uint8_t *p = wr_table[bank].memory + (addr & BANK_MASK);
+		
+		for(int i = 0; i < count; i++, p += step) {
+			#ifdef __BIG_ENDIAN__
+				p[0] = (data     ) & 0xff;
+				p[1] = (data >> 8) & 0xff;
+			#else
+				*(uint16_t *)p = data;
+			#endif
+		}
+	}
+}
+
 uint32_t MEMORY::read_data32w(uint32_t addr, int* wait)
 {
 	uint32_t addr2 = addr & BANK_MASK;
@@ -58,6 +58,8 @@ public:
 	void write_data8w(uint32_t addr, uint32_t data, int* wait);
 	uint32_t read_data16w(uint32_t addr, int* wait);
 	void write_data16w(uint32_t addr, uint32_t data, int* wait);
+	int get_data16w_run(uint32_t addr, int step, int count, int* wait);
+	void write_data16w_run(uint32_t addr, int step, uint32_t data, int count);
 	uint32_t read_data32w(uint32_t addr, int* wait);
 	void write_data32w(uint32_t addr, uint32_t data, int* wait);
 	
@@ -46,6 +46,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "scc.h"
+#include "../vgm_logger.h"
 
 #define SCC EMU2212
 
@@ -508,8 +509,45 @@ SCC::SCC(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu
 	set_device_name(_T("SCC"));
 }
 
+void SCC::log_reg(int port, uint32_t addr, uint32_t data)
+{
+	VGM_LOGGER* logger = emu->get_vgm_logger();
+	uint32_t clock = get_current_clock(), clocks_per_sec = get_event_clocks();
+	
+	// clock of k051649 in vgm is half of the clock of emu2212
+	if(!logger->is_registered(this)) {
+		// log the current wave tables, frequencies, volumes and channel mask
+		for(int i = 0; i < 0x80; i++) {
+			logger->write(VGM_K051649, this, emu2212->clk / 2, clock, clocks_per_sec, 0, i, (uint8_t)emu2212->wave[i >> 5][i & 0x1f]);
+		}
+		for(int i = 0; i < 10; i++) {
+			logger->write(VGM_K051649, this, emu2212->clk / 2, clock, clocks_per_sec, 1, i, emu2212->reg[i]);
+		}
+		for(int i = 0; i < 5; i++) {
+			logger->write(VGM_K051649, this, emu2212->clk / 2, clock, clocks_per_sec, 2, i, emu2212->reg[0x10 + i]);
+		}
+		logger->write(VGM_K051649, this, emu2212->clk / 2, clock, clocks_per_sec, 3, 0, emu2212->reg[0x21]);
+	}
+	logger->write(VGM_K051649, this, emu2212->clk / 2, clock, clocks_per_sec, port, addr, data);
+}
+
 void SCC::write_data8(uint32_t addr, uint32_t data)
 {
+	if(emu->get_vgm_logger() != NULL && emu2212->active && !emu2212->mode && addr >= emu2212->base_adr + 0x800 && addr <= emu2212->base_adr + 0x8ff) {
+		// registers of scc (standard mode) are logged in the port map of k051649
+		uint32_t offset = addr & 0xff;
+		if(offset < 0x80) {
+			log_reg(0, offset, data & 0xff);
+		} else if(offset < 0x8a) {
+			log_reg(1, offset - 0x80, data & 0xff);
+		} else if(offset < 0x8f) {
+			log_reg(2, offset - 0x8a, data & 0xff);
+		} else if(offset == 0x8f) {
+			log_reg(3, 0, data & 0xff);
+		} else if(offset >= 0xe0) {
+			log_reg(5, 0, data & 0xff);
+		}
+	}
 	SCC_write(emu2212, addr, data);
 }
 
@@ -81,6 +81,7 @@ private:
 	EMU2212 *emu2212;
 	int volume_l, volume_r;
 	void save_load_state(FILEIO* state_fio, bool is_save);
+	void log_reg(int port, uint32_t addr, uint32_t data);
 
 public:
 	SCC(VM_TEMPLATE* parent_vm, EMU* parent_emu);
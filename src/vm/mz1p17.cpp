@@ -217,7 +217,7 @@ void MZ1P17::initialize()
 	delete fio;
 	
 	fifo = new FIFO(65536);
-	line_printed = paper_printed = false;
+	line_printed = paper_printed = paper_colored = false;
 	paper_index = written_length = 0;
 	
 	value = busy_id = ack_id = wait_frames = -1;
@@ -252,8 +252,8 @@ void MZ1P17::reset()
 {
 	finish();
 	
-	emu->clear_bitmap(&bitmap_paper, 255, 255, 255);
-	emu->clear_bitmap(&bitmap_line[0], 0, 0, 0);
+	clear_bitmap(&bitmap_paper, 255);
+	clear_bitmap(&bitmap_line[0], 0);
 	
 	memset(gaiji, 0, sizeof(gaiji));
 	memset(htab, 0, sizeof(htab));
@@ -278,7 +278,7 @@ void MZ1P17::reset()
 	dest_line_x = dest_paper_y = 0;
 	color_mode = 0;
 	double_y_printed = false;
-	line_printed = paper_printed = false;
+	line_printed = paper_printed = paper_colored = false;
 	paper_index = written_length = 0;
 	
 	busy_id = ack_id = wait_frames = -1;
@@ -501,9 +501,9 @@ void MZ1P17::process_mz1()
 				break;
 			case 0x19:
 				// ESC EM
-				emu->clear_bitmap(&bitmap_line[1], 0, 0, 0);
-				emu->clear_bitmap(&bitmap_line[2], 0, 0, 0);
-				emu->clear_bitmap(&bitmap_line[3], 0, 0, 0);
+				clear_bitmap(&bitmap_line[1], 0);
+				clear_bitmap(&bitmap_line[2], 0);
+				clear_bitmap(&bitmap_line[3], 0);
 				color_mode = 3;
 				fifo->clear();
 				break;
@@ -545,36 +545,36 @@ void MZ1P17::process_mz1()
 								for(int i = 0; i < n; i++) {
 									if(dest_line_x < 1440 * DOT_SCALE) {
 										if(reverse) {
-											emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, DOT_SCALE, 48 * DOT_SCALE, 255, 255, 255);
+											fill_rect(dest_line_x, 0, DOT_SCALE, 48 * DOT_SCALE, 255);
 											c = 0;
 										}
 										d1 = fifo->read_not_remove(5 + i * 3 + 0);
 										d2 = fifo->read_not_remove(5 + i * 3 + 1);
 										d3 = fifo->read_not_remove(5 + i * 3 + 2);
-										if(d1 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  0) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  2) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  3) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  4) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  5) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  6) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  7) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  8) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  9) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 10) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 11) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 12) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 13) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 14) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 15) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 16) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 17) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 18) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 19) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 20) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 21) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 22) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 23) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
+										if(d1 & 0x80) fill_rect(dest_line_x, (24 +  0) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x40) fill_rect(dest_line_x, (24 +  1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x20) fill_rect(dest_line_x, (24 +  2) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x10) fill_rect(dest_line_x, (24 +  3) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x08) fill_rect(dest_line_x, (24 +  4) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x04) fill_rect(dest_line_x, (24 +  5) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x02) fill_rect(dest_line_x, (24 +  6) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x01) fill_rect(dest_line_x, (24 +  7) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x80) fill_rect(dest_line_x, (24 +  8) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x40) fill_rect(dest_line_x, (24 +  9) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x20) fill_rect(dest_line_x, (24 + 10) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x10) fill_rect(dest_line_x, (24 + 11) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x08) fill_rect(dest_line_x, (24 + 12) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x04) fill_rect(dest_line_x, (24 + 13) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x02) fill_rect(dest_line_x, (24 + 14) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x01) fill_rect(dest_line_x, (24 + 15) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x80) fill_rect(dest_line_x, (24 + 16) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x40) fill_rect(dest_line_x, (24 + 17) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x20) fill_rect(dest_line_x, (24 + 18) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x10) fill_rect(dest_line_x, (24 + 19) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x08) fill_rect(dest_line_x, (24 + 20) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x04) fill_rect(dest_line_x, (24 + 21) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x02) fill_rect(dest_line_x, (24 + 22) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x01) fill_rect(dest_line_x, (24 + 23) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
 										dest_line_x += DOT_SCALE;
 										line_printed = true;
 									}
@@ -591,36 +591,36 @@ void MZ1P17::process_mz1()
 								for(int i = 0; i < n; i++) {
 									if(dest_line_x < 1440 * DOT_SCALE) {
 										if(reverse) {
-											emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255, 255, 255);
+											fill_rect(dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255);
 											c = 0;
 										}
 										d1 = fifo->read_not_remove(5 + i * 3 + 0);
 										d2 = fifo->read_not_remove(5 + i * 3 + 1);
 										d3 = fifo->read_not_remove(5 + i * 3 + 2);
-										if(d1 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  0) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  1) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  2) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  3) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  4) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  5) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  6) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  7) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  8) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  9) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 10) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 11) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 12) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 13) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 14) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 15) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 16) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 17) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 18) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 19) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 20) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 21) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 22) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 23) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
+										if(d1 & 0x80) fill_rect(dest_line_x, (24 +  0) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x40) fill_rect(dest_line_x, (24 +  1) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x20) fill_rect(dest_line_x, (24 +  2) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x10) fill_rect(dest_line_x, (24 +  3) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x08) fill_rect(dest_line_x, (24 +  4) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x04) fill_rect(dest_line_x, (24 +  5) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x02) fill_rect(dest_line_x, (24 +  6) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x01) fill_rect(dest_line_x, (24 +  7) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x80) fill_rect(dest_line_x, (24 +  8) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x40) fill_rect(dest_line_x, (24 +  9) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x20) fill_rect(dest_line_x, (24 + 10) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x10) fill_rect(dest_line_x, (24 + 11) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x08) fill_rect(dest_line_x, (24 + 12) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x04) fill_rect(dest_line_x, (24 + 13) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x02) fill_rect(dest_line_x, (24 + 14) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x01) fill_rect(dest_line_x, (24 + 15) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x80) fill_rect(dest_line_x, (24 + 16) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x40) fill_rect(dest_line_x, (24 + 17) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x20) fill_rect(dest_line_x, (24 + 18) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x10) fill_rect(dest_line_x, (24 + 19) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x08) fill_rect(dest_line_x, (24 + 20) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x04) fill_rect(dest_line_x, (24 + 21) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x02) fill_rect(dest_line_x, (24 + 22) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x01) fill_rect(dest_line_x, (24 + 23) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
 										dest_line_x += 2 * DOT_SCALE;
 										line_printed = true;
 									}
@@ -636,10 +636,10 @@ void MZ1P17::process_mz1()
 							for(int i = 0; i < n; i++) {
 								if(dest_line_x < margin_right) {
 									if(reverse) {
-										emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, DOT_SCALE, bitmap_line[color_mode].height, 255, 255, 255);
+										fill_rect(dest_line_x, 0, DOT_SCALE, bitmap_line[color_mode].height, 255);
 									}
 									if(underline) {
-										emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (48 + 1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, 255, 255, 255);
+										fill_rect(dest_line_x, (48 + 1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, 255);
 									}
 									dest_line_x += DOT_SCALE;
 									line_printed = true;
@@ -840,18 +840,18 @@ void MZ1P17::process_mz1()
 						for(int i = 0; i < n; i++) {
 							if(dest_line_x < 1280 * DOT_SCALE) {
 								if(reverse) {
-									emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255, 255, 255);
+									fill_rect(dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255);
 									c = 0;
 								}
 								d = fifo->read_not_remove(4 + i);
-								if(d & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 0) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 1) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 2) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 3) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 4) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 5) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 6) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 7) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
+								if(d & 0x01) fill_rect(dest_line_x, (24 + 3 * 0) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x02) fill_rect(dest_line_x, (24 + 3 * 1) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x04) fill_rect(dest_line_x, (24 + 3 * 2) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x08) fill_rect(dest_line_x, (24 + 3 * 3) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x10) fill_rect(dest_line_x, (24 + 3 * 4) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x20) fill_rect(dest_line_x, (24 + 3 * 5) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x40) fill_rect(dest_line_x, (24 + 3 * 6) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x80) fill_rect(dest_line_x, (24 + 3 * 7) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
 								dest_line_x += 2 * DOT_SCALE;
 								line_printed = true;
 							}
@@ -1182,18 +1182,18 @@ void MZ1P17::process_mz2()
 						for(int i = 0; i < p; i++) {
 							if(dest_line_x < 1440 * DOT_SCALE) {
 								if(reverse) {
-									emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, width, 48 * DOT_SCALE, 255, 255, 255);
+									fill_rect(dest_line_x, 0, width, 48 * DOT_SCALE, 255);
 									c = 0;
 								}
 								d = fifo->read_not_remove(6 + i);
-								if(d & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 0) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 1) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 2) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 3) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 4) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 5) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 6) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 7) * DOT_SCALE, width, height, c, c, c);
+								if(d & 0x01) fill_rect(dest_line_x, (24 + 3 * 0) * DOT_SCALE, width, height, c);
+								if(d & 0x02) fill_rect(dest_line_x, (24 + 3 * 1) * DOT_SCALE, width, height, c);
+								if(d & 0x04) fill_rect(dest_line_x, (24 + 3 * 2) * DOT_SCALE, width, height, c);
+								if(d & 0x08) fill_rect(dest_line_x, (24 + 3 * 3) * DOT_SCALE, width, height, c);
+								if(d & 0x10) fill_rect(dest_line_x, (24 + 3 * 4) * DOT_SCALE, width, height, c);
+								if(d & 0x20) fill_rect(dest_line_x, (24 + 3 * 5) * DOT_SCALE, width, height, c);
+								if(d & 0x40) fill_rect(dest_line_x, (24 + 3 * 6) * DOT_SCALE, width, height, c);
+								if(d & 0x80) fill_rect(dest_line_x, (24 + 3 * 7) * DOT_SCALE, width, height, c);
 								dest_line_x += width;
 								line_printed = true;
 							}
@@ -1267,9 +1267,9 @@ void MZ1P17::process_mz2()
 			switch(fifo->read_not_remove(1)) {
 			case 0x04:
 				// ESC 04
-				emu->clear_bitmap(&bitmap_line[1], 0, 0, 0);
-				emu->clear_bitmap(&bitmap_line[2], 0, 0, 0);
-				emu->clear_bitmap(&bitmap_line[3], 0, 0, 0);
+				clear_bitmap(&bitmap_line[1], 0);
+				clear_bitmap(&bitmap_line[2], 0);
+				clear_bitmap(&bitmap_line[3], 0);
 				color_mode = 3;
 				fifo->clear();
 				break;
@@ -1323,18 +1323,18 @@ void MZ1P17::process_mz2()
 						for(int i = 0; i < n; i++) {
 							if(dest_line_x < 1440 * DOT_SCALE) {
 								if(reverse) {
-									emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, width, 48 * DOT_SCALE, 255, 255, 255);
+									fill_rect(dest_line_x, 0, width, 48 * DOT_SCALE, 255);
 									c = 0;
 								}
 								d = fifo->read_not_remove(4 + i);
-								if(d & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 0) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 1) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 2) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 3) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 4) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 5) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 6) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 7) * DOT_SCALE, width, height, c, c, c);
+								if(d & 0x01) fill_rect(dest_line_x, (24 + 3 * 0) * DOT_SCALE, width, height, c);
+								if(d & 0x02) fill_rect(dest_line_x, (24 + 3 * 1) * DOT_SCALE, width, height, c);
+								if(d & 0x04) fill_rect(dest_line_x, (24 + 3 * 2) * DOT_SCALE, width, height, c);
+								if(d & 0x08) fill_rect(dest_line_x, (24 + 3 * 3) * DOT_SCALE, width, height, c);
+								if(d & 0x10) fill_rect(dest_line_x, (24 + 3 * 4) * DOT_SCALE, width, height, c);
+								if(d & 0x20) fill_rect(dest_line_x, (24 + 3 * 5) * DOT_SCALE, width, height, c);
+								if(d & 0x40) fill_rect(dest_line_x, (24 + 3 * 6) * DOT_SCALE, width, height, c);
+								if(d & 0x80) fill_rect(dest_line_x, (24 + 3 * 7) * DOT_SCALE, width, height, c);
 								dest_line_x += width;
 								line_printed = true;
 							}
@@ -1390,36 +1390,36 @@ void MZ1P17::process_mz2()
 								for(int i = 0; i < n; i++) {
 									if(dest_line_x < 1440 * DOT_SCALE) {
 										if(reverse) {
-											emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, DOT_SCALE, 48 * DOT_SCALE, 255, 255, 255);
+											fill_rect(dest_line_x, 0, DOT_SCALE, 48 * DOT_SCALE, 255);
 											c = 0;
 										}
 										d1 = fifo->read_not_remove(5 + i * 3 + 0);
 										d2 = fifo->read_not_remove(5 + i * 3 + 1);
 										d3 = fifo->read_not_remove(5 + i * 3 + 2);
-										if(d1 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  0) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  2) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  3) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  4) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  5) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  6) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  7) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  8) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  9) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 10) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 11) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 12) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 13) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 14) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 15) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 16) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 17) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 18) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 19) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 20) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 21) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 22) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 23) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c, c, c);
+										if(d1 & 0x80) fill_rect(dest_line_x, (24 +  0) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x40) fill_rect(dest_line_x, (24 +  1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x20) fill_rect(dest_line_x, (24 +  2) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x10) fill_rect(dest_line_x, (24 +  3) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x08) fill_rect(dest_line_x, (24 +  4) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x04) fill_rect(dest_line_x, (24 +  5) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x02) fill_rect(dest_line_x, (24 +  6) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x01) fill_rect(dest_line_x, (24 +  7) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x80) fill_rect(dest_line_x, (24 +  8) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x40) fill_rect(dest_line_x, (24 +  9) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x20) fill_rect(dest_line_x, (24 + 10) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x10) fill_rect(dest_line_x, (24 + 11) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x08) fill_rect(dest_line_x, (24 + 12) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x04) fill_rect(dest_line_x, (24 + 13) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x02) fill_rect(dest_line_x, (24 + 14) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x01) fill_rect(dest_line_x, (24 + 15) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x80) fill_rect(dest_line_x, (24 + 16) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x40) fill_rect(dest_line_x, (24 + 17) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x20) fill_rect(dest_line_x, (24 + 18) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x10) fill_rect(dest_line_x, (24 + 19) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x08) fill_rect(dest_line_x, (24 + 20) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x04) fill_rect(dest_line_x, (24 + 21) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x02) fill_rect(dest_line_x, (24 + 22) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x01) fill_rect(dest_line_x, (24 + 23) * DOT_SCALE, DOT_SCALE, DOT_SCALE, c);
 										dest_line_x += DOT_SCALE;
 										line_printed = true;
 									}
@@ -1436,36 +1436,36 @@ void MZ1P17::process_mz2()
 								for(int i = 0; i < n; i++) {
 									if(dest_line_x < 1440 * DOT_SCALE) {
 										if(reverse) {
-											emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255, 255, 255);
+											fill_rect(dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255);
 											c = 0;
 										}
 										d1 = fifo->read_not_remove(5 + i * 3 + 0);
 										d2 = fifo->read_not_remove(5 + i * 3 + 1);
 										d3 = fifo->read_not_remove(5 + i * 3 + 2);
-										if(d1 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  0) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  1) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  2) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  3) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  4) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  5) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  6) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d1 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  7) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  8) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  9) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 10) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 11) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 12) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 13) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 14) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d2 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 15) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 16) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 17) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 18) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 19) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 20) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 21) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 22) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-										if(d3 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 23) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
+										if(d1 & 0x80) fill_rect(dest_line_x, (24 +  0) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x40) fill_rect(dest_line_x, (24 +  1) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x20) fill_rect(dest_line_x, (24 +  2) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x10) fill_rect(dest_line_x, (24 +  3) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x08) fill_rect(dest_line_x, (24 +  4) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x04) fill_rect(dest_line_x, (24 +  5) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x02) fill_rect(dest_line_x, (24 +  6) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d1 & 0x01) fill_rect(dest_line_x, (24 +  7) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x80) fill_rect(dest_line_x, (24 +  8) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x40) fill_rect(dest_line_x, (24 +  9) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x20) fill_rect(dest_line_x, (24 + 10) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x10) fill_rect(dest_line_x, (24 + 11) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x08) fill_rect(dest_line_x, (24 + 12) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x04) fill_rect(dest_line_x, (24 + 13) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x02) fill_rect(dest_line_x, (24 + 14) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d2 & 0x01) fill_rect(dest_line_x, (24 + 15) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x80) fill_rect(dest_line_x, (24 + 16) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x40) fill_rect(dest_line_x, (24 + 17) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x20) fill_rect(dest_line_x, (24 + 18) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x10) fill_rect(dest_line_x, (24 + 19) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x08) fill_rect(dest_line_x, (24 + 20) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x04) fill_rect(dest_line_x, (24 + 21) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x02) fill_rect(dest_line_x, (24 + 22) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+										if(d3 & 0x01) fill_rect(dest_line_x, (24 + 23) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
 										dest_line_x += 2 * DOT_SCALE;
 										line_printed = true;
 									}
@@ -1481,10 +1481,10 @@ void MZ1P17::process_mz2()
 							for(int i = 0; i < n; i++) {
 								if(dest_line_x < margin_right) {
 									if(reverse) {
-										emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, DOT_SCALE, bitmap_line[color_mode].height, 255, 255, 255);
+										fill_rect(dest_line_x, 0, DOT_SCALE, bitmap_line[color_mode].height, 255);
 									}
 									if(underline) {
-										emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (48 + 1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, 255, 255, 255);
+										fill_rect(dest_line_x, (48 + 1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, 255);
 									}
 									dest_line_x += DOT_SCALE;
 									line_printed = true;
@@ -1771,18 +1771,18 @@ void MZ1P17::process_mz2()
 						for(int i = 0; i < n; i++) {
 							if(dest_line_x < 1440 * DOT_SCALE) {
 								if(reverse) {
-									emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255, 255, 255);
+									fill_rect(dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255);
 									c = 0;
 								}
 								d = fifo->read_not_remove(4 + i);
-								if(d & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 0) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 1) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 2) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 3) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 4) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 5) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 6) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 7) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
+								if(d & 0x01) fill_rect(dest_line_x, (24 + 3 * 0) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x02) fill_rect(dest_line_x, (24 + 3 * 1) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x04) fill_rect(dest_line_x, (24 + 3 * 2) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x08) fill_rect(dest_line_x, (24 + 3 * 3) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x10) fill_rect(dest_line_x, (24 + 3 * 4) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x20) fill_rect(dest_line_x, (24 + 3 * 5) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x40) fill_rect(dest_line_x, (24 + 3 * 6) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x80) fill_rect(dest_line_x, (24 + 3 * 7) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
 								dest_line_x += 2 * DOT_SCALE;
 								line_printed = true;
 							}
@@ -2155,18 +2155,18 @@ void MZ1P17::process_mz3()
 						for(int i = 0; i < n; i++) {
 							if(dest_line_x < 1440 * DOT_SCALE) {
 								if(reverse) {
-									emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, width, 48 * DOT_SCALE, 255, 255, 255);
+									fill_rect(dest_line_x, 0, width, 48 * DOT_SCALE, 255);
 									c = 0;
 								}
 								d = fifo->read_not_remove(4 + i);
-								if(d & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 0) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 1) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 2) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 3) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 4) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 5) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 6) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 7) * DOT_SCALE, width, height, c, c, c);
+								if(d & 0x01) fill_rect(dest_line_x, (24 + 3 * 0) * DOT_SCALE, width, height, c);
+								if(d & 0x02) fill_rect(dest_line_x, (24 + 3 * 1) * DOT_SCALE, width, height, c);
+								if(d & 0x04) fill_rect(dest_line_x, (24 + 3 * 2) * DOT_SCALE, width, height, c);
+								if(d & 0x08) fill_rect(dest_line_x, (24 + 3 * 3) * DOT_SCALE, width, height, c);
+								if(d & 0x10) fill_rect(dest_line_x, (24 + 3 * 4) * DOT_SCALE, width, height, c);
+								if(d & 0x20) fill_rect(dest_line_x, (24 + 3 * 5) * DOT_SCALE, width, height, c);
+								if(d & 0x40) fill_rect(dest_line_x, (24 + 3 * 6) * DOT_SCALE, width, height, c);
+								if(d & 0x80) fill_rect(dest_line_x, (24 + 3 * 7) * DOT_SCALE, width, height, c);
 								dest_line_x += width;
 								line_printed = true;
 							}
@@ -2308,18 +2308,18 @@ void MZ1P17::process_mz3()
 						for(int i = 0; i < n; i++) {
 							if(dest_line_x < 1440 * DOT_SCALE) {
 								if(reverse) {
-									emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, 3 * DOT_SCALE, 48 * DOT_SCALE, 255, 255, 255);
+									fill_rect(dest_line_x, 0, 3 * DOT_SCALE, 48 * DOT_SCALE, 255);
 									c = 0;
 								}
 								d = fifo->read_not_remove(4 + i);
-								if(d & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 0) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 1) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 2) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 3) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 4) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 5) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 6) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
-								if(d & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 7) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c, c, c);
+								if(d & 0x01) fill_rect(dest_line_x, (24 + 3 * 0) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x02) fill_rect(dest_line_x, (24 + 3 * 1) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x04) fill_rect(dest_line_x, (24 + 3 * 2) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x08) fill_rect(dest_line_x, (24 + 3 * 3) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x10) fill_rect(dest_line_x, (24 + 3 * 4) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x20) fill_rect(dest_line_x, (24 + 3 * 5) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x40) fill_rect(dest_line_x, (24 + 3 * 6) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
+								if(d & 0x80) fill_rect(dest_line_x, (24 + 3 * 7) * DOT_SCALE, 2 * DOT_SCALE, 3 * DOT_SCALE, c);
 								dest_line_x += 2 * DOT_SCALE;
 								line_printed = true;
 							}
@@ -2530,10 +2530,10 @@ void MZ1P17::process_x1()
 				for(int i = 0; i < n; i++) {
 					if(dest_line_x < margin_right) {
 						if(reverse) {
-							emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, DOT_SCALE, bitmap_line[color_mode].height, 255, 255, 255);
+							fill_rect(dest_line_x, 0, DOT_SCALE, bitmap_line[color_mode].height, 255);
 						}
 						if(underline) {
-							emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (48 + 1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, 255, 255, 255);
+							fill_rect(dest_line_x, (48 + 1) * DOT_SCALE, DOT_SCALE, DOT_SCALE, 255);
 						}
 						dest_line_x += DOT_SCALE;
 						line_printed = true;
@@ -2609,18 +2609,18 @@ void MZ1P17::process_x1()
 								for(int i = 0; i < n; i++) {
 									if(dest_line_x < 1440 * DOT_SCALE) {
 										if(reverse) {
-											emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, width, 48 * DOT_SCALE, 255, 255, 255);
+											fill_rect(dest_line_x, 0, width, 48 * DOT_SCALE, 255);
 											c = 0;
 										}
 										d = fifo->read_not_remove(5 + i);
-										if(d & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 0 * py) * DOT_SCALE, width, height, c, c, c);
-										if(d & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 1 * py) * DOT_SCALE, width, height, c, c, c);
-										if(d & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 2 * py) * DOT_SCALE, width, height, c, c, c);
-										if(d & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 3 * py) * DOT_SCALE, width, height, c, c, c);
-										if(d & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 4 * py) * DOT_SCALE, width, height, c, c, c);
-										if(d & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 5 * py) * DOT_SCALE, width, height, c, c, c);
-										if(d & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 6 * py) * DOT_SCALE, width, height, c, c, c);
-										if(d & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 7 * py) * DOT_SCALE, width, height, c, c, c);
+										if(d & 0x80) fill_rect(dest_line_x, (top + 0 * py) * DOT_SCALE, width, height, c);
+										if(d & 0x40) fill_rect(dest_line_x, (top + 1 * py) * DOT_SCALE, width, height, c);
+										if(d & 0x20) fill_rect(dest_line_x, (top + 2 * py) * DOT_SCALE, width, height, c);
+										if(d & 0x10) fill_rect(dest_line_x, (top + 3 * py) * DOT_SCALE, width, height, c);
+										if(d & 0x08) fill_rect(dest_line_x, (top + 4 * py) * DOT_SCALE, width, height, c);
+										if(d & 0x04) fill_rect(dest_line_x, (top + 5 * py) * DOT_SCALE, width, height, c);
+										if(d & 0x02) fill_rect(dest_line_x, (top + 6 * py) * DOT_SCALE, width, height, c);
+										if(d & 0x01) fill_rect(dest_line_x, (top + 7 * py) * DOT_SCALE, width, height, c);
 										dest_line_x += width;
 										line_printed = true;
 									}
@@ -2860,27 +2860,27 @@ void MZ1P17::process_x1()
 						for(int i = 0; i < p * 2; i += 2) {
 							if(dest_line_x < 1440 * DOT_SCALE) {
 								if(reverse) {
-									emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, width, 48 * DOT_SCALE, 255, 255, 255);
+									fill_rect(dest_line_x, 0, width, 48 * DOT_SCALE, 255);
 									c = 0;
 								}
 								d1 = fifo->read_not_remove(6 + i + 0);
 								d2 = fifo->read_not_remove(6 + i + 1);
-								if(d1 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  0 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d1 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  1 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d1 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  3 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d1 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  4 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d1 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  6 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d1 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  7 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d1 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  9 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d1 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 10 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d2 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 12 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d2 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 13 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d2 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 15 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d2 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 16 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d2 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 18 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d2 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 19 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d2 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 21 * py) * DOT_SCALE, width, height, c, c, c);
-								if(d2 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 22 * py) * DOT_SCALE, width, height, c, c, c);
+								if(d1 & 0x80) fill_rect(dest_line_x, (top +  0 * py) * DOT_SCALE, width, height, c);
+								if(d1 & 0x40) fill_rect(dest_line_x, (top +  1 * py) * DOT_SCALE, width, height, c);
+								if(d1 & 0x20) fill_rect(dest_line_x, (top +  3 * py) * DOT_SCALE, width, height, c);
+								if(d1 & 0x10) fill_rect(dest_line_x, (top +  4 * py) * DOT_SCALE, width, height, c);
+								if(d1 & 0x08) fill_rect(dest_line_x, (top +  6 * py) * DOT_SCALE, width, height, c);
+								if(d1 & 0x04) fill_rect(dest_line_x, (top +  7 * py) * DOT_SCALE, width, height, c);
+								if(d1 & 0x02) fill_rect(dest_line_x, (top +  9 * py) * DOT_SCALE, width, height, c);
+								if(d1 & 0x01) fill_rect(dest_line_x, (top + 10 * py) * DOT_SCALE, width, height, c);
+								if(d2 & 0x80) fill_rect(dest_line_x, (top + 12 * py) * DOT_SCALE, width, height, c);
+								if(d2 & 0x40) fill_rect(dest_line_x, (top + 13 * py) * DOT_SCALE, width, height, c);
+								if(d2 & 0x20) fill_rect(dest_line_x, (top + 15 * py) * DOT_SCALE, width, height, c);
+								if(d2 & 0x10) fill_rect(dest_line_x, (top + 16 * py) * DOT_SCALE, width, height, c);
+								if(d2 & 0x08) fill_rect(dest_line_x, (top + 18 * py) * DOT_SCALE, width, height, c);
+								if(d2 & 0x04) fill_rect(dest_line_x, (top + 19 * py) * DOT_SCALE, width, height, c);
+								if(d2 & 0x02) fill_rect(dest_line_x, (top + 21 * py) * DOT_SCALE, width, height, c);
+								if(d2 & 0x01) fill_rect(dest_line_x, (top + 22 * py) * DOT_SCALE, width, height, c);
 								dest_line_x += width;
 								line_printed = true;
 							}
@@ -2900,36 +2900,36 @@ void MZ1P17::process_x1()
 						for(int i = 0; i < n; i++) {
 							if(dest_line_x < 1440 * DOT_SCALE) {
 								if(reverse) {
-									emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255, 255, 255);
+									fill_rect(dest_line_x, 0, 2 * DOT_SCALE, 48 * DOT_SCALE, 255);
 									c = 0;
 								}
 								d1 = fifo->read_not_remove(4 + i * 3 + 0);
 								d2 = fifo->read_not_remove(4 + i * 3 + 1);
 								d3 = fifo->read_not_remove(4 + i * 3 + 2);
-								if(d1 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  0) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d1 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  1) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d1 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  2) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d1 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  3) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d1 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  4) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d1 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  5) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d1 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  6) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d1 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  7) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d2 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  8) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d2 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 +  9) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d2 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 10) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d2 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 11) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d2 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 12) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d2 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 13) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d2 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 14) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d2 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 15) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d3 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 16) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d3 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 17) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d3 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 18) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d3 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 19) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d3 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 20) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d3 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 21) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d3 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 22) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
-								if(d3 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (24 + 23) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c, c, c);
+								if(d1 & 0x80) fill_rect(dest_line_x, (24 +  0) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d1 & 0x40) fill_rect(dest_line_x, (24 +  1) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d1 & 0x20) fill_rect(dest_line_x, (24 +  2) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d1 & 0x10) fill_rect(dest_line_x, (24 +  3) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d1 & 0x08) fill_rect(dest_line_x, (24 +  4) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d1 & 0x04) fill_rect(dest_line_x, (24 +  5) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d1 & 0x02) fill_rect(dest_line_x, (24 +  6) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d1 & 0x01) fill_rect(dest_line_x, (24 +  7) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d2 & 0x80) fill_rect(dest_line_x, (24 +  8) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d2 & 0x40) fill_rect(dest_line_x, (24 +  9) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d2 & 0x20) fill_rect(dest_line_x, (24 + 10) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d2 & 0x10) fill_rect(dest_line_x, (24 + 11) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d2 & 0x08) fill_rect(dest_line_x, (24 + 12) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d2 & 0x04) fill_rect(dest_line_x, (24 + 13) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d2 & 0x02) fill_rect(dest_line_x, (24 + 14) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d2 & 0x01) fill_rect(dest_line_x, (24 + 15) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d3 & 0x80) fill_rect(dest_line_x, (24 + 16) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d3 & 0x40) fill_rect(dest_line_x, (24 + 17) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d3 & 0x20) fill_rect(dest_line_x, (24 + 18) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d3 & 0x10) fill_rect(dest_line_x, (24 + 19) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d3 & 0x08) fill_rect(dest_line_x, (24 + 20) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d3 & 0x04) fill_rect(dest_line_x, (24 + 21) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d3 & 0x02) fill_rect(dest_line_x, (24 + 22) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
+								if(d3 & 0x01) fill_rect(dest_line_x, (24 + 23) * DOT_SCALE, 2 * DOT_SCALE, DOT_SCALE, c);
 								dest_line_x += 2 * DOT_SCALE;
 								line_printed = true;
 							}
@@ -3021,17 +3021,17 @@ void MZ1P17::process_x1()
 					for(int i = 0; i < p; i++) {
 						if(dest_line_x < 1440 * DOT_SCALE) {
 							if(reverse) {
-								emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, width, 48 * DOT_SCALE, 255, 255, 255);
+								fill_rect(dest_line_x, 0, width, 48 * DOT_SCALE, 255);
 								c = 0;
 							}
-							if(d & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 0 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 1 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 2 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 3 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 4 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 5 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 6 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 7 * py) * DOT_SCALE, width, height, c, c, c);
+							if(d & 0x80) fill_rect(dest_line_x, (top + 0 * py) * DOT_SCALE, width, height, c);
+							if(d & 0x40) fill_rect(dest_line_x, (top + 1 * py) * DOT_SCALE, width, height, c);
+							if(d & 0x20) fill_rect(dest_line_x, (top + 2 * py) * DOT_SCALE, width, height, c);
+							if(d & 0x10) fill_rect(dest_line_x, (top + 3 * py) * DOT_SCALE, width, height, c);
+							if(d & 0x08) fill_rect(dest_line_x, (top + 4 * py) * DOT_SCALE, width, height, c);
+							if(d & 0x04) fill_rect(dest_line_x, (top + 5 * py) * DOT_SCALE, width, height, c);
+							if(d & 0x02) fill_rect(dest_line_x, (top + 6 * py) * DOT_SCALE, width, height, c);
+							if(d & 0x01) fill_rect(dest_line_x, (top + 7 * py) * DOT_SCALE, width, height, c);
 							dest_line_x += width;
 							line_printed = true;
 						}
@@ -3069,25 +3069,25 @@ void MZ1P17::process_x1()
 					for(int i = 0; i < p * 2; i += 2) {
 						if(dest_line_x < 1440 * DOT_SCALE) {
 							if(reverse) {
-								emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, width, 48 * DOT_SCALE, 255, 255, 255);
+								fill_rect(dest_line_x, 0, width, 48 * DOT_SCALE, 255);
 								c = 0;
 							}
-							if(d1 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  0 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d1 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  1 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d1 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  3 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d1 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  4 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d1 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  6 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d1 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  7 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d1 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top +  9 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d1 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 10 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d2 & 0x80) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 12 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d2 & 0x40) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 13 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d2 & 0x20) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 15 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d2 & 0x10) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 16 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d2 & 0x08) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 18 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d2 & 0x04) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 19 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d2 & 0x02) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 21 * py) * DOT_SCALE, width, height, c, c, c);
-							if(d2 & 0x01) emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, (top + 22 * py) * DOT_SCALE, width, height, c, c, c);
+							if(d1 & 0x80) fill_rect(dest_line_x, (top +  0 * py) * DOT_SCALE, width, height, c);
+							if(d1 & 0x40) fill_rect(dest_line_x, (top +  1 * py) * DOT_SCALE, width, height, c);
+							if(d1 & 0x20) fill_rect(dest_line_x, (top +  3 * py) * DOT_SCALE, width, height, c);
+							if(d1 & 0x10) fill_rect(dest_line_x, (top +  4 * py) * DOT_SCALE, width, height, c);
+							if(d1 & 0x08) fill_rect(dest_line_x, (top +  6 * py) * DOT_SCALE, width, height, c);
+							if(d1 & 0x04) fill_rect(dest_line_x, (top +  7 * py) * DOT_SCALE, width, height, c);
+							if(d1 & 0x02) fill_rect(dest_line_x, (top +  9 * py) * DOT_SCALE, width, height, c);
+							if(d1 & 0x01) fill_rect(dest_line_x, (top + 10 * py) * DOT_SCALE, width, height, c);
+							if(d2 & 0x80) fill_rect(dest_line_x, (top + 12 * py) * DOT_SCALE, width, height, c);
+							if(d2 & 0x40) fill_rect(dest_line_x, (top + 13 * py) * DOT_SCALE, width, height, c);
+							if(d2 & 0x20) fill_rect(dest_line_x, (top + 15 * py) * DOT_SCALE, width, height, c);
+							if(d2 & 0x10) fill_rect(dest_line_x, (top + 16 * py) * DOT_SCALE, width, height, c);
+							if(d2 & 0x08) fill_rect(dest_line_x, (top + 18 * py) * DOT_SCALE, width, height, c);
+							if(d2 & 0x04) fill_rect(dest_line_x, (top + 19 * py) * DOT_SCALE, width, height, c);
+							if(d2 & 0x02) fill_rect(dest_line_x, (top + 21 * py) * DOT_SCALE, width, height, c);
+							if(d2 & 0x01) fill_rect(dest_line_x, (top + 22 * py) * DOT_SCALE, width, height, c);
 							dest_line_x += width;
 							line_printed = true;
 						}
@@ -3398,18 +3398,18 @@ void MZ1P17::process_mz80p4()
 						for(int i = 0; i < p; i++) {
 							if(dest_line_x < 1440 * DOT_SCALE) {
 								if(reverse) {
-									emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, width, 48 * DOT_SCALE, 255, 255, 255);
+									fill_rect(dest_line_x, 0, width, 48 * DOT_SCALE, 255);
 									c = 0;
 								}
 								d = fifo->read_not_remove(6 + i);
-								if(d & 0x01) draw_dot(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 0) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x02) draw_dot(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 1) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x04) draw_dot(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 2) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x08) draw_dot(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 3) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x10) draw_dot(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 4) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x20) draw_dot(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 5) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x40) draw_dot(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 6) * DOT_SCALE, width, height, c, c, c);
-								if(d & 0x80) draw_dot(&bitmap_line[color_mode], dest_line_x, (24 + 3 * 7) * DOT_SCALE, width, height, c, c, c);
+								if(d & 0x01) draw_dot(dest_line_x, (24 + 3 * 0) * DOT_SCALE, width, height, c);
+								if(d & 0x02) draw_dot(dest_line_x, (24 + 3 * 1) * DOT_SCALE, width, height, c);
+								if(d & 0x04) draw_dot(dest_line_x, (24 + 3 * 2) * DOT_SCALE, width, height, c);
+								if(d & 0x08) draw_dot(dest_line_x, (24 + 3 * 3) * DOT_SCALE, width, height, c);
+								if(d & 0x10) draw_dot(dest_line_x, (24 + 3 * 4) * DOT_SCALE, width, height, c);
+								if(d & 0x20) draw_dot(dest_line_x, (24 + 3 * 5) * DOT_SCALE, width, height, c);
+								if(d & 0x40) draw_dot(dest_line_x, (24 + 3 * 6) * DOT_SCALE, width, height, c);
+								if(d & 0x80) draw_dot(dest_line_x, (24 + 3 * 7) * DOT_SCALE, width, height, c);
 								dest_line_x += width;
 								line_printed = true;
 							}
@@ -3612,7 +3612,7 @@ void MZ1P17::draw_char(uint16_t code)
 		double_y_printed = true;
 	}
 	if(reverse) {
-		emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x, 0, gap_p1 + font_width + gap_p2, 48 * DOT_SCALE, 255, 255, 255);
+		fill_rect(dest_line_x, 0, gap_p1 + font_width + gap_p2, 48 * DOT_SCALE, 255);
 		c = 0;
 	}
 	if(IS_NOT_ANK(code) || DOT_PRINT) {
@@ -3629,7 +3629,7 @@ void MZ1P17::draw_char(uint16_t code)
 					int xs = font_width * x / 8 + dest_line_x + gap_p1;
 					int xe = font_width * (x + 1) / 8 + dest_line_x + gap_p1;
 					int xw = xe - xs;
-					draw_dot(&bitmap_line[color_mode], xs, ys, xw, yw, c, c, c);
+					draw_dot(xs, ys, xw, yw, c);
 				}
 			}
 		}
@@ -3637,7 +3637,7 @@ void MZ1P17::draw_char(uint16_t code)
 		for(int y = 0; y < font_height; y++) {
 			for(int x = 0; x < font_width; x++) {
 				if(ank[code & 0xff][16 * y / font_height][8 * x / font_width]) {
-					emu->draw_point_to_bitmap(&bitmap_line[color_mode], dest_line_x + gap_p1 + x, dest_line_y +  y, c, c, c);
+					fill_rect(dest_line_x + gap_p1 + x, dest_line_y +  y, 1, 1, c);
 				}
 			}
 		}
@@ -3649,7 +3649,7 @@ void MZ1P17::draw_char(uint16_t code)
 		for(int y = 0; y < font_height; y++) {
 			for(int x = 0; x < font_width; x++) {
 				if(gaiji[n1][n2][48 * y / font_height][48 * x / font_width]) {
-					emu->draw_point_to_bitmap(&bitmap_line[color_mode], dest_line_x + gap_p1 + x, dest_line_y +  y, c, c, c);
+					fill_rect(dest_line_x + gap_p1 + x, dest_line_y +  y, 1, 1, c);
 				}
 			}
 		}
@@ -3662,7 +3662,7 @@ void MZ1P17::draw_char(uint16_t code)
 	if(underline) {
 		for(int x = 0; x < gap_p1 + font_width + gap_p2; x++) {
 			if(dest_line_x + x < margin_right) {
-				emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], dest_line_x + x, (48 + 1) * DOT_SCALE, 1, DOT_SCALE, 255, 255, 255);
+				fill_rect(dest_line_x + x, (48 + 1) * DOT_SCALE, 1, DOT_SCALE, 255);
 			}
 		}
 	}
@@ -3670,11 +3670,11 @@ void MZ1P17::draw_char(uint16_t code)
 	line_printed = true;
 }
 
-void MZ1P17::draw_dot(bitmap_t *bitmap, int x, int y, int width, int height, uint8_t r, uint8_t g, uint8_t b)
+void MZ1P17::draw_dot(int x, int y, int width, int height, uint8_t c)
 {
 	if(!DOT_PRINT || width < 3 || height < 3) {
 		// dot pattern : square (^)
-		emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], x, y, width, height, r, g, b);
+		fill_rect(x, y, width, height, c);
 	} else {
 		// dot pattern : convex (ʌ^)
 		int loop = (int)(width / 3) + (width % 3 > 0 ? 1 : 0);
@@ -3683,19 +3683,49 @@ void MZ1P17::draw_dot(bitmap_t *bitmap, int x, int y, int width, int height, uin
 			int sw = 3;
 			if(3 * i > width) {
 				sw = 3 * i - width;
-				emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], sx, y, sw, height, r, g, b);
+				fill_rect(sx, y, sw, height, c);
 			} else {
-				emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], sx + 1 , y,     sw - 2, height    , r, g, b);
-				emu->draw_rectangle_to_bitmap(&bitmap_line[color_mode], sx     , y + 1, sw    , height - 1, r, g, b);
+				fill_rect(sx + 1 , y,     sw - 2, height    , c);
+				fill_rect(sx     , y + 1, sw    , height - 1, c);
 			}
 		}
 	}
 }
 
+void MZ1P17::fill_rect(int x, int y, int width, int height, uint8_t c)
+{
+	// write to the line buffer directly, emu->draw_rectangle_to_bitmap() calls osd for each pixel
+	bitmap_t *bitmap = &bitmap_line[color_mode];
+	int left = (x > 0) ? x : 0;
+	int right = (x + width < bitmap->width) ? x + width : bitmap->width;
+	int top = (y > 0) ? y : 0;
+	int bottom = (y + height < bitmap->height) ? y + height : bitmap->height;
+	scrntype_t col = RGB_COLOR(c, c, c);
+	
+	for(int yy = top; yy < bottom; yy++) {
+		scrntype_t *dest = bitmap->get_buffer(yy);
+		for(int xx = left; xx < right; xx++) {
+			dest[xx] = col;
+		}
+	}
+}
+
+void MZ1P17::clear_bitmap(bitmap_t *bitmap, uint8_t c)
+{
+	scrntype_t col = RGB_COLOR(c, c, c);
+	
+	for(int y = 0; y < bitmap->height; y++) {
+		scrntype_t *dest = bitmap->get_buffer(y);
+		for(int x = 0; x < bitmap->width; x++) {
+			dest[x] = col;
+		}
+	}
+}
+
 void MZ1P17::scroll(int value)
 {
 	dest_paper_y += value;
-//	emu->clear_bitmap(&bitmap_line[0], 0, 0, 0);
+//	clear_bitmap(&bitmap_line[0], 0);
 }
 
 void MZ1P17::finish()
@@ -3730,9 +3760,10 @@ void MZ1P17::finish_line()
 			}
 		}
 		if(color_mode) {
+			paper_colored = true;
 			color_mode--;
 		}
-		emu->clear_bitmap(&bitmap_line[0], 0, 0, 0);
+		clear_bitmap(&bitmap_line[0], 0);
 		paper_printed = true;
 	}
 //	int next_lf_pitch = lf_pitch + (double_y_printed ? 24 * DOT_SCALE : 0);
@@ -3745,14 +3776,60 @@ void MZ1P17::finish_paper()
 {
 	if(paper_printed) {
 		if(written_length > 1) {
-			emu->write_bitmap_to_file(&bitmap_paper, create_string(_T("%s_#%02d.png"), get_file_path_without_extensiton(base_path), paper_index++));
+			if(config.printer_pnm_output) {
+				write_paper_to_pnm(create_string(_T("%s_#%02d.%s"), get_file_path_without_extensiton(base_path), paper_index++, paper_colored ? _T("ppm") : _T("pbm")));
+			} else {
+				emu->write_bitmap_to_file(&bitmap_paper, create_string(_T("%s_#%02d.png"), get_file_path_without_extensiton(base_path), paper_index++));
+			}
 		}
-		emu->clear_bitmap(&bitmap_paper, 255, 255, 255);
+		clear_bitmap(&bitmap_paper, 255);
 	}
-	paper_printed = false;
+	paper_printed = paper_colored = false;
 	dest_paper_y = 0;
 }
 
+void MZ1P17::write_paper_to_pnm(const _TCHAR *file_path)
+{
+	// write pbm (monochrome) or ppm (color) without the image encoder of osd
+	FILEIO *fio = new FILEIO();
+	
+	if(fio->Fopen(file_path, FILEIO_WRITE_BINARY)) {
+		int width = bitmap_paper.width;
+		int height = bitmap_paper.height;
+		uint8_t *buffer = (uint8_t *)calloc(width, 3);
+		
+		if(paper_colored) {
+			fio->Fprintf("P6\n%d %d\n255\n", width, height);
+		} else {
+			fio->Fprintf("P4\n%d %d\n", width, height);
+		}
+		for(int y = 0; y < height; y++) {
+			scrntype_t *src = bitmap_paper.get_buffer(y);
+			
+			if(paper_colored) {
+				for(int x = 0; x < width; x++) {
+					buffer[x * 3 + 0] = R_OF_COLOR(src[x]);
+					buffer[x * 3 + 1] = G_OF_COLOR(src[x]);
+					buffer[x * 3 + 2] = B_OF_COLOR(src[x]);
+				}
+				fio->Fwrite(buffer, width * 3, 1);
+			} else {
+				// 1 is black
+				memset(buffer, 0, (width + 7) >> 3);
+				for(int x = 0; x < width; x++) {
+					if(R_OF_COLOR(src[x]) < 128) {
+						buffer[x >> 3] |= 0x80 >> (x & 7);
+					}
+				}
+				fio->Fwrite(buffer, (width + 7) >> 3, 1);
+			}
+		}
+		free(buffer);
+		fio->Fclose();
+	}
+	delete fio;
+}
+
 #define STATE_VERSION	4
 
 bool MZ1P17::process_state(FILEIO* state_fio, bool loading)
@@ -3805,13 +3882,13 @@ bool MZ1P17::process_state(FILEIO* state_fio, bool loading)
 	
 	// post process
 	if(loading) {
-		emu->clear_bitmap(&bitmap_paper, 255, 255, 255);
-		emu->clear_bitmap(&bitmap_line[0], 0, 0, 0);
-		emu->clear_bitmap(&bitmap_line[1], 0, 0, 0);
-		emu->clear_bitmap(&bitmap_line[2], 0, 0, 0);
-		emu->clear_bitmap(&bitmap_line[3], 0, 0, 0);
+		clear_bitmap(&bitmap_paper, 255);
+		clear_bitmap(&bitmap_line[0], 0);
+		clear_bitmap(&bitmap_line[1], 0);
+		clear_bitmap(&bitmap_line[2], 0);
+		clear_bitmap(&bitmap_line[3], 0);
 		wait_frames = -1;
-		line_printed = paper_printed = false;
+		line_printed = paper_printed = paper_colored = false;
 		paper_index = written_length = 0;
 	}
 	return true;
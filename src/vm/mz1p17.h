@@ -75,7 +75,7 @@ private:
 	int dest_line_x, dest_paper_y;
 	int color_mode;
 	bool double_y_printed;
-	bool line_printed, paper_printed;
+	bool line_printed, paper_printed, paper_colored;
 	int paper_index, written_length;
 	_TCHAR base_path[_MAX_PATH];
 	
@@ -87,11 +87,14 @@ private:
 	void process_x1();
 	void process_mz80p4();
 	void draw_char(uint16_t code);
-	void draw_dot(bitmap_t *bitmap, int x, int y, int width, int height, uint8_t r, uint8_t g, uint8_t b);
+	void draw_dot(int x, int y, int width, int height, uint8_t c);
+	void fill_rect(int x, int y, int width, int height, uint8_t c);
+	void clear_bitmap(bitmap_t *bitmap, uint8_t c);
 	void scroll(int value);
 	void finish();
 	void finish_line();
 	void finish_paper();
+	void write_paper_to_pnm(const _TCHAR *file_path);
 	
 public:
 	MZ1P17(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
@@ -11,6 +11,7 @@
 #include "interrupt.h"
 #include "memory.h"
 #include "../i8255.h"
+#include "../planar.h"
 
 #define EVENT_HDISP_TEXT_S	0
 #define EVENT_HDISP_TEXT_E	1
@@ -1726,14 +1727,7 @@ void CRTC::draw_640x200x16screen(uint8_t pl)
 			G = (cgreg[0x18] & 0x04) ? vram_g[src] : 0;
 			I = (cgreg[0x18] & 0x08) ? vram_i[src] : 0;
 			
-			cg[dest2    ] = cg_matrix0[B][R][0] | cg_matrix1[G][I][0];
-			cg[dest2 + 1] = cg_matrix0[B][R][1] | cg_matrix1[G][I][1];
-			cg[dest2 + 2] = cg_matrix0[B][R][2] | cg_matrix1[G][I][2];
-			cg[dest2 + 3] = cg_matrix0[B][R][3] | cg_matrix1[G][I][3];
-			cg[dest2 + 4] = cg_matrix0[B][R][4] | cg_matrix1[G][I][4];
-			cg[dest2 + 5] = cg_matrix0[B][R][5] | cg_matrix1[G][I][5];
-			cg[dest2 + 6] = cg_matrix0[B][R][6] | cg_matrix1[G][I][6];
-			cg[dest2 + 7] = cg_matrix0[B][R][7] | cg_matrix1[G][I][7];
+			planar_to_chunky_lsb(&cg[dest2], B, R, G, I);
 		}
 		dest += 640;
 	}
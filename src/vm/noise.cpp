@@ -9,13 +9,11 @@
 
 #include "noise.h"
 
-#define EVENT_SAMPLE	0
-
 void NOISE::initialize()
 {
-	register_id = -1;
-	ptr = 0;
-	sample_l = sample_r = 0;
+	playing = false;
+	position = 0;
+	prev_clock = 0;
 }
 
 void NOISE::release()
@@ -35,29 +33,45 @@ void NOISE::reset()
 	stop();
 }
 
-void NOISE::event_callback(int event_id, int err)
-{
-	if(++ptr < samples) {
-		get_sample();
-	} else if(loop) {
-		ptr = 0;
-		get_sample();
-	} else {
-		stop();
-	}
-}
-
 void NOISE::mix(int32_t* buffer, int cnt)
 {
-	if(register_id != -1 && !mute) {
-		int32_t val_l = apply_volume(sample_l, volume_l);
-		int32_t val_r = apply_volume(sample_r, volume_r);
+	if(!playing || samples == 0) {
+		return;
+	}
+	uint64_t next = get_position();
+	uint64_t end = (uint64_t)samples << 16;
+	prev_clock = get_current_clock();
+	
+	if(!mute && cnt > 0) {
+		// resample the wav buffer from the current position to the next position
+		uint64_t pos = position;
+		uint64_t step = (next - position) / cnt;
 		
 		for(int i = 0; i < cnt; i++) {
-			*buffer++ += val_l; // L
-			*buffer++ += val_r; // R
+			if(pos >= end) {
+				if(!loop) {
+					break;
+				}
+				pos %= end;
+			}
+			int ptr = (int)(pos >> 16);
+			int ptr_next = (ptr + 1 < samples) ? (ptr + 1) : loop ? 0 : ptr;
+			int frac = (int)((pos >> 1) & 0x7fff);	// 15bits not to overflow
+			int sample_l = buffer_l[ptr] + (((buffer_l[ptr_next] - buffer_l[ptr]) * frac) >> 15);
+			int sample_r = buffer_r[ptr] + (((buffer_r[ptr_next] - buffer_r[ptr]) * frac) >> 15);
+			
+			*buffer++ += apply_volume(sample_l, volume_l); // L
+			*buffer++ += apply_volume(sample_r, volume_r); // R
+			pos += step;
 		}
 	}
+	if(next < end) {
+		position = next;
+	} else if(loop) {
+		position = next % end;
+	} else {
+		playing = false;
+	}
 }
 
 void NOISE::set_volume(int ch, int decibel_l, int decibel_r)
@@ -134,45 +148,35 @@ bool NOISE::load_wav_file(const _TCHAR *file_name)
 
 void NOISE::play()
 {
-	if(samples > 0 && register_id == -1 && !mute) {
+	if(samples > 0 && !is_playing() && !mute) {
 		touch_sound();
-//		if(register_id == -1) {
-			register_event(this, EVENT_SAMPLE, 1000000.0 / sample_rate, true, &register_id);
-//		}
-		ptr = 0;
-		get_sample();
-		set_realtime_render(this, true);
+		playing = true;
+		position = 0;
+		prev_clock = get_current_clock();
 	}
 }
 
 void NOISE::stop()
 {
-	if(samples > 0 && register_id != -1) {
+	if(samples > 0 && playing) {
 		touch_sound();
-//		if(register_id != -1) {
-			cancel_event(this, register_id);
-			register_id = -1;
-//		}
-		sample_l = sample_r = 0;
-		set_realtime_render(this, false);
+		playing = false;
 	}
 }
 
-void NOISE::get_sample()
+uint64_t NOISE::get_position()
 {
-	if(buffer_l != NULL && ptr < samples) {
-		sample_l = buffer_l[ptr];
-	} else {
-		sample_l = 0;
-	}
-	if(buffer_r != NULL && ptr < samples) {
-		sample_r = buffer_l[ptr];
-	} else {
-		sample_r = 0;
-	}
+	// the elapsed clocks are small because the position is updated in each mix()
+	return position + ((uint64_t)get_passed_clock(prev_clock) * sample_rate << 16) / get_event_clocks();
+}
+
+bool NOISE::is_playing()
+{
+	// the wav may be finished before it is mixed
+	return playing && (loop || get_position() < ((uint64_t)samples << 16));
 }
 
-#define STATE_VERSION	1
+#define STATE_VERSION	2
 
 bool NOISE::process_state(FILEIO* state_fio, bool loading)
 {
@@ -182,10 +186,9 @@ bool NOISE::process_state(FILEIO* state_fio, bool loading)
 	if(!state_fio->StateCheckInt32(this_device_id)) {
 		return false;
 	}
-	state_fio->StateValue(register_id);
-	state_fio->StateValue(ptr);
-	state_fio->StateValue(sample_l);
-	state_fio->StateValue(sample_r);
+	state_fio->StateValue(playing);
+	state_fio->StateValue(position);
+	state_fio->StateValue(prev_clock);
 	state_fio->StateValue(loop);
 	state_fio->StateValue(mute);
 	return true;
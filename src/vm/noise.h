@@ -21,14 +21,18 @@ private:
 	int16_t *buffer_r;
 	int samples;
 	int sample_rate;
-	int register_id;
-	int ptr;
-	int sample_l, sample_r;
 	int volume_l, volume_r;
 	bool loop;
 	bool mute;
 	
-	void get_sample();
+	// the wav buffer is resampled in mix(), and the play position is
+	// advanced by the elapsed clocks (16.16 fixed point in samples of wav)
+	bool playing;
+	uint64_t position;
+	uint32_t prev_clock;
+	
+	uint64_t get_position();
+	bool is_playing();
 	
 public:
 	NOISE(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
@@ -46,7 +50,6 @@ public:
 	void initialize();
 	void release();
 	void reset();
-	void event_callback(int event_id, int err);
 	void mix(int32_t* buffer, int cnt);
 	void set_volume(int ch, int decibel_l, int decibel_r);
 	bool process_state(FILEIO* state_fio, bool loading);
@@ -1095,13 +1095,40 @@ STOSB_YbAL_rep(int reptype)
 void
 STOSW_YwAX_rep(int reptype)
 {
+	UINT32 addr;
+	int n, limit, wait;
 	
 	if (!CPU_INST_AS32) {
 		for (;;) {
-			CPU_WORKCLOCK(3);
-			cpu_vmemorywrite_w(CPU_ES_INDEX, CPU_DI, CPU_AX);
-			CPU_DI += STRING_DIRx2;
-			if (--CPU_CX == 0) {
+			n = 0;
+			if (!CPU_STAT_PM) {
+				/* real mode: write the words in the same memory bank at once */
+				n = (STRING_DIRx2 > 0) ? ((0x10000 - CPU_DI) >> 1) : ((CPU_DI >> 1) + 1);
+				if (n > CPU_CX) {
+					n = CPU_CX;
+				}
+				addr = (CPU_STAT_SREGBASE(CPU_ES_INDEX) + CPU_DI) & CPU_ADRSMASK;
+				wait = 0;
+				n = device_mem->get_data16w_run(addr, STRING_DIRx2, n, &wait);
+				if (n > 0) {
+					/* stop at the same word as the loop below */
+					limit = (CPU_REMCLOCK > 0) ? (CPU_REMCLOCK + 2 + wait) / (3 + wait) : 1;
+					if (n > limit) {
+						n = limit;
+					}
+					device_mem->write_data16w_run(addr, STRING_DIRx2, CPU_AX, n);
+					CPU_WORKCLOCK(n * (3 + wait));
+					CPU_DI += n * STRING_DIRx2;
+					CPU_CX -= n;
+				}
+			}
+			if (n == 0) {
+				CPU_WORKCLOCK(3);
+				cpu_vmemorywrite_w(CPU_ES_INDEX, CPU_DI, CPU_AX);
+				CPU_DI += STRING_DIRx2;
+				CPU_CX--;
+			}
+			if (CPU_CX == 0) {
 #if defined(DEBUG)
 			cpu_debug_rep_cont = 0;
 #endif
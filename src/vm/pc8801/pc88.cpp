@@ -17,6 +17,7 @@
 #include "../event.h"
 #include "../i8251.h"
 #include "../pcm1bit.h"
+#include "../planar.h"
 #include "../upd1990a.h"
 #if defined(SUPPORT_PC88_OPN1) || defined(SUPPORT_PC88_OPN2)
 #include "../ym2203.h"
@@ -531,6 +532,9 @@ void PC88::initialize()
 	register_event(this, EVENT_TIMER, 1000000.0 / 600.0, true, NULL);
 	register_event(this, EVENT_BEEP, 1000000.0 / 4800.0, true, NULL);
 	
+	glyph_cache = new GLYPH_CACHE(8, 1024);
+	text_redraw = true;
+	
 #if defined(PC8801_VARIANT)
 	// hack to update config.scan_line at first
 	hireso = !(config.monitor_type == 0);
@@ -546,6 +550,8 @@ void PC88::release()
 {
 	release_tape();
 	delete cmt_fio;
+	glyph_cache->release();
+	delete glyph_cache;
 }
 
 void PC88::reset()
@@ -706,6 +712,8 @@ void PC88::reset()
 #ifdef SUPPORT_PC88_PCG8100
 	// pcg
 	memcpy(pcg_pattern, kanji1 + 0x1000, sizeof(pcg_pattern));
+	glyph_cache->invalidate(2);
+	text_redraw = true;
 	write_io8(1, 0);
 	write_io8(2, 0);
 	write_io8(3, 0);
@@ -978,6 +986,8 @@ void PC88::write_io8(uint32_t addr, uint32_t data)
 			} else {
 				pcg_pattern[0x400 | pcg_addr] = pcg_data;
 			}
+			glyph_cache->invalidate(2);
+			text_redraw = true;
 		}
 		pcg_addr = (pcg_addr & 0x0ff) | ((data & 3) << 8);
 		pcg_ctrl = data;
@@ -3140,9 +3150,9 @@ void PC88::draw_text()
 	
 	if(dmac.ch[3].count.sd == 0) {
 		memset(text, 0, sizeof(text));
+		text_redraw = true;
 		return;
 	}
-	memset(text, 8, sizeof(text));
 	
 	int char_height = crtc.char_height;
 	uint8_t color_mask = Port30_COLOR ? 0 : 7;
@@ -3158,6 +3168,14 @@ void PC88::draw_text()
 	if(crtc.skip_line) {
 		char_height <<= 1;
 	}
+	
+	// redraw all cells when the layout is changed
+	int layout[3] = {char_height, crtc.height, crtc.width};
+	if(text_redraw || memcmp(text_layout, layout, sizeof(layout)) != 0) {
+		memset(text, 8, sizeof(text));
+		memcpy(text_layout, layout, sizeof(layout));
+		text_redraw = true;
+	}
 	if(Port31_GRAPH && !Port31_HCOLOR) {
 #if defined(PC8001_VARIANT)
 		if(config.boot_mode != MODE_PC80_V2) {
@@ -3171,9 +3189,17 @@ void PC88::draw_text()
 #if defined(_PC8001SR)
 	// select katakana or hiragana
 	if(config.dipswitch & DIPSWITCH_PCG8100) {
-		memcpy(pcg_pattern + 0x500, Port33_HIRA ? hiragana : katakana, 0x200);
+		if(memcmp(pcg_pattern + 0x500, Port33_HIRA ? hiragana : katakana, 0x200) != 0) {
+			memcpy(pcg_pattern + 0x500, Port33_HIRA ? hiragana : katakana, 0x200);
+			glyph_cache->invalidate(2);
+			text_redraw = true;
+		}
 	} else {
-		memcpy(kanji1 + 0x1500, Port33_HIRA ? hiragana : katakana, 0x200);
+		if(memcmp(kanji1 + 0x1500, Port33_HIRA ? hiragana : katakana, 0x200) != 0) {
+			memcpy(kanji1 + 0x1500, Port33_HIRA ? hiragana : katakana, 0x200);
+			glyph_cache->invalidate(1);
+			text_redraw = true;
+		}
 	}
 #endif
 //	for(int cy = 0, ytop = 0; cy < 64 && ytop < 400; cy++, ytop += char_height) {
@@ -3206,38 +3232,64 @@ void PC88::draw_text()
 			}
 			uint8_t code = secret ? 0 : code_expand;//crtc.text.expand[cy][cx];
 			uint8_t *pattern;
+			int source;
 #ifdef SUPPORT_PC88_PCG8100
 			if(config.dipswitch & DIPSWITCH_PCG8100) {
 				pattern = ((attrib & 0x10) ? sg_pattern : pcg_pattern) + code * 8;
+				source = (attrib & 0x10) ? 0 : 2;
 			} else
 #endif
-			pattern = ((attrib & 0x10) ? sg_pattern : kanji1 + 0x1000) + code * 8;
+			{
+				pattern = ((attrib & 0x10) ? sg_pattern : kanji1 + 0x1000) + code * 8;
+				source = (attrib & 0x10) ? 0 : 1;
+			}
+			uint32_t flags = color | (reverse ? 0x10 : 0) | (upper_line ? 0x20 : 0) | (under_line ? 0x40 : 0);
+			if(Port30_40) {
+				flags |= (cx & 1) ? 0x100 : 0x80;
+			}
+			
+			// skip the cell if its character and attributes are not changed
+			uint64_t cell = glyph_key(source, code, flags, 0);
+			bool update = true;
+			if(cy < 200) {
+				update = (text_redraw || text_cell[cy][cx] != cell);
+				text_cell[cy][cx] = cell;
+			}
 			
 			for(int l = 0, y = ytop; l < char_height / 2 && y < 400; l++, y += 2) {
-				uint8_t pat = (l < 8) ? pattern[l] : 0;
-				
-				if(Port30_40) {
-					// from ePC-8801MA
-					static const uint8_t wct[16] = {
-						0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f, 0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff
-					};
-					pat = wct[(cx & 1) ? (pat & 0x0f) : (pat >> 4)];
-				}
-				if((upper_line && l == 0) || (under_line && l >= 7)) {
-					pat = 0xff;
-				}
-				if(reverse) {
-					pat ^= 0xff;
+				if(update) {
+					uint64_t key = glyph_key(source, code, flags, l);
+					uint8_t *dest = glyph_cache->find(key);
+					
+					if(dest == NULL) {
+						// expand the pattern with the attributes
+						dest = glyph_cache->insert(key);
+						uint8_t pat = (l < 8) ? pattern[l] : 0;
+						
+						if(Port30_40) {
+							// from ePC-8801MA
+							static const uint8_t wct[16] = {
+								0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f, 0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff
+							};
+							pat = wct[(cx & 1) ? (pat & 0x0f) : (pat >> 4)];
+						}
+						if((upper_line && l == 0) || (under_line && l >= 7)) {
+							pat = 0xff;
+						}
+						if(reverse) {
+							pat ^= 0xff;
+						}
+						dest[0] = (pat & 0x80) ? color : 0;
+						dest[1] = (pat & 0x40) ? color : 0;
+						dest[2] = (pat & 0x20) ? color : 0;
+						dest[3] = (pat & 0x10) ? color : 0;
+						dest[4] = (pat & 0x08) ? color : 0;
+						dest[5] = (pat & 0x04) ? color : 0;
+						dest[6] = (pat & 0x02) ? color : 0;
+						dest[7] = (pat & 0x01) ? color : 0;
+					}
+					memcpy(&text[y >> 1][x], dest, 8);
 				}
-				uint8_t *dest = &text[y >> 1][x];
-				dest[0] = (pat & 0x80) ? color : 0;
-				dest[1] = (pat & 0x40) ? color : 0;
-				dest[2] = (pat & 0x20) ? color : 0;
-				dest[3] = (pat & 0x10) ? color : 0;
-				dest[4] = (pat & 0x08) ? color : 0;
-				dest[5] = (pat & 0x04) ? color : 0;
-				dest[6] = (pat & 0x02) ? color : 0;
-				dest[7] = (pat & 0x01) ? color : 0;
 				
 				// store text attributes for monocolor graph screen
 				text_color[y >> 1][cx] = color_tmp;
@@ -3245,6 +3297,7 @@ void PC88::draw_text()
 			}
 		}
 	}
+	text_redraw = false;
 }
 
 #if defined(SUPPORT_PC88_GVRAM)
@@ -3468,21 +3521,9 @@ bool PC88::draw_640x200_color_graph()
 			uint8_t r = gvram_r[addr];
 			uint8_t g = gvram_g[addr];
 			addr++;
-			uint8_t *dest = &graph[y][x];
-			dest[0] = ((b & 0x80) >> 7) | ((r & 0x80) >> 6) | ((g & 0x80) >> 5);
-			dest[1] = ((b & 0x40) >> 6) | ((r & 0x40) >> 5) | ((g & 0x40) >> 4);
-			dest[2] = ((b & 0x20) >> 5) | ((r & 0x20) >> 4) | ((g & 0x20) >> 3);
-			dest[3] = ((b & 0x10) >> 4) | ((r & 0x10) >> 3) | ((g & 0x10) >> 2);
-			dest[4] = ((b & 0x08) >> 3) | ((r & 0x08) >> 2) | ((g & 0x08) >> 1);
-			dest[5] = ((b & 0x04) >> 2) | ((r & 0x04) >> 1) | ((g & 0x04)     );
-			dest[6] = ((b & 0x02) >> 1) | ((r & 0x02)     ) | ((g & 0x02) << 1);
-			dest[7] = ((b & 0x01)     ) | ((r & 0x01) << 1) | ((g & 0x01) << 2);
-		}
-		if(config.scan_line) {
-			memset(graph[y + 1], 0, 640);
-		} else {
-			memcpy(graph[y + 1], graph[y], 640);
+			planar_to_chunky_msb(&graph[y][x], b, r, g);
 		}
+		planar_next_line(graph[y + 1], graph[y], 640, config.scan_line);
 	}
 	return true;
 }
@@ -4359,6 +4400,8 @@ bool PC88::process_state(FILEIO* state_fio, bool loading)
 #endif
 		// force update palette when state file is loaded
 		update_palette = true;
+		glyph_cache->clear();
+		text_redraw = true;
 	}
 	return true;
 }
@@ -19,6 +19,7 @@
 #include "../vm.h"
 #include "../../emu.h"
 #include "../device.h"
+#include "../glyph_cache.h"
 
 #define SIG_PC88_USART_IRQ	0
 #ifdef SUPPORT_PC88_OPN1
@@ -278,6 +279,11 @@ private:
 	bool hireso;
 	
 	uint8_t sg_pattern[0x800];
+	// expanded rows of sg (0), font rom (1) and pcg (2), and cells drawn in text
+	GLYPH_CACHE* glyph_cache;
+	uint64_t text_cell[200][80];
+	int text_layout[3];
+	bool text_redraw;
 	uint8_t text[200][640];
 	uint8_t text_color[200][80];
 	bool text_reverse[200][80];
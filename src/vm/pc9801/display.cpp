@@ -20,6 +20,7 @@
 #include "display.h"
 #include "../i8259.h"
 #include "../upd7220.h"
+#include "../planar.h"
 
 #if !defined(SUPPORT_HIRESO)
 	#define TVRAM_ADDRESS		0xa0000
@@ -39,6 +40,13 @@
 	#define VRAM_PLANE_ADDR_3	0x60000
 #endif
 
+#define SET_VRAM_DIRTY(addr)	vram_dirty[((addr) & VRAM_PLANE_ADDR_MASK) >> 4] = 1
+
+// start address of the line that is not assigned by gdc (all dots read address 0)
+#define GFX_LINE_UNMAPPED	0x80000000
+#define GFX_LINE_BLANK		0x40000000
+#define GFX_LINE_INVALID	0xffffffff
+
 #define SCROLL_PL	0
 #define SCROLL_BL	1
 #define SCROLL_CL	2
@@ -317,6 +325,12 @@ void DISPLAY::initialize()
 	
 //	memset(tvram, 0, sizeof(tvram));
 	memset(vram, 0, sizeof(vram));
+	memset(vram_dirty, 0, sizeof(vram_dirty));
+	memset(screen_gfx, 0, sizeof(screen_gfx));
+	gfx_redraw = true;
+	gfx_start = false;
+	draw_width = SCREEN_WIDTH;
+	draw_height = SCREEN_HEIGHT;
 	
 	for(int i = 0; i < 16; i++) {
 		tvram[0x3fe0 + (i << 1)] = memsw[i];
@@ -330,6 +344,7 @@ void DISPLAY::initialize()
 	// set vram pointer to gdc
 	d_gdc_chr->set_vram_ptr(tvram, 0x2000);
 	d_gdc_gfx->set_vram_bus_ptr(this, 0x20000);
+	d_gdc_gfx->set_vram_bus_direct(true);
 #if !defined(SUPPORT_HIRESO)
 	d_gdc_gfx->set_plane_size(0x8000);
 #endif
@@ -337,10 +352,16 @@ void DISPLAY::initialize()
 	// register events
 	register_frame_event(this);
 	register_vline_event(this);
+	
+	glyph_cache = new GLYPH_CACHE(FONT_WIDTH * 2, 1024);
+	chr_redraw = true;
 }
 
 void DISPLAY::release()
 {
+	glyph_cache->release();
+	delete glyph_cache;
+	
 	FILEIO* fio = new FILEIO();
 	uint8_t memsw[16];
 	
@@ -406,6 +427,7 @@ void DISPLAY::reset()
 	vram_disp_e = vram + VRAM_PLANE_ADDR_3;
 #endif
 	vram_draw   = vram + 0x00000;
+	gfx_redraw = true;
 	
 	crtv = 2;
 	
@@ -423,6 +445,7 @@ void DISPLAY::reset()
 #endif
 #if defined(SUPPORT_GRCG)
 	grcg_mode = grcg_tile_ptr = 0;
+	d_gdc_gfx->set_vram_bus_direct(true);
 #endif
 #if defined(SUPPORT_EGC)
 	egc_access = 0xfff0;
@@ -489,6 +512,7 @@ void DISPLAY::event_vline(int v, int clock)
 	}
 	if(v == (hireso ? 400 : 200)) {
 		memcpy(tvram_tmp, tvram, sizeof(tvram));
+		prepare_gfx_screen();
 	}
 }
 
@@ -545,6 +569,7 @@ void DISPLAY::write_io8(uint32_t addr, uint32_t data)
 #endif
 		grcg_mode = data;
 		grcg_tile_ptr = 0;
+		d_gdc_gfx->set_vram_bus_direct(!(grcg_mode & GRCG_CG_MODE));
 		break;
 #if !defined(SUPPORT_HIRESO)
 	case 0x007e:
@@ -574,6 +599,9 @@ void DISPLAY::write_io8(uint32_t addr, uint32_t data)
 			vram_disp_e = vram + 0x00000;
 #endif
 		}
+		if((vram_disp_sel ^ data) & 1) {
+			gfx_redraw = true;
+		}
 		vram_disp_sel = data;
 		break;
 	case 0x00a6:
@@ -653,6 +681,8 @@ void DISPLAY::write_io8(uint32_t addr, uint32_t data)
 		if((font_code & 0x7e) == 0x56) {
 			uint16_t font_lr = ((~font_line) & 0x20) << 6;
 			font[((font_code & 0x7f7f) << 4) + font_lr + (font_line & 0x0f)] = data;
+			glyph_cache->invalidate(0);
+			chr_redraw = true;
 		}
 		break;
 #if defined(SUPPORT_EGC)
@@ -866,6 +896,8 @@ void DISPLAY::write_memory_mapped_io8(uint32_t addr, uint32_t data)
 			} else {
 				font[low  + ((addr >> 1) & 0x0f)] = data;
 			}
+			glyph_cache->invalidate(0);
+			chr_redraw = true;
 #else
 			int line = (addr >> 1) & 31, shift = 0;
 			bool is_kanji = false;
@@ -925,6 +957,8 @@ void DISPLAY::write_memory_mapped_io8(uint32_t addr, uint32_t data)
 				font[offset + 0] = (pattern >> 0);
 				font[offset + 1] = (pattern >> 8) & 0x3f;
 			}
+			glyph_cache->invalidate(0);
+			chr_redraw = true;
 #endif
 		}
 #if !defined(SUPPORT_HIRESO)
@@ -1089,10 +1123,108 @@ uint32_t DISPLAY::read_memory_mapped_io16w(uint32_t addr, int *wait)
 	return read_memory_mapped_io16(addr);
 }
 
+// run of word writes (rep stosw) to graphic vram
+
+inline bool DISPLAY::get_gvram_offset(uint32_t addr, uint32_t *offset)
+{
+#if !defined(SUPPORT_HIRESO)
+	if(0xa8000 <= addr && addr < 0xc0000) {
+		*offset = addr - 0xa0000;
+		return true;
+	}
+#if defined(SUPPORT_16_COLORS)
+	if(0xe0000 <= addr && addr < 0xe8000) {
+		*offset = addr - 0xe0000;
+		return true;
+	}
+#endif
+#else
+	if(0xc0000 <= addr && addr < 0xe0000) {
+		*offset = addr - 0xc0000;
+		return true;
+	}
+#endif
+	return false;
+}
+
+int DISPLAY::get_memory_mapped_io16_run(uint32_t addr, int step, int count, int *wait)
+{
+	uint32_t offset;
+	
+	if((addr & 1) || !get_gvram_offset(addr, &offset)) {
+		return 0;
+	}
+	// the run should not wrap in the plane
+	offset &= VRAM_PLANE_ADDR_MASK;
+	*wait = 0;
+	if(step > 0) {
+		return min(count, (int)((VRAM_PLANE_ADDR_MASK + 1 - offset) >> 1));
+	} else {
+		return min(count, (int)(offset >> 1) + 1);
+	}
+}
+
+void DISPLAY::write_memory_mapped_io16_run(uint32_t addr, int step, uint32_t data, int count)
+{
+	uint32_t offset;
+	
+	if((addr & 1) || !get_gvram_offset(addr, &offset)) {
+		DEVICE::write_memory_mapped_io16_run(addr, step, data, count);
+		return;
+	}
+	uint32_t plane_addr = offset & VRAM_PLANE_ADDR_MASK;
+	
+	for(int i = 0; i < count; i++) {
+		SET_VRAM_DIRTY(plane_addr + i * step);
+		SET_VRAM_DIRTY(plane_addr + i * step + 1);
+	}
+#if defined(SUPPORT_GRCG)
+	if(grcg_mode & GRCG_CG_MODE) {
+#if defined(SUPPORT_EGC)
+		if(modereg2[MODE2_EGC]) {
+			if((egc_ope & 0x1800) == 0x0800 || ((egc_ope & 0x1800) == 0x1000 && (egc_fgbg & 0x6000) == 0x0000) || (egc_ope & 0x0300) == 0x0200) {
+				// the shifter or the pattern register is updated for each word
+				for(int i = 0; i < count; i++, offset += step) {
+					egc_writew(offset, data);
+				}
+				return;
+			}
+			// the source is the cpu data or the fg/bg color, same for all words
+			egcquad_t src;
+			src.q = egc_opew(plane_addr, data);
+			if(egc_mask2.w) {
+				if(!(egc_access & 1)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_0, step, src.w[0], egc_mask2.w, count);
+				if(!(egc_access & 2)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_1, step, src.w[1], egc_mask2.w, count);
+				if(!(egc_access & 4)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_2, step, src.w[2], egc_mask2.w, count);
+				if(!(egc_access & 8)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_3, step, src.w[3], egc_mask2.w, count);
+			}
+			return;
+		}
+#endif
+		// RMW writes the tile where the cpu data is 1, TDW writes the tile to all bits
+		uint16_t mask = (grcg_mode & GRCG_RW_MODE) ? (uint16_t)data : 0xffff;
+		if(!(grcg_mode & GRCG_PLANE_0)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_0, step, grcg_tile_word[0], mask, count);
+		if(!(grcg_mode & GRCG_PLANE_1)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_1, step, grcg_tile_word[1], mask, count);
+		if(!(grcg_mode & GRCG_PLANE_2)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_2, step, grcg_tile_word[2], mask, count);
+		if(!(grcg_mode & GRCG_PLANE_3)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_3, step, grcg_tile_word[3], mask, count);
+		return;
+	}
+#endif
+#if !defined(SUPPORT_HIRESO)
+	vram_draw_fillw(offset & 0x1ffff, step, data, 0xffff, count);
+#else
+	if(!(grcg_mode & GRCG_PLANE_0)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_0, step, data, 0xffff, count);
+	if(!(grcg_mode & GRCG_PLANE_1)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_1, step, data, 0xffff, count);
+	if(!(grcg_mode & GRCG_PLANE_2)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_2, step, data, 0xffff, count);
+	if(!(grcg_mode & GRCG_PLANE_3)) vram_draw_fillw(plane_addr | VRAM_PLANE_ADDR_3, step, data, 0xffff, count);
+#endif
+}
+
 // Graphic GDC bus
 
 void DISPLAY::write_dma_io8(uint32_t addr, uint32_t data)
 {
+	SET_VRAM_DIRTY(addr);
 #if defined(SUPPORT_GRCG)
 	if(grcg_mode & GRCG_CG_MODE) {
 #if defined(SUPPORT_EGC)
@@ -1124,6 +1256,8 @@ void DISPLAY::write_dma_io8(uint32_t addr, uint32_t data)
 
 void DISPLAY::write_dma_io16(uint32_t addr, uint32_t data)
 {
+	SET_VRAM_DIRTY(addr);
+	SET_VRAM_DIRTY(addr + 1);
 #if defined(SUPPORT_GRCG)
 	if(grcg_mode & GRCG_CG_MODE) {
 #if defined(SUPPORT_EGC)
@@ -1277,6 +1411,28 @@ inline uint32_t DISPLAY::vram_draw_readw(uint32_t addr)
 }
 #endif
 
+void DISPLAY::vram_draw_fillw(uint32_t addr, int step, uint16_t value, uint16_t mask, int count)
+{
+	if(mask == 0xffff) {
+		for(int i = 0; i < count; i++, addr += step) {
+			#ifdef __BIG_ENDIAN__
+				vram_draw_writew(addr, value);
+			#else
+				*(uint16_t *)(&vram_draw[addr]) = value;
+			#endif
+		}
+	} else {
+		for(int i = 0; i < count; i++, addr += step) {
+			#ifdef __BIG_ENDIAN__
+				vram_draw_writew(addr, (vram_draw_readw(addr) & ~mask) | (value & mask));
+			#else
+				uint16_t *p = (uint16_t *)(&vram_draw[addr]);
+				*p = (*p & ~mask) | (value & mask);
+			#endif
+		}
+	}
+}
+
 // GRCG
 
 #if defined(SUPPORT_GRCG)
@@ -2034,22 +2190,15 @@ void DISPLAY::egc_shiftinput_decw()
 		} \
 	} while(0)
 
-uint64_t DISPLAY::egc_ope_00(uint8_t ope, uint32_t addr)
-{
-	return 0;
-}
-
-uint64_t DISPLAY::egc_ope_0f(uint8_t ope, uint32_t addr)
-{
-	egc_vram_data.d[0] = ~egc_vram_src.d[0];
-	egc_vram_data.d[1] = ~egc_vram_src.d[1];
-	return egc_vram_data.q;
-}
+// raster operation of pattern, source and destination for 4 planes at once:
+// bit (source * 4 + destination * 2 + pattern) of ope is the result
+#define EGC_ROP_BIT(n) ((ope & (1 << (n))) ? ~(uint64_t)0 : 0)
+#define EGC_ROP_SEL(c, t, f) (((t) & (c)) | ((f) & ~(c)))
 
-uint64_t DISPLAY::egc_ope_c0(uint8_t ope, uint32_t addr)
+inline uint64_t DISPLAY::egc_get_dst(uint32_t addr)
 {
 	egcquad_t dst;
-
+	
 	#ifdef __BIG_ENDIAN__
 		dst.w[0] = vram_draw_readw(addr | VRAM_PLANE_ADDR_0);
 		dst.w[1] = vram_draw_readw(addr | VRAM_PLANE_ADDR_1);
@@ -2061,8 +2210,38 @@ uint64_t DISPLAY::egc_ope_c0(uint8_t ope, uint32_t addr)
 		dst.w[2] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_2]);
 		dst.w[3] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_3]);
 	#endif
-	egc_vram_data.d[0] = (egc_vram_src.d[0] & dst.d[0]);
-	egc_vram_data.d[1] = (egc_vram_src.d[1] & dst.d[1]);
+	return dst.q;
+}
+
+inline uint64_t DISPLAY::egc_get_pattern()
+{
+	switch(egc_fgbg & 0x6000) {
+	case 0x2000:
+		return egc_bgc.q;
+	case 0x4000:
+		return egc_fgc.q;
+	default:
+		if((egc_ope & 0x0300) == 0x0100) {
+			return egc_vram_src.q;
+		}
+		return egc_patreg.q;
+	}
+}
+
+uint64_t DISPLAY::egc_ope_00(uint8_t ope, uint32_t addr)
+{
+	return 0;
+}
+
+uint64_t DISPLAY::egc_ope_0f(uint8_t ope, uint32_t addr)
+{
+	egc_vram_data.q = ~egc_vram_src.q;
+	return egc_vram_data.q;
+}
+
+uint64_t DISPLAY::egc_ope_c0(uint8_t ope, uint32_t addr)
+{
+	egc_vram_data.q = egc_vram_src.q & egc_get_dst(addr);
 	return egc_vram_data.q;
 }
 
@@ -2073,23 +2252,7 @@ uint64_t DISPLAY::egc_ope_f0(uint8_t ope, uint32_t addr)
 
 uint64_t DISPLAY::egc_ope_fc(uint8_t ope, uint32_t addr)
 {
-	egcquad_t dst;
-
-	#ifdef __BIG_ENDIAN__
-		dst.w[0] = vram_draw_readw(addr | VRAM_PLANE_ADDR_0);
-		dst.w[1] = vram_draw_readw(addr | VRAM_PLANE_ADDR_1);
-		dst.w[2] = vram_draw_readw(addr | VRAM_PLANE_ADDR_2);
-		dst.w[3] = vram_draw_readw(addr | VRAM_PLANE_ADDR_3);
-	#else
-		dst.w[0] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_0]);
-		dst.w[1] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_1]);
-		dst.w[2] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_2]);
-		dst.w[3] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_3]);
-	#endif
-	egc_vram_data.d[0] = egc_vram_src.d[0];
-	egc_vram_data.d[0] |= ((~egc_vram_src.d[0]) & dst.d[0]);
-	egc_vram_data.d[1] = egc_vram_src.d[1];
-	egc_vram_data.d[1] |= ((~egc_vram_src.d[1]) & dst.d[1]);
+	egc_vram_data.q = egc_vram_src.q | egc_get_dst(addr);
 	return egc_vram_data.q;
 }
 
@@ -2100,155 +2263,41 @@ uint64_t DISPLAY::egc_ope_ff(uint8_t ope, uint32_t addr)
 
 uint64_t DISPLAY::egc_ope_nd(uint8_t ope, uint32_t addr)
 {
-	egcquad_t pat;
-
-	switch(egc_fgbg & 0x6000) {
-	case 0x2000:
-		pat.d[0] = egc_bgc.d[0];
-		pat.d[1] = egc_bgc.d[1];
-		break;
-	case 0x4000:
-		pat.d[0] = egc_fgc.d[0];
-		pat.d[1] = egc_fgc.d[1];
-		break;
-	default:
-		if((egc_ope & 0x0300) == 0x0100) {
-			pat.d[0] = egc_vram_src.d[0];
-			pat.d[1] = egc_vram_src.d[1];
-		} else {
-			pat.d[0] = egc_patreg.d[0];
-			pat.d[1] = egc_patreg.d[1];
-		}
-		break;
-	}
-	egc_vram_data.d[0] = 0;
-	egc_vram_data.d[1] = 0;
-	if(ope & 0x80) {
-		egc_vram_data.d[0] |= (pat.d[0] & egc_vram_src.d[0]);
-		egc_vram_data.d[1] |= (pat.d[1] & egc_vram_src.d[1]);
-	}
-	if(ope & 0x40) {
-		egc_vram_data.d[0] |= ((~pat.d[0]) & egc_vram_src.d[0]);
-		egc_vram_data.d[1] |= ((~pat.d[1]) & egc_vram_src.d[1]);
-	}
-	if(ope & 0x08) {
-		egc_vram_data.d[0] |= (pat.d[0] & (~egc_vram_src.d[0]));
-		egc_vram_data.d[1] |= (pat.d[1] & (~egc_vram_src.d[1]));
-	}
-	if(ope & 0x04) {
-		egc_vram_data.d[0] |= ((~pat.d[0]) & (~egc_vram_src.d[0]));
-		egc_vram_data.d[1] |= ((~pat.d[1]) & (~egc_vram_src.d[1]));
-	}
+	// destination is not used
+	uint64_t pat = egc_get_pattern();
+	uint64_t src = egc_vram_src.q;
+	uint64_t s1 = EGC_ROP_SEL(pat, EGC_ROP_BIT(7), EGC_ROP_BIT(6));
+	uint64_t s0 = EGC_ROP_SEL(pat, EGC_ROP_BIT(3), EGC_ROP_BIT(2));
+	
+	egc_vram_data.q = EGC_ROP_SEL(src, s1, s0);
 	return egc_vram_data.q;
 }
 
 uint64_t DISPLAY::egc_ope_np(uint8_t ope, uint32_t addr)
 {
-	egcquad_t dst;
+	// pattern is not used
+	uint64_t dst = egc_get_dst(addr);
+	uint64_t src = egc_vram_src.q;
+	uint64_t s1 = EGC_ROP_SEL(dst, EGC_ROP_BIT(7), EGC_ROP_BIT(5));
+	uint64_t s0 = EGC_ROP_SEL(dst, EGC_ROP_BIT(3), EGC_ROP_BIT(1));
 	
-	#ifdef __BIG_ENDIAN__
-		dst.w[0] = vram_draw_readw(addr | VRAM_PLANE_ADDR_0);
-		dst.w[1] = vram_draw_readw(addr | VRAM_PLANE_ADDR_1);
-		dst.w[2] = vram_draw_readw(addr | VRAM_PLANE_ADDR_2);
-		dst.w[3] = vram_draw_readw(addr | VRAM_PLANE_ADDR_3);
-	#else
-		dst.w[0] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_0]);
-		dst.w[1] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_1]);
-		dst.w[2] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_2]);
-		dst.w[3] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_3]);
-	#endif
-	
-	egc_vram_data.d[0] = 0;
-	egc_vram_data.d[1] = 0;
-	if(ope & 0x80) {
-		egc_vram_data.d[0] |= (egc_vram_src.d[0] & dst.d[0]);
-		egc_vram_data.d[1] |= (egc_vram_src.d[1] & dst.d[1]);
-	}
-	if(ope & 0x20) {
-		egc_vram_data.d[0] |= (egc_vram_src.d[0] & (~dst.d[0]));
-		egc_vram_data.d[1] |= (egc_vram_src.d[1] & (~dst.d[1]));
-	}
-	if(ope & 0x08) {
-		egc_vram_data.d[0] |= ((~egc_vram_src.d[0]) & dst.d[0]);
-		egc_vram_data.d[1] |= ((~egc_vram_src.d[1]) & dst.d[1]);
-	}
-	if(ope & 0x02) {
-		egc_vram_data.d[0] |= ((~egc_vram_src.d[0]) & (~dst.d[0]));
-		egc_vram_data.d[1] |= ((~egc_vram_src.d[1]) & (~dst.d[1]));
-	}
+	egc_vram_data.q = EGC_ROP_SEL(src, s1, s0);
 	return egc_vram_data.q;
 }
 
 uint64_t DISPLAY::egc_ope_xx(uint8_t ope, uint32_t addr)
 {
-	egcquad_t pat;
-	egcquad_t dst;
+	uint64_t pat = egc_get_pattern();
+	uint64_t dst = egc_get_dst(addr);
+	uint64_t src = egc_vram_src.q;
+	uint64_t s1d1 = EGC_ROP_SEL(pat, EGC_ROP_BIT(7), EGC_ROP_BIT(6));
+	uint64_t s1d0 = EGC_ROP_SEL(pat, EGC_ROP_BIT(5), EGC_ROP_BIT(4));
+	uint64_t s0d1 = EGC_ROP_SEL(pat, EGC_ROP_BIT(3), EGC_ROP_BIT(2));
+	uint64_t s0d0 = EGC_ROP_SEL(pat, EGC_ROP_BIT(1), EGC_ROP_BIT(0));
+	uint64_t s1 = EGC_ROP_SEL(dst, s1d1, s1d0);
+	uint64_t s0 = EGC_ROP_SEL(dst, s0d1, s0d0);
 	
-	switch(egc_fgbg & 0x6000) {
-	case 0x2000:
-		pat.d[0] = egc_bgc.d[0];
-		pat.d[1] = egc_bgc.d[1];
-		break;
-	case 0x4000:
-		pat.d[0] = egc_fgc.d[0];
-		pat.d[1] = egc_fgc.d[1];
-		break;
-	default:
-		if((egc_ope & 0x0300) == 0x0100) {
-			pat.d[0] = egc_vram_src.d[0];
-			pat.d[1] = egc_vram_src.d[1];
-		} else {
-			pat.d[0] = egc_patreg.d[0];
-			pat.d[1] = egc_patreg.d[1];
-		}
-		break;
-	}
-	#ifdef __BIG_ENDIAN__
-		dst.w[0] = vram_draw_readw(addr | VRAM_PLANE_ADDR_0);
-		dst.w[1] = vram_draw_readw(addr | VRAM_PLANE_ADDR_1);
-		dst.w[2] = vram_draw_readw(addr | VRAM_PLANE_ADDR_2);
-		dst.w[3] = vram_draw_readw(addr | VRAM_PLANE_ADDR_3);
-	#else
-		dst.w[0] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_0]);
-		dst.w[1] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_1]);
-		dst.w[2] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_2]);
-		dst.w[3] = *(uint16_t *)(&vram_draw[addr | VRAM_PLANE_ADDR_3]);
-	#endif
-	
-	egc_vram_data.d[0] = 0;
-	egc_vram_data.d[1] = 0;
-	if(ope & 0x80) {
-		egc_vram_data.d[0] |= (pat.d[0] & egc_vram_src.d[0] & dst.d[0]);
-		egc_vram_data.d[1] |= (pat.d[1] & egc_vram_src.d[1] & dst.d[1]);
-	}
-	if(ope & 0x40) {
-		egc_vram_data.d[0] |= ((~pat.d[0]) & egc_vram_src.d[0] & dst.d[0]);
-		egc_vram_data.d[1] |= ((~pat.d[1]) & egc_vram_src.d[1] & dst.d[1]);
-	}
-	if(ope & 0x20) {
-		egc_vram_data.d[0] |= (pat.d[0] & egc_vram_src.d[0] & (~dst.d[0]));
-		egc_vram_data.d[1] |= (pat.d[1] & egc_vram_src.d[1] & (~dst.d[1]));
-	}
-	if(ope & 0x10) {
-		egc_vram_data.d[0] |= ((~pat.d[0]) & egc_vram_src.d[0] & (~dst.d[0]));
-		egc_vram_data.d[1] |= ((~pat.d[1]) & egc_vram_src.d[1] & (~dst.d[1]));
-	}
-	if(ope & 0x08) {
-		egc_vram_data.d[0] |= (pat.d[0] & (~egc_vram_src.d[0]) & dst.d[0]);
-		egc_vram_data.d[1] |= (pat.d[1] & (~egc_vram_src.d[1]) & dst.d[1]);
-	}
-	if(ope & 0x04) {
-		egc_vram_data.d[0] |= ((~pat.d[0]) & (~egc_vram_src.d[0]) & dst.d[0]);
-		egc_vram_data.d[1] |= ((~pat.d[1]) & (~egc_vram_src.d[1]) & dst.d[1]);
-	}
-	if(ope & 0x02) {
-		egc_vram_data.d[0] |= (pat.d[0] & (~egc_vram_src.d[0]) & (~dst.d[0]));
-		egc_vram_data.d[1] |= (pat.d[1] & (~egc_vram_src.d[1]) & (~dst.d[1]));
-	}
-	if(ope & 0x01) {
-		egc_vram_data.d[0] |= ((~pat.d[0]) & (~egc_vram_src.d[0]) & (~dst.d[0]));
-		egc_vram_data.d[1] |= ((~pat.d[1]) & (~egc_vram_src.d[1]) & (~dst.d[1]));
-	}
+	egc_vram_data.q = EGC_ROP_SEL(src, s1, s0);
 	return egc_vram_data.q;
 }
 
@@ -2810,22 +2859,21 @@ void DISPLAY::egc_writew(uint32_t addr1, uint16_t value)
 
 void DISPLAY::draw_screen()
 {
+	// graphic screen is rendered from the snapshot taken at vsync
+	if(emu->now_waiting_in_debugger) {
+		prepare_gfx_screen();
+	}
+	emu->finish_render_lines();
+	
 	// render screen
 	bool gdc_chr_start = d_gdc_chr->get_start();
-	bool gdc_gfx_start = d_gdc_gfx->get_start();
 	
-	if(modereg1[MODE1_DISP] && (gdc_chr_start || gdc_gfx_start)) {
+	if(modereg1[MODE1_DISP] && (gdc_chr_start || gfx_start)) {
 		if(gdc_chr_start) {
 			draw_chr_screen();
 		} else {
 			memset(screen_chr, 0, sizeof(screen_chr));
-		}
-		if(gdc_gfx_start) {
-			draw_gfx_screen();
-		} else {
-			memset(screen_gfx, 0, sizeof(screen_gfx));
-			draw_width = SCREEN_WIDTH;
-			draw_height = SCREEN_HEIGHT;
+			chr_redraw = true;
 		}
 		int offset_x = (SCREEN_WIDTH - draw_width) >> 1;
 		int offset_y = (SCREEN_HEIGHT - draw_height) >> 1;
@@ -2946,7 +2994,13 @@ void DISPLAY::draw_chr_screen()
 	uint32_t *addr  = &gdc_addr[0][0];
 	uint32_t *addr2 = addr;
 	
-	memset(screen_chr, 0, sizeof(screen_chr));
+	// redraw all cells when the layout is changed
+	int layout[10] = {pl, bl, cl, ssl, sur, sdr, cursor_top, cursor_bottom, modereg1[MODE1_COLUMN], ymax};
+	if(chr_redraw || memcmp(chr_layout, layout, sizeof(layout)) != 0 || ymax > CHR_CELL_ROWS) {
+		memset(screen_chr, 0, sizeof(screen_chr));
+		memcpy(chr_layout, layout, sizeof(layout));
+		chr_redraw = true;
+	}
 	
 	for(int y = 0, cy = 0, ytop = 0; y < SCREEN_HEIGHT && cy < ymax; y += bl, cy++) {
 		uint32_t gaiji1st = 0, last = 0, offset;
@@ -2998,99 +3052,100 @@ void DISPLAY::draw_chr_screen()
 			}
 			last = offset;
 			
+			// skip the cell if its character, attribute and cursor are not changed
+			uint32_t flags = color;
+			if(!(attr & ATTR_ST) || ((attr & ATTR_BL) && attr_blink)) {
+				flags |= 0x10;
+			}
+			if(attr & ATTR_RV) {
+				flags |= 0x20;
+			}
+			if(attr & ATTR_UL) {
+				flags |= 0x40;
+			}
+			if((attr & ATTR_VL) && !modereg1[MODE1_ATRSEL]) {
+				flags |= 0x80;
+			}
+			if(modereg1[MODE1_COLUMN]) {
+				flags |= 0x100;
+			}
+			uint64_t cell = glyph_key(0, offset, flags | (cursor ? 0x200 : 0), 0);
+			if(cy < CHR_CELL_ROWS) {
+				if(!chr_redraw && chr_cell[cy][cx] == cell) {
+					continue;
+				}
+				chr_cell[cy][cx] = cell;
+			}
+			
 			for(int l = 0; l < bl; l++) {
 				int yy = y + l + pl;
 				if(yy >= ytop && yy < SCREEN_HEIGHT) {
-					uint8_t *dest = &screen_chr[yy][x];
+					bool cursor_line = (cursor && l >= cursor_top && l < cursor_bottom);
+					uint64_t key = glyph_key(0, offset, flags | (cursor_line ? 0x200 : 0) | ((l < cl) ? 0x400 : 0), l);
+					uint8_t *row = glyph_cache->find(key);
+					
+					if(row == NULL) {
+						// expand the pattern with the attributes
+						row = glyph_cache->insert(key);
 #if !defined(SUPPORT_HIRESO)
-					uint8_t pattern = (l < cl && l < FONT_HEIGHT) ? font[offset + l] : 0;
+						uint8_t pattern = (l < cl && l < FONT_HEIGHT) ? font[offset + l] : 0;
 #else
-					uint16_t pattern = (l < cl && l < FONT_HEIGHT) ? (font[offset + l * 2] | (font[offset + l * 2 + 1] << 8)) : 0;
-#endif
-					if(!(attr & ATTR_ST) || ((attr & ATTR_BL) && attr_blink)) {
-						pattern = 0;
-					}
-					if(attr & ATTR_RV) {
-						pattern = ~pattern;
-					}
-					if((attr & ATTR_UL) && l == (FONT_HEIGHT - 1)) {
-#if !defined(SUPPORT_HIRESO)
-						pattern = 0xff;
-#else
-						pattern = 0x3ff;
-#endif
-					}
-					if((attr & ATTR_VL) && !modereg1[MODE1_ATRSEL]) {
+						uint16_t pattern = (l < cl && l < FONT_HEIGHT) ? (font[offset + l * 2] | (font[offset + l * 2 + 1] << 8)) : 0;
+#endif
+						if(flags & 0x10) {
+							pattern = 0;
+						}
+						if(flags & 0x20) {
+							pattern = ~pattern;
+						}
+						if((flags & 0x40) && l == (FONT_HEIGHT - 1)) {
 #if !defined(SUPPORT_HIRESO)
-						pattern |= 0x08;
+							pattern = 0xff;
 #else
-						pattern |= 0x40;
+							pattern = 0x3ff;
 #endif
-					}
-					if(cursor && l >= cursor_top && l < cursor_bottom) {
-						pattern = ~pattern;
-					}
-					if(modereg1[MODE1_COLUMN]) {
-#if !defined(SUPPORT_HIRESO)
-						if(pattern & 0x80) dest[ 0] = dest[ 1] = color;
-						if(pattern & 0x40) dest[ 2] = dest[ 3] = color;
-						if(pattern & 0x20) dest[ 4] = dest[ 5] = color;
-						if(pattern & 0x10) dest[ 6] = dest[ 7] = color;
-						if(pattern & 0x08) dest[ 8] = dest[ 9] = color;
-						if(pattern & 0x04) dest[10] = dest[11] = color;
-						if(pattern & 0x02) dest[12] = dest[13] = color;
-						if(pattern & 0x01) dest[14] = dest[15] = color;
-#else
-						if(pattern & 0x2000) dest[ 0] = dest[ 1] = color;
-						if(pattern & 0x1000) dest[ 2] = dest[ 3] = color;
-						if(pattern & 0x0800) dest[ 4] = dest[ 5] = color;
-						if(pattern & 0x0400) dest[ 6] = dest[ 7] = color;
-						if(pattern & 0x0200) dest[ 8] = dest[ 9] = color;
-						if(pattern & 0x0100) dest[10] = dest[11] = color;
-						if(pattern & 0x0080) dest[12] = dest[13] = color;
-						if(pattern & 0x0040) dest[14] = dest[15] = color;
-						if(pattern & 0x0020) dest[16] = dest[17] = color;
-						if(pattern & 0x0010) dest[18] = dest[19] = color;
-						if(pattern & 0x0008) dest[20] = dest[21] = color;
-						if(pattern & 0x0004) dest[22] = dest[23] = color;
-						if(pattern & 0x0002) dest[24] = dest[25] = color;
-						if(pattern & 0x0001) dest[26] = dest[27] = color;
-#endif
-					} else {
+						}
+						if(flags & 0x80) {
 #if !defined(SUPPORT_HIRESO)
-						if(pattern & 0x80) dest[0] = color;
-						if(pattern & 0x40) dest[1] = color;
-						if(pattern & 0x20) dest[2] = color;
-						if(pattern & 0x10) dest[3] = color;
-						if(pattern & 0x08) dest[4] = color;
-						if(pattern & 0x04) dest[5] = color;
-						if(pattern & 0x02) dest[6] = color;
-						if(pattern & 0x01) dest[7] = color;
+							pattern |= 0x08;
 #else
-						if(pattern & 0x2000) dest[ 0] = color;
-						if(pattern & 0x1000) dest[ 1] = color;
-						if(pattern & 0x0800) dest[ 2] = color;
-						if(pattern & 0x0400) dest[ 3] = color;
-						if(pattern & 0x0200) dest[ 4] = color;
-						if(pattern & 0x0100) dest[ 5] = color;
-						if(pattern & 0x0080) dest[ 6] = color;
-						if(pattern & 0x0040) dest[ 7] = color;
-						if(pattern & 0x0020) dest[ 8] = color;
-						if(pattern & 0x0010) dest[ 9] = color;
-						if(pattern & 0x0008) dest[10] = color;
-						if(pattern & 0x0004) dest[11] = color;
-						if(pattern & 0x0002) dest[12] = color;
-						if(pattern & 0x0001) dest[13] = color;
-#endif
+							pattern |= 0x40;
+#endif
+						}
+						if(cursor_line) {
+							pattern = ~pattern;
+						}
+						for(int i = 0; i < FONT_WIDTH; i++) {
+							uint8_t c = (pattern & (1 << (FONT_WIDTH - 1 - i))) ? color : 0;
+							if(flags & 0x100) {
+								row[i * 2] = row[i * 2 + 1] = c;
+							} else {
+								row[i] = c;
+							}
+						}
 					}
+					memcpy(&screen_chr[yy][x], row, xofs);
 				}
 			}
 		}
 	}
+	chr_redraw = false;
 }
 
-void DISPLAY::draw_gfx_screen()
+void DISPLAY::prepare_gfx_screen()
 {
+	// wait until the previous screen is rendered
+	emu->finish_render_lines();
+	
+	gfx_start = d_gdc_gfx->get_start();
+	if(!gfx_start) {
+		memset(screen_gfx, 0, sizeof(screen_gfx));
+		gfx_redraw = true;
+		draw_width = SCREEN_WIDTH;
+		draw_height = SCREEN_HEIGHT;
+		return;
+	}
+	
 	// address from gdc
 	uint8_t *sync_gfx = d_gdc_gfx->get_sync();
 	uint8_t *cs_gfx = d_gdc_gfx->get_cs();
@@ -3116,13 +3171,14 @@ void DISPLAY::draw_gfx_screen()
 	lf <<= 1;
 #endif
 	uint8_t *ra_gfx = d_gdc_gfx->get_ra();
-	uint32_t gdc_addr[SCREEN_HEIGHT][SCREEN_WIDTH >> 3] = {0};
+	uint32_t gdc_addr[SCREEN_HEIGHT];
 	uint8_t blank[SCREEN_HEIGHT] = {0};
 	int ymax = min(lf, SCREEN_HEIGHT);
 	int xmax = min(pitch, SCREEN_WIDTH >> 3);
 	
-	memset(screen_gfx, 0, sizeof(screen_gfx));
-	
+	for(int y = 0; y < SCREEN_HEIGHT; y++) {
+		gdc_addr[y] = GFX_LINE_UNMAPPED;
+	}
 	for(int i = 0, ytop = 0; i < 4 && ytop < ymax; i++) {
 		uint32_t ra = ra_gfx[i * 4];
 		ra |= ra_gfx[i * 4 + 1] << 8;
@@ -3138,9 +3194,8 @@ void DISPLAY::draw_gfx_screen()
 		uint8_t im = (ra >> 30) & 1;
 		
 		for(int y = 0, y2 = ytop; y < len && y2 < ymax; y++, y2++) {
-			for(int x = 0; x < xmax; x++) {
-				gdc_addr[y2][x] = (sad++) & VRAM_PLANE_ADDR_MASK;
-			}
+			gdc_addr[y2] = sad & VRAM_PLANE_ADDR_MASK;
+			sad += xmax;
 			if((lr && !im) || (hireso && modereg1[MODE1_200LINE])) {
 				if((y2 + 1) >= ymax) {
 					break;
@@ -3148,7 +3203,7 @@ void DISPLAY::draw_gfx_screen()
 				if(modereg1[MODE1_200LINE]) {
 					blank[y2 + 1] = 1;
 				} else {
-					memcpy(gdc_addr[y2 + 1], gdc_addr[y2], sizeof(gdc_addr[0]));
+					gdc_addr[y2 + 1] = gdc_addr[y2];
 				}
 				if(lr2) {
 					sad += xmax;
@@ -3161,40 +3216,109 @@ void DISPLAY::draw_gfx_screen()
 	}
 	xmax = min(xmax, cr);
 	
+	// redraw all lines when the screen layout is changed
+	bool redraw = gfx_redraw;
+	if(gfx_redraw || gfx_xmax != xmax || gfx_ymax != ymax || gfx_hireso != hireso || gfx_scan_line != config.scan_line) {
+		memset(screen_gfx, 0, sizeof(screen_gfx));
+		for(int y = 0; y < SCREEN_HEIGHT; y++) {
+			gfx_line_addr[y] = GFX_LINE_INVALID;
+		}
+		gfx_xmax = xmax;
+		gfx_ymax = ymax;
+		gfx_hireso = hireso;
+		gfx_scan_line = config.scan_line;
+		gfx_redraw = false;
+	}
+	
+	memset(gfx_line_dirty, 0, sizeof(gfx_line_dirty));
 	for(int y = 0, y2 = 0; y < ymax; y++, y2++) {
-		if(!blank[y]) {
+		// convert only the line whose address is changed or vram is written
+		uint32_t line_addr = blank[y] ? GFX_LINE_BLANK : gdc_addr[y2];
+		bool dirty = (gfx_line_addr[y] != line_addr);
+		
+		if(!dirty && !blank[y] && xmax > 0) {
+			if(line_addr == GFX_LINE_UNMAPPED) {
+				dirty = (vram_dirty[0] != 0);
+			} else {
+				for(int x = 0; x < xmax && !dirty; x += 16) {
+					dirty = (vram_dirty[((line_addr + x) & VRAM_PLANE_ADDR_MASK) >> 4] != 0);
+				}
+				if(!dirty) {
+					dirty = (vram_dirty[((line_addr + xmax - 1) & VRAM_PLANE_ADDR_MASK) >> 4] != 0);
+				}
+			}
+		}
+		if(dirty) {
+			gfx_line_addr[y] = line_addr;
+			gfx_line_dirty[y] = 1;
+		}
+		if(!hireso) {
+			y++;
+		}
+	}
+	
+	// copy the written blocks of displayed planes to the snapshot
+	if(redraw) {
+		memcpy(render_vram[0], vram_disp_b, VRAM_PLANE_SIZE);
+		memcpy(render_vram[1], vram_disp_r, VRAM_PLANE_SIZE);
+		memcpy(render_vram[2], vram_disp_g, VRAM_PLANE_SIZE);
+#if defined(SUPPORT_16_COLORS)
+		memcpy(render_vram[3], vram_disp_e, VRAM_PLANE_SIZE);
+#endif
+	} else {
+		for(int i = 0; i < (VRAM_PLANE_SIZE >> 4); i++) {
+			if(vram_dirty[i]) {
+				int ofs = i << 4;
+				memcpy(render_vram[0] + ofs, vram_disp_b + ofs, 16);
+				memcpy(render_vram[1] + ofs, vram_disp_r + ofs, 16);
+				memcpy(render_vram[2] + ofs, vram_disp_g + ofs, 16);
+#if defined(SUPPORT_16_COLORS)
+				memcpy(render_vram[3] + ofs, vram_disp_e + ofs, 16);
+#endif
+			}
+		}
+	}
+	memset(vram_dirty, 0, sizeof(vram_dirty));
+	
+	draw_width = xmax << 3;
+	draw_height = ymax;
+	
+	// convert the dirty lines in worker threads
+	emu->start_render_lines(this, ymax);
+}
+
+void DISPLAY::render_lines(int top, int bottom)
+{
+	int xmax = gfx_xmax;
+	
+	for(int y = top; y < bottom; y++) {
+		if(!gfx_line_dirty[y]) {
+			if(!gfx_hireso) {
+				y++;
+			}
+			continue;
+		}
+		uint32_t line_addr = gfx_line_addr[y];
+		
+		if(line_addr == GFX_LINE_BLANK) {
+			memset(screen_gfx[y], 0, xmax << 3);
+		} else {
 			uint8_t *dest = &screen_gfx[y][0];
 			for(int x = 0; x < xmax; x++) {
-				uint32_t addr = gdc_addr[y2][x];
-				uint8_t b = vram_disp_b[addr];
-				uint8_t r = vram_disp_r[addr];
-				uint8_t g = vram_disp_g[addr];
+				uint32_t addr = (line_addr == GFX_LINE_UNMAPPED) ? 0 : ((line_addr + x) & VRAM_PLANE_ADDR_MASK);
 #if defined(SUPPORT_16_COLORS)
-				uint8_t e = vram_disp_e[addr];
+				planar_to_chunky_msb(dest, render_vram[0][addr], render_vram[1][addr], render_vram[2][addr], render_vram[3][addr]);
 #else
-				uint8_t e = 0;
-#endif
-				*dest++ = ((b & 0x80) >> 7) | ((r & 0x80) >> 6) | ((g & 0x80) >> 5) | ((e & 0x80) >> 4);
-				*dest++ = ((b & 0x40) >> 6) | ((r & 0x40) >> 5) | ((g & 0x40) >> 4) | ((e & 0x40) >> 3);
-				*dest++ = ((b & 0x20) >> 5) | ((r & 0x20) >> 4) | ((g & 0x20) >> 3) | ((e & 0x20) >> 2);
-				*dest++ = ((b & 0x10) >> 4) | ((r & 0x10) >> 3) | ((g & 0x10) >> 2) | ((e & 0x10) >> 1);
-				*dest++ = ((b & 0x08) >> 3) | ((r & 0x08) >> 2) | ((g & 0x08) >> 1) | ((e & 0x08)     );
-				*dest++ = ((b & 0x04) >> 2) | ((r & 0x04) >> 1) | ((g & 0x04)     ) | ((e & 0x04) << 1);
-				*dest++ = ((b & 0x02) >> 1) | ((r & 0x02)     ) | ((g & 0x02) << 1) | ((e & 0x02) << 2);
-				*dest++ = ((b & 0x01)     ) | ((r & 0x01) << 1) | ((g & 0x01) << 2) | ((e & 0x01) << 3);
+				planar_to_chunky_msb(dest, render_vram[0][addr], render_vram[1][addr], render_vram[2][addr]);
+#endif
+				dest += 8;
 			}
 		}
-		if(!hireso) {
-			if(config.scan_line) {
-				memset(screen_gfx[y + 1], 0, SCREEN_WIDTH);
-			} else {
-				my_memcpy(screen_gfx[y + 1], screen_gfx[y], SCREEN_WIDTH);
-			}
+		if(!gfx_hireso) {
+			planar_next_line(screen_gfx[y + 1], screen_gfx[y], SCREEN_WIDTH, gfx_scan_line);
 			y++;
 		}
 	}
-	draw_width = xmax << 3;
-	draw_height = ymax;
 }
 
 #define STATE_VERSION	4
@@ -3275,6 +3399,11 @@ bool DISPLAY::process_state(FILEIO* state_fio, bool loading)
 	
 	// post process
 	if(loading) {
+		gfx_redraw = true;
+		chr_redraw = true;
+#if defined(SUPPORT_GRCG)
+		d_gdc_gfx->set_vram_bus_direct(!(grcg_mode & GRCG_CG_MODE));
+#endif
 #if defined(SUPPORT_2ND_VRAM) && !defined(SUPPORT_HIRESO)
 		if(vram_disp_sel & 1) {
 			vram_disp_b = vram + 0x28000;
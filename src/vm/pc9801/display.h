@@ -23,6 +23,7 @@
 #include "../vm.h"
 #include "../../emu.h"
 #include "../device.h"
+#include "../glyph_cache.h"
 
 class UPD7220;
 
@@ -134,6 +135,32 @@ private:
 	
 	uint8_t screen_chr[SCREEN_HEIGHT][SCREEN_WIDTH + 1];
 	uint8_t screen_gfx[SCREEN_HEIGHT][SCREEN_WIDTH];
+	
+	// expanded rows of characters, and cells drawn in screen_chr
+	#define CHR_CELL_ROWS	(SCREEN_HEIGHT / 8)
+	GLYPH_CACHE* glyph_cache;
+	uint64_t chr_cell[CHR_CELL_ROWS][80];
+	int chr_layout[10];
+	bool chr_redraw;
+	
+	// dirty flags of vram per 16 bytes in each plane
+#if !defined(SUPPORT_HIRESO)
+	uint8_t vram_dirty[0x08000 >> 4];
+#else
+	uint8_t vram_dirty[0x20000 >> 4];
+#endif
+	uint32_t gfx_line_addr[SCREEN_HEIGHT];
+	uint8_t gfx_line_dirty[SCREEN_HEIGHT];
+	int gfx_xmax, gfx_ymax;
+	bool gfx_hireso, gfx_scan_line;
+	bool gfx_redraw, gfx_start;
+	
+	// snapshot of displayed planes (b, r, g, e) at vsync, converted by worker threads
+#if !defined(SUPPORT_HIRESO)
+	uint8_t render_vram[4][0x08000];
+#else
+	uint8_t render_vram[4][0x20000];
+#endif
 	uint8_t scroll_tmp[6];
 	uint8_t tvram_tmp[0x4000];
 	int draw_width, draw_height;
@@ -148,6 +175,8 @@ private:
 	inline void vram_draw_writew(uint32_t addr, uint32_t data);
 	inline uint32_t vram_draw_readw(uint32_t addr);
 #endif
+	inline bool get_gvram_offset(uint32_t addr, uint32_t *offset);
+	void vram_draw_fillw(uint32_t addr, int step, uint16_t value, uint16_t mask, int count);
 #if defined(SUPPORT_GRCG)
 	void grcg_writeb(uint32_t addr1, uint32_t data);
 	void grcg_writew(uint32_t addr1, uint32_t data);
@@ -179,6 +208,8 @@ private:
 	void egc_shiftinput_byte(uint32_t ext);
 	void egc_shiftinput_incw();
 	void egc_shiftinput_decw();
+	inline uint64_t egc_get_dst(uint32_t addr);
+	inline uint64_t egc_get_pattern();
 	uint64_t egc_ope_00(uint8_t ope, uint32_t addr);
 	uint64_t egc_ope_0f(uint8_t ope, uint32_t addr);
 	uint64_t egc_ope_c0(uint8_t ope, uint32_t addr);
@@ -197,7 +228,7 @@ private:
 	void egc_writew(uint32_t addr1, uint16_t value);
 #endif
 	void draw_chr_screen();
-	void draw_gfx_screen();
+	void prepare_gfx_screen();
 	
 public:
 	DISPLAY(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
@@ -213,6 +244,7 @@ public:
 	void release();
 	void event_frame();
 	void event_vline(int v, int clock);
+	void render_lines(int top, int bottom);
 	void write_io8(uint32_t addr, uint32_t data);
 	uint32_t read_io8(uint32_t addr);
 	void write_memory_mapped_io8(uint32_t addr, uint32_t data);
@@ -221,6 +253,8 @@ public:
 	uint32_t read_memory_mapped_io16(uint32_t addr);
 	void write_memory_mapped_io16w(uint32_t addr, uint32_t data, int *wait);
 	uint32_t read_memory_mapped_io16w(uint32_t addr, int *wait);
+	int get_memory_mapped_io16_run(uint32_t addr, int step, int count, int *wait);
+	void write_memory_mapped_io16_run(uint32_t addr, int step, uint32_t data, int count);
 	void write_dma_io8(uint32_t addr, uint32_t data);
 	uint32_t read_dma_io8(uint32_t addr);
 	void write_dma_io16(uint32_t addr, uint32_t data);
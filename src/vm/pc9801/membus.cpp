@@ -449,6 +449,28 @@ void MEMBUS::write_data16w(uint32_t addr, uint32_t data, int *wait)
 	MEMORY::write_data16w(addr, data, wait);
 }
 
+int MEMBUS::get_data16w_run(uint32_t addr, int step, int count, int *wait)
+{
+	// the run should be in this 4kb page, the windows are mapped by 128kb
+	uint32_t page = addr & 0xfff;
+	if(step > 0) {
+		count = min(count, (int)((0x1000 - page) >> 1));
+	} else {
+		count = min(count, (int)(page >> 1) + 1);
+	}
+	if(!get_memory_addr(&addr)) {
+		return 0;
+	}
+	return MEMORY::get_data16w_run(addr, step, count, wait);
+}
+
+void MEMBUS::write_data16w_run(uint32_t addr, int step, uint32_t data, int count)
+{
+	if(get_memory_addr(&addr)) {
+		MEMORY::write_data16w_run(addr, step, data, count);
+	}
+}
+
 uint32_t MEMBUS::read_data32w(uint32_t addr, int *wait)
 {
 	if(!get_memory_addr(&addr)) {
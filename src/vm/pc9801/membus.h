@@ -120,6 +120,8 @@ public:
 	uint32_t read_data8w(uint32_t addr, int *wait);
 	void write_data16w(uint32_t addr, uint32_t data, int *wait);
 	uint32_t read_data16w(uint32_t addr, int *wait);
+	int get_data16w_run(uint32_t addr, int step, int count, int *wait);
+	void write_data16w_run(uint32_t addr, int step, uint32_t data, int count);
 	void write_data32w(uint32_t addr, uint32_t data, int *wait);
 	uint32_t read_data32w(uint32_t addr, int *wait);
 #endif
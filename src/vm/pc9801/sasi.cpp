@@ -71,6 +71,9 @@ void SASI::write_io8(uint32_t addr, uint32_t data)
 		if((prev_control & CONTROL_SEL) != (control & CONTROL_SEL)) {
 			d_host->write_signal(SIG_SCSI_SEL, data, CONTROL_SEL);
 		}
+		if((prev_control & CONTROL_DMAE) != (control & CONTROL_DMAE)) {
+			d_host->write_signal(SIG_SCSI_DMAE, data, CONTROL_DMAE);
+		}
 		if((prev_control & (CONTROL_DMAE | CONTROL_INTE)) != (control & (CONTROL_DMAE | CONTROL_INTE))) {
 			update_signal();
 		}
@@ -210,6 +213,9 @@ void SASI::write_signal(int id, uint32_t data, uint32_t mask)
 			this->out_debug_log(_T("[SASI] TC=%d\n"), (data & mask) ? 1 : 0);
 		#endif
 		if(data & mask) {
+			if(control & CONTROL_DMAE) {
+				d_host->write_signal(SIG_SCSI_DMAE, 0, 0);
+			}
 			control &= ~CONTROL_DMAE;
 			update_signal();
 			prev_control = control;
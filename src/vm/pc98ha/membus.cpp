@@ -17,6 +17,7 @@ void MEMBUS::initialize()
 	// init memory
 	memset(ram, 0, sizeof(ram));
 	memset(vram, 0, sizeof(vram));
+	memset(vram_dirty, 1, sizeof(vram_dirty));
 	memset(ipl, 0xff, sizeof(ipl));
 	memset(learn, 0xff, sizeof(learn));
 	memset(dic, 0xff, sizeof(dic));
@@ -134,6 +135,16 @@ void MEMBUS::write_data8w(uint32_t addr, uint32_t data, int *wait)
 }
 #endif
 
+void MEMBUS::write_memory_mapped_io8(uint32_t addr, uint32_t data)
+{
+	// vram (a8000h-affffh)
+	addr &= 0x7fff;
+	if(vram[addr] != data) {
+		vram[addr] = data;
+		vram_dirty[addr / 80] = 1;
+	}
+}
+
 void MEMBUS::write_io8(uint32_t addr, uint32_t data)
 {
 	switch(addr & 0xffff) {
@@ -218,7 +229,8 @@ void MEMBUS::update_bank()
 	unset_memory_w(0x00000, 0xfffff);
 	
 	set_memory_rw(0x00000, 0x9ffff, ram);
-	set_memory_rw(0xa8000, 0xaffff, vram);
+	set_memory_r(0xa8000, 0xaffff, vram);
+	set_memory_mapped_io_w(0xa8000, 0xaffff, this);
 #ifdef _PC98HA
 	set_memory_rw(0xc0000, 0xc3fff, ems + 0x4000 * ems_bank[0]);
 	set_memory_rw(0xc4000, 0xc7fff, ems + 0x4000 * ems_bank[1]);
@@ -248,24 +260,29 @@ void MEMBUS::update_bank()
 
 void MEMBUS::draw_screen()
 {
-	// draw to real screen
+	// convert only the lines written since the last frame
 	scrntype_t cd = RGB_COLOR(48, 56, 16);
 	scrntype_t cb = RGB_COLOR(160, 168, 160);
-	int ptr = 0;
 	
 	for(int y = 0; y < 400; y++) {
-		scrntype_t* dest = emu->get_screen_buffer(y);
-		for(int x = 0; x < 640; x += 8) {
-			uint8_t pat = vram[ptr++];
-			dest[x + 0] = (pat & 0x80) ? cd : cb;
-			dest[x + 1] = (pat & 0x40) ? cd : cb;
-			dest[x + 2] = (pat & 0x20) ? cd : cb;
-			dest[x + 3] = (pat & 0x10) ? cd : cb;
-			dest[x + 4] = (pat & 0x08) ? cd : cb;
-			dest[x + 5] = (pat & 0x04) ? cd : cb;
-			dest[x + 6] = (pat & 0x02) ? cd : cb;
-			dest[x + 7] = (pat & 0x01) ? cd : cb;
+		if(vram_dirty[y]) {
+			scrntype_t* dest = screen[y];
+			int ptr = y * 80;
+			for(int x = 0; x < 640; x += 8) {
+				uint8_t pat = vram[ptr++];
+				dest[x + 0] = (pat & 0x80) ? cd : cb;
+				dest[x + 1] = (pat & 0x40) ? cd : cb;
+				dest[x + 2] = (pat & 0x20) ? cd : cb;
+				dest[x + 3] = (pat & 0x10) ? cd : cb;
+				dest[x + 4] = (pat & 0x08) ? cd : cb;
+				dest[x + 5] = (pat & 0x04) ? cd : cb;
+				dest[x + 6] = (pat & 0x02) ? cd : cb;
+				dest[x + 7] = (pat & 0x01) ? cd : cb;
+			}
+			vram_dirty[y] = 0;
 		}
+		// draw to real screen
+		my_memcpy(emu->get_screen_buffer(y), screen[y], 640 * sizeof(scrntype_t));
 	}
 }
 
@@ -308,6 +325,7 @@ bool MEMBUS::process_state(FILEIO* state_fio, bool loading)
 	// post process
 	if(loading) {
 		update_bank();
+		memset(vram_dirty, 1, sizeof(vram_dirty));
 	}
 	return true;
 }
@@ -22,6 +22,8 @@ private:
 	
 	uint8_t ram[0xa0000];		// RAM 640KB
 	uint8_t vram[0x8000];		// VRAM 32KB
+	uint8_t vram_dirty[0x8000 / 80 + 1];	// dirty flags per line
+	scrntype_t screen[400][640];
 	
 	uint8_t ipl[0x10000];		// IPL 64KB
 	uint8_t kanji[0x40000];		// Kanji ROM 256KB
@@ -65,6 +67,7 @@ public:
 #ifdef _PC98HA
 	void write_data8w(uint32_t addr, uint32_t data, int *wait);
 #endif
+	void write_memory_mapped_io8(uint32_t addr, uint32_t data);
 	void write_io8(uint32_t addr, uint32_t data);
 	uint32_t read_io8(uint32_t addr);
 	bool process_state(FILEIO* state_fio, bool loading);
@@ -1586,6 +1586,8 @@ void PCE::psg_reset()
 	
 	psg_ch = 0;
 	psg_vol = psg_lfo_freq = psg_lfo_ctrl = 0;
+	psg_blep.clear();
+	memset(psg_blep_level, 0, sizeof(psg_blep_level));
 }
 
 void PCE::psg_write(uint16_t addr, uint8_t data)
@@ -1682,23 +1684,76 @@ void PCE::mix(int32_t* buffer, int cnt)
 	if(!inserted) {
 		return;
 	}
-	for(int ch = 0; ch < 6; ch++) {
-		if(!(psg[ch].regs[4] & 0x80)) {
-			// mute
-			psg[ch].genptr = psg[ch].remain = 0;
-		}
-		else if(psg[ch].regs[4] & 0x40) {
-			// dda
-			int32_t wav = ((int32_t)psg[ch].wav[0] - 16) * 702;
-			int32_t vol = max((psg_vol >> 3) & 0x1e, (psg_vol << 1) & 0x1e) + (psg[ch].regs[4] & 0x1f) + max((psg[ch].regs[5] >> 3) & 0x1e, (psg[ch].regs[5] << 1) & 0x1e) - 60;
-			vol = (vol < 0) ? 0 : (vol > 31) ? 31 : vol;
-			int32_t outvol = wav * vol_tbl[vol] / 16384;
-			for(int i = 0, j = 0; i < cnt; i++, j += 2) {
-				buffer[j    ] += apply_volume(outvol, volume_l); // L
-				buffer[j + 1] += apply_volume(outvol, volume_r); // R
+	// tone and dda channels are output as the steps of amplitude with blep buffer,
+	// and noise channels are output directly
+	int32_t *blep_buffer = buffer;
+	int blep_cnt = cnt;
+	while(blep_cnt > 0) {
+		int samples = min(blep_cnt, BLEP_BLOCK);
+		
+		for(int ch = 0; ch < 6; ch++) {
+			if(!(psg[ch].regs[4] & 0x80)) {
+				// mute
+				psg[ch].genptr = psg[ch].remain = 0;
+				set_psg_blep_level(ch, 0, 0);
+			}
+			else if(psg[ch].regs[4] & 0x40) {
+				// dda
+				int32_t wav = ((int32_t)psg[ch].wav[0] - 16) * 702;
+				int32_t vol = max((psg_vol >> 3) & 0x1e, (psg_vol << 1) & 0x1e) + (psg[ch].regs[4] & 0x1f) + max((psg[ch].regs[5] >> 3) & 0x1e, (psg[ch].regs[5] << 1) & 0x1e) - 60;
+				vol = (vol < 0) ? 0 : (vol > 31) ? 31 : vol;
+				set_psg_blep_level(ch, 0, wav * vol_tbl[vol] / 16384);
+			}
+			else if(ch >= 4 && (psg[ch].regs[7] & 0x80)) {
+				// noise
+				set_psg_blep_level(ch, 0, 0);
+			}
+			else {
+				uint32_t freq = psg[ch].regs[2] + ((uint32_t)psg[ch].regs[3] << 8);
+				if(freq) {
+					int32_t vol = max((psg_vol >> 3) & 0x1e, (psg_vol << 1) & 0x1e) + (psg[ch].regs[4] & 0x1f) + max((psg[ch].regs[5] >> 3) & 0x1e, (psg[ch].regs[5] << 1) & 0x1e) - 60;
+					vol = (vol < 0) ? 0 : (vol > 31) ? 31 : vol;
+					vol = vol_tbl[vol];
+					// the wave pointer is advanced when remain crosses the unit
+					uint32_t inc = 32 * 1118608 / freq;
+					uint32_t unit = 10 * sample_rate;
+					
+					if(inc < unit * 16) {
+						set_psg_blep_level(ch, 0, ((int32_t)psg[ch].wav[psg[ch].genptr] - 16) * 702 * vol / 16384);
+						for(int i = 0; i < samples; i++) {
+							uint32_t prev = psg[ch].remain;
+							psg[ch].remain += inc;
+							for(uint32_t next = unit; next <= psg[ch].remain; next += unit) {
+								uint32_t frac = (uint32_t)(((uint64_t)(next - prev) << BLEP_TIME_BITS) / inc);
+								if(frac > (1 << BLEP_TIME_BITS) - 1) {
+									frac = (1 << BLEP_TIME_BITS) - 1;
+								}
+								psg[ch].genptr = (psg[ch].genptr + 1) & 0x1f;
+								set_psg_blep_level(ch, ((uint32_t)i << BLEP_TIME_BITS) + frac, ((int32_t)psg[ch].wav[psg[ch].genptr] - 16) * 702 * vol / 16384);
+							}
+							psg[ch].remain %= unit;
+						}
+					} else {
+						// tone above the nyquist frequency is not output
+						uint64_t total = psg[ch].remain + (uint64_t)inc * samples;
+						psg[ch].genptr = (uint32_t)((psg[ch].genptr + total / unit) & 0x1f);
+						psg[ch].remain = (uint32_t)(total % unit);
+						set_psg_blep_level(ch, 0, 0);
+					}
+				} else {
+					set_psg_blep_level(ch, 0, 0);
+				}
 			}
 		}
-		else if(ch >= 4 && (psg[ch].regs[7] & 0x80)) {
+		psg_blep.mix(blep_buffer, samples, volume_l, volume_r);
+		blep_buffer += samples * 2;
+		blep_cnt -= samples;
+	}
+	for(int ch = 4; ch < 6; ch++) {
+		if(!(psg[ch].regs[4] & 0x80) || (psg[ch].regs[4] & 0x40)) {
+			// mute or dda
+		}
+		else if(psg[ch].regs[7] & 0x80) {
 			// noise
 			uint16_t freq = (psg[ch].regs[7] & 0x1f);
 			int32_t vol = max((psg_vol >> 3) & 0x1e, (psg_vol << 1) & 0x1e) + (psg[ch].regs[4] & 0x1f) + max((psg[ch].regs[5] >> 3) & 0x1e, (psg[ch].regs[5] << 1) & 0x1e) - 60;
@@ -1723,27 +1778,6 @@ void PCE::mix(int32_t* buffer, int cnt)
 				buffer[j + 1] += apply_volume(outvol, volume_r); // R
 			}
 		}
-		else {
-			int32_t wav[32];
-			for(int i = 0; i < 32; i++) {
-				wav[i] = ((int32_t)psg[ch].wav[i] - 16) * 702;
-			}
-			uint32_t freq = psg[ch].regs[2] + ((uint32_t)psg[ch].regs[3] << 8);
-			if(freq) {
-				int32_t vol = max((psg_vol >> 3) & 0x1e, (psg_vol << 1) & 0x1e) + (psg[ch].regs[4] & 0x1f) + max((psg[ch].regs[5] >> 3) & 0x1e, (psg[ch].regs[5] << 1) & 0x1e) - 60;
-				vol = (vol < 0) ? 0 : (vol > 31) ? 31 : vol;
-				vol = vol_tbl[vol];
-				for(int i = 0, j = 0; i < cnt; i++, j += 2) {
-					int32_t outvol = wav[psg[ch].genptr] * vol / 16384;
-					buffer[j    ] += apply_volume(outvol, volume_l); // L
-					buffer[j + 1] += apply_volume(outvol, volume_r); // R
-					psg[ch].remain += 32 * 1118608 / freq;
-					uint32_t t = psg[ch].remain / (10 * sample_rate);
-					psg[ch].genptr = (psg[ch].genptr + t) & 0x1f;
-					psg[ch].remain -= 10 * sample_rate * t;
-				}
-			}
-		}
 	}
 #ifdef SUPPORT_CDROM
 	if(support_cdrom) {
@@ -2577,6 +2611,10 @@ bool PCE::process_state(FILEIO* state_fio, bool loading)
 	for(int i = 0; i < array_length(psg); i++) {
 		process_state_psg(&psg[i], state_fio);
 	}
+	if(loading) {
+		psg_blep.clear();
+		memset(psg_blep_level, 0, sizeof(psg_blep_level));
+	}
 	state_fio->StateValue(psg_ch);
 	state_fio->StateValue(psg_vol);
 	state_fio->StateValue(psg_lfo_freq);
@@ -17,6 +17,7 @@
 #include "../vm.h"
 #include "../../emu.h"
 #include "../device.h"
+#include "../blep_buffer.h"
 
 #ifdef SUPPORT_CDROM
 #define SIG_PCE_SCSI_IRQ	0
@@ -168,6 +169,14 @@ private:
 	uint8_t psg_ch, psg_vol, psg_lfo_freq, psg_lfo_ctrl;
 	int sample_rate;
 	int volume_l, volume_r;
+	// output level of each tone/dda channel in blep buffer
+	BLEP_BUFFER psg_blep;
+	int32_t psg_blep_level[6];
+	void set_psg_blep_level(int ch, uint32_t time, int32_t level)
+	{
+		psg_blep.add_delta(time, level - psg_blep_level[ch]);
+		psg_blep_level[ch] = level;
+	}
 	void psg_reset();
 	void psg_write(uint16_t addr, uint8_t data);
 	uint8_t psg_read(uint16_t addr);
@@ -228,6 +237,7 @@ public:
 	PCE(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
 	{
 		volume_l = volume_r = 1024;
+		memset(psg_blep_level, 0, sizeof(psg_blep_level));
 		set_device_name(_T("PC-Engine Core"));
 	}
 	~PCE() {}
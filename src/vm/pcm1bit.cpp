@@ -14,17 +14,16 @@ void PCM1BIT::initialize()
 	signal = false;
 	on = true;
 	mute = false;
-	realtime = false;
 	changed = 0;
 	last_vol_l = last_vol_r = 0;
+	blep_level = 0;
 	
 	register_frame_event(this);
 }
 
 void PCM1BIT::reset()
 {
-	prev_clock = get_current_clock();
-	positive_clocks = negative_clocks = 0;
+	edges.clear(get_current_clock(), signal);
 }
 
 void PCM1BIT::write_signal(int id, uint32_t data, uint32_t mask)
@@ -32,62 +31,39 @@ void PCM1BIT::write_signal(int id, uint32_t data, uint32_t mask)
 	if(id == SIG_PCM1BIT_SIGNAL) {
 		bool next = ((data & mask) != 0);
 		if(signal != next) {
-			if(signal) {
-				positive_clocks += get_passed_clock(prev_clock);
-			} else {
-				negative_clocks += get_passed_clock(prev_clock);
+			if(edges.is_full()) {
+				touch_sound();
 			}
-			prev_clock = get_current_clock();
+			edges.add(get_current_clock(), next);
 			// mute if signal is not changed in 2 frames
 			changed = 2;
-			update_realtime_render();
 			signal = next;
 		}
 	} else if(id == SIG_PCM1BIT_ON) {
 		touch_sound();
 		on = ((data & mask) != 0);
-		update_realtime_render();
 	} else if(id == SIG_PCM1BIT_MUTE) {
 		touch_sound();
 		mute = ((data & mask) != 0);
-		update_realtime_render();
 	}
 }
 
 void PCM1BIT::event_frame()
 {
-	if(changed > 0 && --changed == 0) {
-		update_realtime_render();
-	}
-}
-
-void PCM1BIT::update_realtime_render()
-{
-	bool value = (on && !mute && changed != 0);
-	
-	if(realtime != value) {
-		set_realtime_render(this, value);
-		realtime = value;
+	if(changed > 0) {
+		changed--;
 	}
 }
 
 void PCM1BIT::mix(int32_t* buffer, int cnt)
 {
 	if(on && !mute && changed) {
-		if(signal) {
-			positive_clocks += get_passed_clock(prev_clock);
-		} else {
-			negative_clocks += get_passed_clock(prev_clock);
-		}
-		int clocks = positive_clocks + negative_clocks;
-		int sample = clocks ? (max_vol * positive_clocks - max_vol * negative_clocks) / clocks : signal ? max_vol : -max_vol;
-		
-		last_vol_l = apply_volume(sample, volume_l);
-		last_vol_r = apply_volume(sample, volume_r);
+		// convert the logged edges to band-limited samples
+		edges.mix_blep(&blep, &blep_level, buffer, cnt, get_current_clock(), max_vol, volume_l, volume_r);
 		
-		for(int i = 0; i < cnt; i++) {
-			*buffer++ += last_vol_l; // L
-			*buffer++ += last_vol_r; // R
+		if(cnt > 0) {
+			last_vol_l = apply_volume(edges.get_last_sample(), volume_l);
+			last_vol_r = apply_volume(edges.get_last_sample(), volume_r);
 		}
 	} else {
 		// suppress petite noise when go to mute
@@ -106,9 +82,10 @@ void PCM1BIT::mix(int32_t* buffer, int cnt)
 				last_vol_r++;
 			}
 		}
+		edges.clear(get_current_clock(), signal);
+		blep.clear();
+		blep_level = 0;
 	}
-	prev_clock = get_current_clock();
-	positive_clocks = negative_clocks = 0;
 }
 
 void PCM1BIT::set_volume(int ch, int decibel_l, int decibel_r)
@@ -122,7 +99,7 @@ void PCM1BIT::initialize_sound(int rate, int volume)
 	max_vol = volume;
 }
 
-#define STATE_VERSION	3
+#define STATE_VERSION	4
 
 bool PCM1BIT::process_state(FILEIO* state_fio, bool loading)
 {
@@ -135,15 +112,14 @@ bool PCM1BIT::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(signal);
 	state_fio->StateValue(on);
 	state_fio->StateValue(mute);
-	state_fio->StateValue(realtime);
 	state_fio->StateValue(changed);
-	state_fio->StateValue(prev_clock);
-	state_fio->StateValue(positive_clocks);
-	state_fio->StateValue(negative_clocks);
 	
 	// post process
 	if(loading) {
+		edges.clear(get_current_clock(), signal);
 		last_vol_l = last_vol_r = 0;
+		blep.clear();
+		blep_level = 0;
 	}
 	return true;
 }
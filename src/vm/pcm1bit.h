@@ -13,6 +13,7 @@
 #include "vm.h"
 #include "../emu.h"
 #include "device.h"
+#include "edge_buffer.h"
 
 #define SIG_PCM1BIT_SIGNAL	0
 #define SIG_PCM1BIT_ON		1
@@ -21,15 +22,14 @@
 class PCM1BIT : public DEVICE
 {
 private:
-	bool signal, on, mute, realtime;
+	bool signal, on, mute;
 	int changed;
-	uint32_t prev_clock;
-	int positive_clocks, negative_clocks;
+	EDGE_BUFFER edges;
+	BLEP_BUFFER blep;
+	int32_t blep_level;
 	int max_vol, last_vol_l, last_vol_r;
 	int volume_l, volume_r;
 	
-	void update_realtime_render();
-	
 public:
 	PCM1BIT(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
 	{
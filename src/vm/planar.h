@@ -0,0 +1,88 @@
+/*
+	Skelton for retropc emulator
+
+	Author : agent
+	Date   : 2026.10.19-
+
+	[ planar to chunky conversion ]
+*/
+
+#ifndef _PLANAR_H_
+#define _PLANAR_H_
+
+#include <string.h>
+#include "../common.h"
+
+// each bit of the plane data is spread to bit 7 of one byte in 64bit word,
+// and the word is stored to the memory as 8 pixels.
+// msb first (pc-98, pc-88, x1, fm-7) or lsb first (mz-2500) is selected
+// by the bit mask, and the byte order of the host is also considered.
+
+#if defined(__BIG_ENDIAN__)
+	#define PLANAR_MASK_MSB	0x8040201008040201ULL
+	#define PLANAR_MASK_LSB	0x0102040810204080ULL
+#else
+	#define PLANAR_MASK_MSB	0x0102040810204080ULL
+	#define PLANAR_MASK_LSB	0x8040201008040201ULL
+#endif
+
+static inline uint64_t planar_spread(uint8_t data, uint64_t mask)
+{
+	// broadcast the data to all bytes, pick one bit per byte, and carry it to bit 7
+	uint64_t tmp = ((uint64_t)data * 0x0101010101010101ULL) & mask;
+	return (tmp + 0x7f7f7f7f7f7f7f7fULL) & 0x8080808080808080ULL;
+}
+
+static inline void planar_store(uint8_t *dest, uint64_t pixels)
+{
+	memcpy(dest, &pixels, 8);
+}
+
+// dest[i] = (p0 bit) | (p1 bit) << 1 | (p2 bit) << 2 | (p3 bit) << 3
+
+static inline void planar_to_chunky_msb(uint8_t *dest, uint8_t p0, uint8_t p1, uint8_t p2, uint8_t p3 = 0)
+{
+	planar_store(dest, (planar_spread(p0, PLANAR_MASK_MSB) >> 7) |
+	                   (planar_spread(p1, PLANAR_MASK_MSB) >> 6) |
+	                   (planar_spread(p2, PLANAR_MASK_MSB) >> 5) |
+	                   (planar_spread(p3, PLANAR_MASK_MSB) >> 4));
+}
+
+static inline void planar_to_chunky_lsb(uint8_t *dest, uint8_t p0, uint8_t p1, uint8_t p2, uint8_t p3 = 0)
+{
+	planar_store(dest, (planar_spread(p0, PLANAR_MASK_LSB) >> 7) |
+	                   (planar_spread(p1, PLANAR_MASK_LSB) >> 6) |
+	                   (planar_spread(p2, PLANAR_MASK_LSB) >> 5) |
+	                   (planar_spread(p3, PLANAR_MASK_LSB) >> 4));
+}
+
+// chunky to rgb with palette
+
+static inline void chunky_to_rgb(scrntype_t *dest, const uint8_t *src, const scrntype_t *palette, int width)
+{
+__DECL_VECTORIZED_LOOP
+	for(int x = 0; x < width; x++) {
+		dest[x] = palette[src[x]];
+	}
+}
+
+static inline void chunky_to_rgb_x2(scrntype_t *dest, const uint8_t *src, const scrntype_t *palette, int width)
+{
+__DECL_VECTORIZED_LOOP
+	for(int x = 0; x < width; x++) {
+		dest[x * 2] = dest[x * 2 + 1] = palette[src[x]];
+	}
+}
+
+// next line of 200 lines mode: black for scan line, or copy of this line
+
+static inline void planar_next_line(uint8_t *dest, const uint8_t *src, int width, bool scan_line)
+{
+	if(scan_line) {
+		memset(dest, 0, width);
+	} else {
+		memcpy(dest, src, width);
+	}
+}
+
+#endif
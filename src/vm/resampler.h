@@ -0,0 +1,149 @@
+/*
+	Skelton for retropc emulator
+
+	Author : agent
+	Date   : 2026.10.19-
+
+	[ polyphase resampler ]
+*/
+
+#ifndef _RESAMPLER_H_
+#define _RESAMPLER_H_
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common.h"
+
+// the sound device renders samples at its own rate to the render buffer,
+// and they are converted to the host rate with windowed sinc filter.
+// the filter of the position of output sample is interpolated from RESAMPLER_PHASES phases.
+// the output is delayed by taps / 2 samples of the device rate.
+
+#define RESAMPLER_PHASE_BITS	8
+#define RESAMPLER_PHASES	(1 << RESAMPLER_PHASE_BITS)
+#define RESAMPLER_TAPS		32	// when the rates are same
+#define RESAMPLER_MAX_TAPS	128
+
+class RESAMPLER
+{
+private:
+	int taps;
+	float* kernel;		// [RESAMPLER_PHASES + 1][taps]
+	int32_t* render;	// samples rendered by the device (L, R)
+	float* input_l;
+	float* input_r;
+	int count;
+	uint64_t step, pos;	// position in the input samples, 32.32 fixed point
+	
+public:
+	// max_samples = max output samples mixed at once
+	RESAMPLER(int in_rate, int out_rate, int max_samples)
+	{
+		const double pi = 3.14159265358979323846;
+		double ratio = (in_rate > out_rate) ? (double)out_rate / (double)in_rate : 1.0;
+		double cutoff = 0.9 * ratio;	// 0.45 * lower sample rate
+		
+		taps = ((int)ceil(RESAMPLER_TAPS / ratio) + 3) & ~3;
+		if(taps > RESAMPLER_MAX_TAPS) {
+			taps = RESAMPLER_MAX_TAPS;
+		}
+		kernel = (float*)malloc((RESAMPLER_PHASES + 1) * taps * sizeof(float));
+		for(int p = 0; p <= RESAMPLER_PHASES; p++) {
+			double h[RESAMPLER_MAX_TAPS], sum = 0;
+			for(int t = 0; t < taps; t++) {
+				double x = t - (taps / 2 - 1) - (double)p / RESAMPLER_PHASES;
+				double s = (x == 0) ? 1.0 : sin(pi * x * cutoff) / (pi * x * cutoff);
+				double w = 0.42 + 0.5 * cos(2.0 * pi * x / taps) + 0.08 * cos(4.0 * pi * x / taps);
+				sum += (h[t] = s * w);
+			}
+			// the sum of each phase should be 1.0 not to make dc offset
+			for(int t = 0; t < taps; t++) {
+				kernel[p * taps + t] = (float)(h[t] / sum);
+			}
+		}
+		step = ((uint64_t)in_rate << 32) / out_rate;
+		
+		int size = (int)((step * max_samples) >> 32) + taps + 2;
+		render = (int32_t*)malloc(size * sizeof(int32_t) * 2);
+		input_l = (float*)malloc(size * sizeof(float));
+		input_r = (float*)malloc(size * sizeof(float));
+		clear();
+	}
+	~RESAMPLER()
+	{
+		free(kernel);
+		free(render);
+		free(input_l);
+		free(input_r);
+	}
+	void clear()
+	{
+		memset(input_l, 0, (taps - 1) * sizeof(float));
+		memset(input_r, 0, (taps - 1) * sizeof(float));
+		count = taps - 1;
+		pos = 0;
+	}
+	// returns the number of samples that the device should render for the output samples
+	int get_input_samples(int samples)
+	{
+		if(samples > 0) {
+			int needed = (int)((pos + step * (samples - 1)) >> 32) + taps;
+			if(needed > count) {
+				return needed - count;
+			}
+		}
+		return 0;
+	}
+	// returns the cleared buffer to render the input samples
+	int32_t* get_render_buffer(int input_samples)
+	{
+		memset(render, 0, input_samples * sizeof(int32_t) * 2);
+		return render;
+	}
+	// converts the rendered input samples, and adds the output samples to the buffer
+	void mix(int32_t* buffer, int samples, int input_samples)
+	{
+		float* dest_l = input_l + count;
+		float* dest_r = input_r + count;
+		
+		for(int i = 0; i < input_samples; i++) {
+			dest_l[i] = (float)render[i * 2    ];
+			dest_r[i] = (float)render[i * 2 + 1];
+		}
+		count += input_samples;
+		
+		for(int i = 0; i < samples; i++) {
+			int index = (int)(pos >> 32);
+			const float* k0 = kernel + ((int)(pos >> (32 - RESAMPLER_PHASE_BITS)) & (RESAMPLER_PHASES - 1)) * taps;
+			const float* k1 = k0 + taps;
+			const float* src_l = input_l + index;
+			const float* src_r = input_r + index;
+			float frac = (float)((uint32_t)pos << RESAMPLER_PHASE_BITS) * (1.0f / 4294967296.0f);
+			float sum_l = 0, sum_r = 0;
+__DECL_VECTORIZED_LOOP
+			for(int t = 0; t < taps; t++) {
+				float k = k0[t] + (k1[t] - k0[t]) * frac;
+				sum_l += k * src_l[t];
+				sum_r += k * src_r[t];
+			}
+			*buffer++ += (int32_t)floorf(sum_l + 0.5f); // L
+			*buffer++ += (int32_t)floorf(sum_r + 0.5f); // R
+			pos += step;
+		}
+		
+		// remove the samples that are not used any more
+		int used = (int)(pos >> 32);
+		if(used > count) {
+			used = count;
+		}
+		if(used > 0) {
+			count -= used;
+			memmove(input_l, input_l + used, count * sizeof(float));
+			memmove(input_r, input_r + used, count * sizeof(float));
+			pos -= (uint64_t)used << 32;
+		}
+	}
+};
+
+#endif
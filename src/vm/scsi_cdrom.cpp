@@ -551,15 +551,16 @@ bool SCSI_CDROM::read_buffer(int length)
 			set_sense_code(SCSI_SENSE_ILLGLBLKADDR); //SCSI_SENSE_NORECORDFND
 			return false;
 		}
-		for(int i = 0; i < tmp_length; i++) {
-			if(offset >= 16 && offset < 16 + logical_block_size()) {
-				int value = tmp_buffer[i];
-				buffer->write(value);
-				length--;
-			}
-			position++;
-			offset = (offset + 1) % 2352;
+		// copy user data (offset 16 to 16 + logical block size) in this sector
+		int data_start = (offset < 16) ? 16 - offset : 0;
+		int data_end = min(16 + (int)logical_block_size() - (int)offset, tmp_length);
+		
+		if(data_end > data_start) {
+			buffer->write_block(tmp_buffer + data_start, data_end - data_start);
+			length -= data_end - data_start;
 		}
+		position += tmp_length;
+		offset = 0;
 		access = true;
 	}
 	set_sense_code(SCSI_SENSE_NOSENSE);
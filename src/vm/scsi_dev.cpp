@@ -16,7 +16,7 @@
 
 void SCSI_DEV::initialize()
 {
-	buffer = new FIFO(SCSI_BUFFER_SIZE);
+	buffer = new RING_BUFFER<uint8_t>(SCSI_BUFFER_SIZE);
 	phase = SCSI_PHASE_BUS_FREE;
 }
 
@@ -31,6 +31,9 @@ void SCSI_DEV::reset()
 	data_bus = 0;
 	sel_status = atn_status = ack_status = rst_status = false;
 	selected = atn_pending = false;
+	dmae_status = now_burst = false;
+	burst_count = 0;
+	next_burst_req = -1;
 	
 	event_sel = event_phase = event_req = -1;
 	set_phase(SCSI_PHASE_BUS_FREE);
@@ -167,7 +170,11 @@ void SCSI_DEV::write_signal(int id, uint32_t data, uint32_t mask)
 					break;
 				}
 				if(phase == SCSI_PHASE_DATA_OUT || phase == SCSI_PHASE_DATA_IN) {
-					set_req_delay(0, data_req_delay); // thanks Mr.Sato
+					if(dmae_status) {
+						set_req_burst(0);
+					} else {
+						set_req_delay(0, data_req_delay); // thanks Mr.Sato
+					}
 				} else {
 					set_req_delay(0, 0.1);
 				}
@@ -197,10 +204,13 @@ void SCSI_DEV::write_signal(int id, uint32_t data, uint32_t mask)
 							case SCSI_CMD_WRITE10:
 							case SCSI_CMD_WRITE12:
 								// request to write next data
-								{
-									next_req_usec += 1000000.0 / bytes_per_sec;
+								next_req_usec += 1000000.0 / bytes_per_sec;
+								if(dmae_status && ++burst_count < (int)physical_block_size()) {
+									set_req_burst(1);
+								} else {
 									double usec = next_req_usec - get_passed_usec(first_req_clock);
 									set_req_delay(1, (usec > 1.0) ? usec : 1.0);
+									burst_count = 0;
 								}
 								break;
 							default:
@@ -244,10 +254,13 @@ void SCSI_DEV::write_signal(int id, uint32_t data, uint32_t mask)
 							case SCSI_CMD_READ6:
 							case SCSI_CMD_READ10:
 							case SCSI_CMD_READ12:
-								{
-									next_req_usec += 1000000.0 / bytes_per_sec;
+								next_req_usec += 1000000.0 / bytes_per_sec;
+								if(dmae_status && ++burst_count < (int)physical_block_size()) {
+									set_req_burst(1);
+								} else {
 									double usec = next_req_usec - get_passed_usec(first_req_clock);
 									set_req_delay(1, (usec > 1.0) ? usec : 1.0);
+									burst_count = 0;
 								}
 								break;
 							default:
@@ -310,6 +323,10 @@ void SCSI_DEV::write_signal(int id, uint32_t data, uint32_t mask)
 		}
 		break;
 		
+	case SIG_SCSI_DMAE:
+		dmae_status = ((data & mask) != 0);
+		break;
+		
 	case SIG_SCSI_RST:
 		{
 			bool prev_status = rst_status;
@@ -376,6 +393,7 @@ void SCSI_DEV::set_phase(int value)
 		selected = false;
 	} else {
 		first_req_clock = 0;
+		burst_count = 0;
 //		set_bsy(true);
 		set_req_delay(1, 10.0);
 	}
@@ -466,6 +484,25 @@ void SCSI_DEV::set_req_delay(int value, double usec)
 	}
 }
 
+void SCSI_DEV::set_req_burst(int value)
+{
+	// the host adaptor transfers data by dma and handshakes synchronously,
+	// so change req without event in one physical block and charge the elapsed time
+	// of the whole block to the next req event.
+	// req is changed after the current ack signal is processed, not in the nested call
+	next_burst_req = value;
+	
+	if(!now_burst) {
+		now_burst = true;
+		while(next_burst_req != -1) {
+			int req = next_burst_req;
+			next_burst_req = -1;
+			set_req(req);
+		}
+		now_burst = false;
+	}
+}
+
 int SCSI_DEV::get_command_length(int value)
 {
 	switch((value >> 5) & 7) {
@@ -834,7 +871,7 @@ bool SCSI_DEV::write_buffer(int length)
 	return true;
 }
 
-#define STATE_VERSION	2
+#define STATE_VERSION	3
 
 bool SCSI_DEV::process_state(FILEIO* state_fio, bool loading)
 {
@@ -851,6 +888,8 @@ bool SCSI_DEV::process_state(FILEIO* state_fio, bool loading)
 	state_fio->StateValue(rst_status);
 	state_fio->StateValue(selected);
 	state_fio->StateValue(atn_pending);
+	state_fio->StateValue(dmae_status);
+	state_fio->StateValue(burst_count);
 	state_fio->StateValue(phase);
 	state_fio->StateValue(next_phase);
 	state_fio->StateValue(next_req);
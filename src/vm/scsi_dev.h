@@ -134,7 +134,7 @@ static const _TCHAR* scsi_phase_name[9] = {
 #define SCSI_SENSE_ILLGLBLKADDR	0x21	// Illegal Block Address
 #define SCSI_SENSE_WRITEPROTCT	0x27	// Write Protected
 
-class FIFO;
+template <class T> class RING_BUFFER;
 
 class SCSI_DEV : public DEVICE
 {
@@ -150,6 +150,12 @@ private:
 	bool sel_status, atn_status, ack_status, rst_status;
 	bool selected, atn_pending;
 	
+	// burst transfer with dma
+	bool dmae_status;
+	int burst_count;
+	int next_burst_req;
+	bool now_burst;
+	
 	int phase, next_phase, next_req;
 	int event_sel, event_phase, event_req;
 	uint32_t first_req_clock;
@@ -211,6 +217,7 @@ public:
 	void set_msg(int value);
 	void set_req(int value);
 	void set_req_delay(int value, double usec);
+	void set_req_burst(int value);
 	
 	virtual void reset_device() {}
 	virtual bool is_device_existing()
@@ -253,7 +260,7 @@ public:
 	uint8_t command[12];
 	int command_index;
 	
-	FIFO *buffer;
+	RING_BUFFER<uint8_t> *buffer;
 	uint64_t position, remain;
 	
 	char vendor_id[8 + 1];
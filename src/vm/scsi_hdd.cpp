@@ -148,9 +148,7 @@ bool SCSI_HDD::read_buffer(int length)
 			set_sense_code(SCSI_SENSE_ILLGLBLKADDR); //SCSI_SENSE_NORECORDFND
 			return false;
 		}
-		for(int i = 0; i < tmp_length; i++) {
-			buffer->write(tmp_buffer[i]);
-		}
+		buffer->write_block(tmp_buffer, tmp_length);
 		length -= tmp_length;
 		position += tmp_length;
 		cur_position[drv] = position - 1;
@@ -162,10 +160,8 @@ bool SCSI_HDD::read_buffer(int length)
 bool SCSI_HDD::write_buffer(int length)
 {
 	if(!(command[0] == SCSI_CMD_WRITE6 || command[0] == SCSI_CMD_WRITE10 || command[0] == SCSI_CMD_WRITE12)) {
-		for(int i = 0; i < length; i++) {
-			buffer->read();
-			position++;
-		}
+		buffer->remove(length);
+		position += length;
 		set_sense_code(SCSI_SENSE_NOSENSE);
 		return true;
 	}
@@ -177,16 +173,19 @@ bool SCSI_HDD::write_buffer(int length)
 		return false;
 	}
 	while(length > 0) {
-		uint8_t tmp_buffer[SCSI_BUFFER_SIZE];
-		int tmp_length = min(length, (int)sizeof(tmp_buffer));
+		// write the contiguous data in buffer directly
+		int tmp_length = length;
+		uint8_t *tmp_buffer = buffer->peek_span(&tmp_length);
 		
-		for(int i = 0; i < tmp_length; i++) {
-			tmp_buffer[i] = buffer->read();
+		if(tmp_length <= 0) {
+			set_sense_code(SCSI_SENSE_ILLGLBLKADDR); //SCSI_SENSE_NORECORDFND
+			return false;
 		}
 		if(!unit->write_buffer((long)position, tmp_length, tmp_buffer)) {
 			set_sense_code(SCSI_SENSE_ILLGLBLKADDR); //SCSI_SENSE_NORECORDFND
 			return false;
 		}
+		buffer->remove(tmp_length);
 		length -= tmp_length;
 		position += tmp_length;
 		cur_position[drv] = position - 1;
@@ -79,8 +79,11 @@ void SCSI_HOST::write_signal(int id, uint32_t data, uint32_t mask)
 		#ifdef _SCSI_DEBUG_LOG
 //			this->out_debug_log(_T("[SCSI_HOST] ACK = %d\n"), (data & mask) ? 1 : 0);
 		#endif
-		write_signals(&outputs_ack, (data & mask) ? 0xffffffff : 0);
 		ack_status = data & mask;
+		// devices may respond synchronously in dma burst transfer,
+		// so send ack to devices after the adaptor has received it
+		write_signals(&outputs_ack, (data & mask) ? 0xffffffff : 0);
+		write_signals(&outputs_tgt_ack, (data & mask) ? 0xffffffff : 0);
 		break;
 		
 	case SIG_SCSI_RST:
@@ -90,6 +93,13 @@ void SCSI_HOST::write_signal(int id, uint32_t data, uint32_t mask)
 		write_signals(&outputs_rst, (data & mask) ? 0xffffffff : 0);
 		break;
 		
+	case SIG_SCSI_DMAE:
+		#ifdef _SCSI_DEBUG_LOG
+			this->out_debug_log(_T("[SCSI_HOST] DMAE = %d\n"), (data & mask) ? 1 : 0);
+		#endif
+		write_signals(&outputs_dmae, (data & mask) ? 0xffffffff : 0);
+		break;
+		
 	// from target
 	case SIG_SCSI_DAT:
 		data_reg &= ~mask;
@@ -31,6 +31,8 @@ private:
 	outputs_t outputs_atn;
 	outputs_t outputs_ack;
 	outputs_t outputs_rst;
+	outputs_t outputs_dmae;
+	outputs_t outputs_tgt_ack;
 	
 	uint32_t data_reg;
 	uint32_t bsy_status, cd_status, io_status, msg_status, req_status, ack_status;
@@ -56,6 +58,8 @@ public:
 		initialize_output_signals(&outputs_atn);
 		initialize_output_signals(&outputs_ack);
 		initialize_output_signals(&outputs_rst);
+		initialize_output_signals(&outputs_dmae);
+		initialize_output_signals(&outputs_tgt_ack);
 		
 		set_device_name(_T("SCSI Base Initiator"));
 	}
@@ -116,8 +120,9 @@ public:
 #endif
 		register_output_signal(&outputs_sel, device, SIG_SCSI_SEL, 1);
 		register_output_signal(&outputs_atn, device, SIG_SCSI_ATN, 1);
-		register_output_signal(&outputs_ack, device, SIG_SCSI_ACK, 1);
+		register_output_signal(&outputs_tgt_ack, device, SIG_SCSI_ACK, 1);
 		register_output_signal(&outputs_rst, device, SIG_SCSI_RST, 1);
+		register_output_signal(&outputs_dmae, device, SIG_SCSI_DMAE, 1);
 	}
 };
 
@@ -8,6 +8,7 @@
 */
 
 #include "sn76489an.h"
+#include "vgm_logger.h"
 
 #ifdef HAS_SN76489
 // SN76489
@@ -26,6 +27,7 @@ void SN76489AN::initialize()
 {
 	mute = false;
 	cs = we = true;
+	memset(blep_level, 0, sizeof(blep_level));
 }
 
 void SN76489AN::reset()
@@ -43,10 +45,36 @@ void SN76489AN::reset()
 	}
 	noise_gen = NOISE_FB;
 	ch[3].signal = false;
+	blep.clear();
+	memset(blep_level, 0, sizeof(blep_level));
+}
+
+void SN76489AN::log_data(uint32_t data)
+{
+	VGM_LOGGER* logger = emu->get_vgm_logger();
+	uint32_t clock = get_current_clock(), clocks_per_sec = get_event_clocks();
+	
+	if(!logger->is_registered(this)) {
+		// log the current registers
+		for(int i = 0; i < 8; i++) {
+			logger->write(VGM_SN76489, this, chip_clock, clock, clocks_per_sec, 0, 0, 0x80 | (i << 4) | (regs[i] & 0x0f));
+			if(i == 0 || i == 2 || i == 4) {
+				logger->write(VGM_SN76489, this, chip_clock, clock, clocks_per_sec, 0, 0, (regs[i] >> 4) & 0x3f);
+			}
+		}
+		if(!(data & 0x80)) {
+			// restore the latched register
+			logger->write(VGM_SN76489, this, chip_clock, clock, clocks_per_sec, 0, 0, 0x80 | ((index & 7) << 4) | (regs[index & 7] & 0x0f));
+		}
+	}
+	logger->write(VGM_SN76489, this, chip_clock, clock, clocks_per_sec, 0, 0, data);
 }
 
 void SN76489AN::write_io8(uint32_t addr, uint32_t data)
 {
+	if(emu->get_vgm_logger() != NULL) {
+		log_data(data);
+	}
 	if(data & 0x80) {
 		index = (data >> 4) & 7;
 		int c = index >> 1;
@@ -132,17 +160,39 @@ void SN76489AN::mix(int32_t* buffer, int cnt)
 	if(mute) {
 		return;
 	}
-	for(int i = 0; i < cnt; i++) {
-		int32_t vol_l = 0, vol_r = 0;
+	while(cnt > 0) {
+		int samples = min(cnt, BLEP_BLOCK);
+		int total = samples * diff;
+		
 		for(int j = 0; j < 4; j++) {
 			if(!ch[j].volume) {
+				set_blep_level(j, 0, 0);
 				continue;
 			}
-			bool prev_signal = ch[j].signal;
-			int prev_count = ch[j].count;
-			ch[j].count -= diff;
-			if(ch[j].count < 0) {
-				ch[j].count += ch[j].period << 8;
+			int period = ch[j].period << 8;
+			if(j != 3 && period < diff) {
+				// tone above the nyquist frequency is not output, only the phase is advanced
+				set_blep_level(j, 0, 0);
+				if(ch[j].count < total) {
+					int remain = total - ch[j].count;
+					int edges = 1 + (remain - 1) / period;
+					if(edges & 1) {
+						ch[j].signal = !ch[j].signal;
+					}
+					ch[j].count = edges * period - remain;
+				} else {
+					ch[j].count -= total;
+				}
+				continue;
+			}
+			int32_t volume = ch[j].volume;
+			set_blep_level(j, 0, ch[j].signal ? volume : -volume);
+			
+			// count is decreased by diff in each sample, and the signal is changed when it becomes negative
+			int remain = total;
+			while(ch[j].count < remain) {
+				remain -= ch[j].count;
+				ch[j].count = period;
 				if(j == 3) {
 					if(((noise_gen & NOISE_DST_TAP) ? 1 : 0) ^ (((noise_gen & NOISE_SRC_TAP) ? 1 : 0) * NOISE_MODE)) {
 						noise_gen >>= 1;
@@ -154,16 +204,14 @@ void SN76489AN::mix(int32_t* buffer, int cnt)
 				} else {
 					ch[j].signal = !ch[j].signal;
 				}
+				uint32_t time = (uint32_t)(((uint64_t)(total - remain) << BLEP_TIME_BITS) / diff);
+				set_blep_level(j, time, ch[j].signal ? volume : -volume);
 			}
-			int32_t sample = (prev_signal != ch[j].signal && prev_count < diff) ? (ch[j].volume * (2 * prev_count - diff)) / diff : ch[j].volume;
-			int32_t vol_tmp_l = apply_volume(sample, volume_l);
-			int32_t vol_tmp_r = apply_volume(sample, volume_r);
-			
-			vol_l += prev_signal ? vol_tmp_l : -vol_tmp_l;
-			vol_r += prev_signal ? vol_tmp_r : -vol_tmp_r;
+			ch[j].count -= remain;
 		}
-		*buffer++ += vol_l; // L
-		*buffer++ += vol_r; // R
+		blep.mix(buffer, samples, volume_l, volume_r);
+		buffer += samples * 2;
+		cnt -= samples;
 	}
 }
 
@@ -183,6 +231,7 @@ void SN76489AN::initialize_sound(int rate, int clock, int volume)
 	}
 	volume_table[15] = 0;
 	diff = (int)(16.0 * (double)clock / (double)rate + 0.5);
+	chip_clock = clock;
 }
 
 #define STATE_VERSION	2
@@ -195,6 +244,10 @@ bool SN76489AN::process_state(FILEIO* state_fio, bool loading)
 	if(!state_fio->StateCheckInt32(this_device_id)) {
 		return false;
 	}
+	if(loading) {
+		blep.clear();
+		memset(blep_level, 0, sizeof(blep_level));
+	}
 	state_fio->StateArray(regs, sizeof(regs), 1);
 	state_fio->StateValue(index);
 	for(int i = 0; i < array_length(ch); i++) {
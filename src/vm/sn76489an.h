@@ -13,6 +13,7 @@
 #include "vm.h"
 #include "../emu.h"
 #include "device.h"
+#include "blep_buffer.h"
 
 #define SIG_SN76489AN_MUTE	0
 #define SIG_SN76489AN_DATA	1
@@ -38,8 +39,19 @@ private:
 	int diff;
 	bool mute, cs, we;
 	uint8_t val;
+	int chip_clock;
 	int volume_l, volume_r;
 	
+	// output level of each channel in blep buffer
+	BLEP_BUFFER blep;
+	int32_t blep_level[4];
+	void set_blep_level(int c, uint32_t time, int32_t level)
+	{
+		blep.add_delta(time, level - blep_level[c]);
+		blep_level[c] = level;
+	}
+	void log_data(uint32_t data);
+	
 public:
 	SN76489AN(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
 	{
@@ -58,6 +70,10 @@ public:
 	void write_io8(uint32_t addr, uint32_t data);
 	void write_signal(int id, uint32_t data, uint32_t mask);
 	void mix(int32_t* buffer, int cnt);
+	bool is_mix_thread_safe()
+	{
+		return true;
+	}
 	void set_volume(int ch, int decibel_l, int decibel_r);
 	bool process_state(FILEIO* state_fio, bool loading);
 	
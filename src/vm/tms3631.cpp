@@ -28,6 +28,9 @@ void TMS3631::reset()
 	memset(ch, 0, sizeof(ch));
 	channel = 0;
 	set_key = false;
+	blep_l.clear();
+	blep_r.clear();
+	memset(blep_level, 0, sizeof(blep_level));
 }
 
 void TMS3631::write_signal(int id, uint32_t data, uint32_t mask)
@@ -64,36 +67,30 @@ void TMS3631::write_signal(int id, uint32_t data, uint32_t mask)
 void TMS3631::mix(int32_t* buffer, int cnt)
 {
 	// from tms3631g.c
-	for(int i = 0; i < cnt; i++) {
-		int data = 0;
-		for(int j = 0; j < 2; j++) {
-			if((maskreg & (1 << j)) && ch[j].freq != 0) {
-				for(int k = 0; k < 4; k++) {
-					ch[j].count += ch[j].freq;
-					data += (ch[j].count & 0x10000) ? 1 : -1;
-				}
-			}
-		}
-		int vol_l = data * vol;
-		int vol_r = data * vol;
-		for(int j = 2; j < 5; j++) {
+	// the counter is advanced by 4 * freq in each sample, and the output of channel
+	// is changed when the counter crosses the boundary of 0x10000
+	while(cnt > 0) {
+		int samples = min(cnt, BLEP_BLOCK);
+		
+		for(int j = 0; j < 8; j++) {
 			if((maskreg & (1 << j)) && ch[j].freq != 0) {
-				for(int k = 0; k < 4; k++) {
-					ch[j].count += ch[j].freq;
-					vol_l += feet[(ch[j].count >> 16) & 15];
+				uint64_t count = ch[j].count;
+				uint64_t step = (uint64_t)ch[j].freq * 4;
+				uint64_t end = count + step * samples;
+				
+				set_blep_level(j, 0, get_level(j, ch[j].count));
+				for(uint64_t next = (count | 0xffff) + 1; next < end; next += 0x10000) {
+					set_blep_level(j, (uint32_t)(((next - count) << BLEP_TIME_BITS) / step), get_level(j, (uint32_t)next));
 				}
+				ch[j].count = (uint32_t)end;
+			} else {
+				set_blep_level(j, 0, 0);
 			}
 		}
-		for(int j = 5; j < 8; j++) {
-			if((maskreg & (1 << j)) && ch[j].freq != 0) {
-				for(int k = 0; k < 4; k++) {
-					ch[j].count += ch[j].freq;
-					vol_r += feet[(ch[j].count >> 16) & 15];
-				}
-			}
-		}
-		*buffer++ += apply_volume(vol_l, volume_l); // L
-		*buffer++ += apply_volume(vol_r, volume_r); // R
+		blep_l.mix(buffer, samples, volume_l, 0);
+		blep_r.mix(buffer, samples, 0, volume_r);
+		buffer += samples * 2;
+		cnt -= samples;
 	}
 }
 
@@ -139,6 +136,13 @@ bool TMS3631::process_state(FILEIO* state_fio, bool loading)
 	}
 	state_fio->StateValue(channel);
 	state_fio->StateValue(set_key);
+	
+	// post process
+	if(loading) {
+		blep_l.clear();
+		blep_r.clear();
+		memset(blep_level, 0, sizeof(blep_level));
+	}
 	return true;
 }
 
@@ -14,6 +14,7 @@
 #include "vm.h"
 #include "../emu.h"
 #include "device.h"
+#include "blep_buffer.h"
 
 #define SIG_TMS3631_ENVELOP1	0
 #define SIG_TMS3631_ENVELOP2	1
@@ -36,10 +37,30 @@ private:
 	int vol, feet[16];
 	int volume_l, volume_r;
 	
+	// output level of each channel in blep buffers
+	// ch.0-1 are output to both sides, ch.2-4 to left and ch.5-7 to right
+	BLEP_BUFFER blep_l, blep_r;
+	int32_t blep_level[8];
+	int32_t get_level(int c, uint32_t count)
+	{
+		return (c < 2) ? ((count & 0x10000) ? 4 * vol : -4 * vol) : 4 * feet[(count >> 16) & 15];
+	}
+	void set_blep_level(int c, uint32_t time, int32_t level)
+	{
+		if(c < 5) {
+			blep_l.add_delta(time, level - blep_level[c]);
+		}
+		if(c < 2 || c >= 5) {
+			blep_r.add_delta(time, level - blep_level[c]);
+		}
+		blep_level[c] = level;
+	}
+	
 public:
 	TMS3631(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
 	{
 		volume_l = volume_r = 1024;
+		memset(blep_level, 0, sizeof(blep_level));
 		set_device_name(_T("TMS3631 SSG"));
 	}
 	~TMS3631() {}
@@ -10,6 +10,7 @@
 */
 
 #include "tms9918a.h"
+#include "planar.h"
 #ifdef USE_DEBUGGER
 #include "debugger.h"
 #endif
@@ -30,6 +31,10 @@ static const scrntype_t palette_pc[16] = {
 
 void TMS9918A::initialize()
 {
+	memset(sprite_screen, 0, sizeof(sprite_screen));
+	memset(sprite_line, 0, sizeof(sprite_line));
+	render_redraw = true;
+	
 	// register event
 	register_vline_event(this);
 	
@@ -52,6 +57,7 @@ void TMS9918A::reset()
 	color_table = pattern_table = name_table = 0;
 	sprite_pattern = sprite_attrib = 0;
 	color_mask = pattern_mask = 0;
+	render_redraw = true;
 }
 
 void TMS9918A::write_io8(uint32_t addr, uint32_t data)
@@ -119,7 +125,11 @@ uint32_t TMS9918A::read_io8(uint32_t addr)
 
 void TMS9918A::write_via_debugger_data8(uint32_t addr, uint32_t data)
 {
-	vram[addr & ADDR_MASK] = data;
+	addr &= ADDR_MASK;
+	if(vram[addr] != data) {
+		vram[addr] = data;
+		vram_dirty[addr >> 3] = 1;
+	}
 }
 
 uint32_t TMS9918A::read_via_debugger_data8(uint32_t addr)
@@ -217,46 +227,45 @@ void TMS9918A::draw_screen()
 		emu->get_video_buffer();
 	}
 #endif
+	// wait until the screen is rendered
+	emu->finish_render_lines();
+	
 	// update screen buffer
 #if SCREEN_WIDTH == 512
 	for(int y = 0, y2 = 0; y < 192; y++, y2 += 2) {
 		scrntype_t* dest0 = emu->get_screen_buffer(y2 + 0);
 		scrntype_t* dest1 = emu->get_screen_buffer(y2 + 1);
-		uint8_t* src = screen[y];
+		scrntype_t* src = screen[y];
 #if defined(TMS9918A_SUPER_IMPOSE) && !defined(USE_ALPHA_BLENDING_TO_IMPOSE)
 		if(now_super_impose) {
+			uint8_t* src_index = screen_index[y];
 			for(int x = 0, x2 = 0; x < 256; x++, x2 += 2) {
-				uint8_t c = src[x] & 0x0f;
-				if(c != 0) {
-					dest0[x2] = dest0[x2 + 1] = dest1[x2] = dest1[x2 + 1] = palette_pc[c];
+				if(src_index[x] != 0) {
+					dest0[x2] = dest0[x2 + 1] = dest1[x2] = dest1[x2 + 1] = src[x2];
 				}
 			}
 		} else
 #endif
 		{
-			for(int x = 0, x2 = 0; x < 256; x++, x2 += 2) {
-				dest0[x2] = dest0[x2 + 1] = palette_pc[src[x] & 0x0f];
-			}
-			my_memcpy(dest1, dest0, 512 * sizeof(scrntype_t));
+			my_memcpy(dest0, src, 512 * sizeof(scrntype_t));
+			my_memcpy(dest1, src, 512 * sizeof(scrntype_t));
 		}
 	}
 #else
 	for(int y = 0; y < 192; y++) {
 		scrntype_t* dest = emu->get_screen_buffer(y);
-		uint8_t* src = screen[y];
+		scrntype_t* src = screen[y];
 #if defined(TMS9918A_SUPER_IMPOSE) && !defined(USE_ALPHA_BLENDING_TO_IMPOSE)
 		if(now_super_impose) {
+			uint8_t* src_index = screen_index[y];
 			for(int x = 0; x < 256; x++) {
-				uint8_t c = src[x] & 0x0f;
-				if(c != 0) {
-					dest[x] = palette_pc[c];
+				if(src_index[x] != 0) {
+					dest[x] = src[x];
 				}
 			}
 		} else
 #endif
-		for(int x = 0; x < 256; x++) {
-			dest[x] = palette_pc[src[x] & 0x0f];
-		}
+		my_memcpy(dest, src, 256 * sizeof(scrntype_t));
 	}
 #endif
 }
@@ -264,45 +273,214 @@ void TMS9918A::draw_screen()
 void TMS9918A::event_vline(int v, int clock)
 {
 	if(v == 192) {
-		// create virtual screen
-		if(regs[1] & 0x40) {
+		// wait until the previous screen is rendered, and take a snapshot
+		emu->finish_render_lines();
+		update_snapshot();
+		
+		// sprite plane is drawn now to update the status register
+		for(int y = 0; y < 192; y++) {
+			if(sprite_line[y]) {
+				memset(sprite_screen[y], 0, sizeof(sprite_screen[y]));
+			}
+		}
+		memcpy(prev_sprite_line, sprite_line, sizeof(sprite_line));
+		memset(sprite_line, 0, sizeof(sprite_line));
+		
+		render_sprites = ((regs[1] & 0x50) == 0x40);
+		if(render_sprites) {
+			draw_sprites();
+		}
+		
+		// create virtual screen in worker threads
+		emu->start_render_lines(this, 192);
+		
+		// do interrupt
+		status_reg |= 0x80;
+		set_intstat((regs[1] & 0x20) != 0);
+	}
+}
+
+void TMS9918A::update_snapshot()
+{
+	// redraw all when the screen mode or the table address is changed
+	bool redraw = render_redraw || memcmp(render_regs, regs, sizeof(regs)) != 0;
+	
+	if(redraw) {
+		memcpy(render_vram, vram, sizeof(vram));
+	} else {
+		for(int i = 0; i < (TMS9918A_VRAM_SIZE >> 3); i++) {
+			if(vram_dirty[i]) {
+				memcpy(render_vram + (i << 3), vram + (i << 3), 8);
+			}
+		}
+	}
+	memcpy(render_regs, regs, sizeof(regs));
+	render_color_table = color_table;
+	render_pattern_table = pattern_table;
+	render_name_table = name_table;
+	render_color_mask = color_mask;
+	render_pattern_mask = pattern_mask;
+	
+	int mode = (render_regs[0] & 2) | ((render_regs[1] & 0x10) >> 4) | ((render_regs[1] & 8) >> 1);
+	update_pattern_cache(mode, redraw);
+	update_row_dirty(mode, redraw);
+	
+	memset(vram_dirty, 0, sizeof(vram_dirty));
+	render_redraw = false;
+}
+
+#define PATTERN_BLOCK(ofs) (((render_pattern_table + (ofs)) & ADDR_MASK) >> 3)
+#define COLOR_BLOCK(ofs) (((render_color_table + (ofs)) & ADDR_MASK) >> 3)
+
+void TMS9918A::update_pattern_cache(int mode, bool redraw)
+{
+	// decode the characters whose pattern or color is written
+	// the backdrop color is in regs[7], so all characters are decoded when it is changed
+	uint8_t backdrop = render_regs[7] & 0x0f;
+	
+	memset(pattern_updated, 0, sizeof(pattern_updated));
+	
+	switch(mode) {
+	case 0:
+		for(int code = 0; code < 256; code++) {
+			if(redraw || vram_dirty[PATTERN_BLOCK(code * 8)] || vram_dirty[COLOR_BLOCK(code >> 3)]) {
+				uint8_t* pattern_ptr = render_vram + render_pattern_table + code * 8;
+				uint8_t color = render_vram[render_color_table + (code >> 3)];
+				uint8_t fg = (color & 0xf0) ? (color >> 4) : backdrop;
+				uint8_t bg = (color & 0x0f) ? (color & 0x0f) : backdrop;
+				for(int yy = 0; yy < 8; yy++) {
+					uint8_t pattern = *pattern_ptr++;
+					for(int xx = 0; xx < 8; xx++) {
+						pattern_cache[code][yy][xx] = (pattern & (0x80 >> xx)) ? fg : bg;
+					}
+				}
+				pattern_updated[code] = true;
+			}
+		}
+		break;
+	case 2:
+		for(int code = 0; code < 768; code++) {
+			if(redraw || vram_dirty[PATTERN_BLOCK((code & render_pattern_mask) * 8)] || vram_dirty[COLOR_BLOCK((code & render_color_mask) * 8)]) {
+				uint8_t* pattern_ptr = render_vram + render_pattern_table + (code & render_pattern_mask) * 8;
+				uint8_t* color_ptr = render_vram + render_color_table + (code & render_color_mask) * 8;
+				for(int yy = 0; yy < 8; yy++) {
+					uint8_t pattern = *pattern_ptr++;
+					uint8_t color = *color_ptr++;
+					uint8_t fg = (color & 0xf0) ? (color >> 4) : backdrop;
+					uint8_t bg = (color & 0x0f) ? (color & 0x0f) : backdrop;
+					for(int xx = 0; xx < 8; xx++) {
+						pattern_cache[code][yy][xx] = (pattern & (0x80 >> xx)) ? fg : bg;
+					}
+				}
+				pattern_updated[code] = true;
+			}
+		}
+		break;
+	case 1:
+	case 3:
+		// text mode: only 6 pixels are used
+		for(int code = 0; code < ((mode == 1) ? 256 : 768); code++) {
+			int index = (mode == 1) ? code : (code & render_pattern_mask);
+			if(redraw || vram_dirty[PATTERN_BLOCK(index * 8)]) {
+				uint8_t* pattern_ptr = render_vram + render_pattern_table + index * 8;
+				uint8_t fg = render_regs[7] >> 4;
+				uint8_t bg = render_regs[7] & 0x0f;
+				for(int yy = 0; yy < 8; yy++) {
+					uint8_t pattern = *pattern_ptr++;
+					for(int xx = 0; xx < 6; xx++) {
+						pattern_cache[code][yy][xx] = (pattern & (0x80 >> xx)) ? fg : bg;
+					}
+				}
+				pattern_updated[code] = true;
+			}
+		}
+		break;
+	}
+}
+
+void TMS9918A::update_row_dirty(int mode, bool redraw)
+{
+	// the row is redrawn when its name table or the characters in it are changed
+	int columns = (mode == 1 || mode == 3) ? 40 : 32;
+	
+	for(int y = 0; y < 24; y++) {
+		bool dirty = redraw;
+		for(int x = 0; x < columns && !dirty; x++) {
+			uint16_t name = render_name_table + y * columns + x;
+			uint16_t code = render_vram[name];
+			if(vram_dirty[(name & ADDR_MASK) >> 3]) {
+				dirty = true;
+			} else if(mode == 0 || mode == 1) {
+				dirty = pattern_updated[code];
+			} else if(mode == 2 || mode == 3) {
+				dirty = pattern_updated[code + (y & 0xf8) * 32];
+			} else if(mode == 4) {
+				dirty = (vram_dirty[PATTERN_BLOCK(code * 8 + (y & 3) * 2)] != 0);
+			} else if(mode == 6) {
+				dirty = (vram_dirty[PATTERN_BLOCK(((code + (y & 3) * 2 + (y & 0xf8) * 32) & render_pattern_mask) * 8)] != 0);
+			}
+		}
+		row_dirty[y] = dirty;
+	}
+}
+
+void TMS9918A::render_lines(int top, int bottom)
+{
+	int mode = (render_regs[0] & 2) | ((render_regs[1] & 0x10) >> 4) | ((render_regs[1] & 8) >> 1);
+	uint8_t line[256];
+	
+	for(int y = top; y < bottom; y++) {
+		// skip the line if its characters and sprites are not changed
+		if(!row_dirty[y >> 3] && !sprite_line[y] && !prev_sprite_line[y]) {
+			continue;
+		}
+		if(render_regs[1] & 0x40) {
 			// draw character plane
-			int mode = (regs[0] & 2) | ((regs[1] & 0x10) >> 4) | ((regs[1] & 8) >> 1);
 			switch(mode) {
 			case 0:
-				draw_mode0();
+				draw_mode0(line, y);
 				break;
 			case 1:
-				draw_mode1();
+				draw_mode1(line, y);
 				break;
 			case 2:
-				draw_mode2();
+				draw_mode2(line, y);
 				break;
 			case 3:
-				draw_mode12();
+				draw_mode12(line, y);
 				break;
 			case 4:
-				draw_mode3();
+				draw_mode3(line, y);
 				break;
 			case 6:
-				draw_mode23();
+				draw_mode23(line, y);
 				break;
 			case 5:
 			case 7:
-				draw_modebogus();
+				draw_modebogus(line, y);
 				break;
 			}
 			// draw sprite plane
-			if((regs[1] & 0x50) == 0x40) {
-				draw_sprites();
+			if(sprite_line[y]) {
+				uint8_t* src = sprite_screen[y];
+				for(int x = 0; x < 256; x++) {
+					if(src[x]) {
+						line[x] = src[x];
+					}
+				}
 			}
 		} else {
-			memset(screen, 0, sizeof(screen));
+			memset(line, 0, sizeof(line));
 		}
-		
-		// do interrupt
-		status_reg |= 0x80;
-		set_intstat((regs[1] & 0x20) != 0);
+		// convert to rgb
+#if SCREEN_WIDTH == 512
+		chunky_to_rgb_x2(screen[y], line, palette_pc, 256);
+#else
+		chunky_to_rgb(screen[y], line, palette_pc, 256);
+#endif
+#if defined(TMS9918A_SUPER_IMPOSE) && !defined(USE_ALPHA_BLENDING_TO_IMPOSE)
+		memcpy(screen_index[y], line, sizeof(line));
+#endif
 	}
 }
 
@@ -316,165 +494,88 @@ void TMS9918A::set_intstat(bool val)
 	}
 }
 
-void TMS9918A::draw_mode0()
+void TMS9918A::draw_mode0(uint8_t* dest, int y)
 {
-	for(int y = 0, name = 0; y < 24; y++) {
-		for(int x = 0; x < 32; x++) {
-			uint16_t code = vram[name_table + (name++)];
-			uint8_t* pattern_ptr = vram + pattern_table + code * 8;
-			uint8_t color = vram[color_table + (code >> 3)];
-			uint8_t fg = (color & 0xf0) ? (color >> 4) : (regs[7] & 0x0f);
-			uint8_t bg = (color & 0x0f) ? (color & 0x0f) : (regs[7] & 0x0f);
-			for(int yy=0; yy < 8; yy++) {
-				uint8_t pattern = *pattern_ptr++;
-				uint8_t* buffer = screen[y * 8 + yy] + x * 8;
-				buffer[0] = (pattern & 0x80) ? fg : bg;
-				buffer[1] = (pattern & 0x40) ? fg : bg;
-				buffer[2] = (pattern & 0x20) ? fg : bg;
-				buffer[3] = (pattern & 0x10) ? fg : bg;
-				buffer[4] = (pattern & 0x08) ? fg : bg;
-				buffer[5] = (pattern & 0x04) ? fg : bg;
-				buffer[6] = (pattern & 0x02) ? fg : bg;
-				buffer[7] = (pattern & 0x01) ? fg : bg;
-			}
-		}
+	uint8_t* name_ptr = render_vram + render_name_table + (y >> 3) * 32;
+	for(int x = 0; x < 32; x++) {
+		memcpy(dest + x * 8, pattern_cache[name_ptr[x]][y & 7], 8);
 	}
 }
 
-void TMS9918A::draw_mode1()
+void TMS9918A::draw_mode1(uint8_t* dest, int y)
 {
-	uint8_t fg = regs[7] >> 4;
-	uint8_t bg = regs[7] & 0x0f;
-	memset(screen, bg, sizeof(screen));
-	for(int y = 0, name = 0; y < 24; y++) {
-		for(int x = 0; x < 40; x++) {
-			uint16_t code = vram[name_table + (name++)];
-			uint8_t* pattern_ptr = vram + pattern_table + code * 8;
-			for(int yy = 0; yy < 8; yy++) {
-				uint8_t pattern = *pattern_ptr++;
-				uint8_t* buffer = screen[y * 8 + yy] + x * 6 + 8;
-				buffer[0] = (pattern & 0x80) ? fg : bg;
-				buffer[1] = (pattern & 0x40) ? fg : bg;
-				buffer[2] = (pattern & 0x20) ? fg : bg;
-				buffer[3] = (pattern & 0x10) ? fg : bg;
-				buffer[4] = (pattern & 0x08) ? fg : bg;
-				buffer[5] = (pattern & 0x04) ? fg : bg;
-			}
-		}
+	uint8_t* name_ptr = render_vram + render_name_table + (y >> 3) * 40;
+	memset(dest, render_regs[7] & 0x0f, 256);
+	for(int x = 0; x < 40; x++) {
+		memcpy(dest + x * 6 + 8, pattern_cache[name_ptr[x]][y & 7], 6);
 	}
 }
 
-void TMS9918A::draw_mode2()
+void TMS9918A::draw_mode2(uint8_t* dest, int y)
 {
-	for(int y = 0, name = 0; y < 24; y++) {
-		for(int x = 0; x < 32; x++) {
-			uint16_t code = vram[name_table + (name++)] + (y & 0xf8) * 32;
-			uint8_t* pattern_ptr = vram + pattern_table + (code & pattern_mask) * 8;
-			uint8_t* color_ptr = vram + color_table + (code & color_mask) * 8;
-			for(int yy = 0; yy < 8; yy++) {
-				uint8_t pattern = *pattern_ptr++;
-				uint8_t color = *color_ptr++;
-				uint8_t fg = (color & 0xf0) ? (color >> 4) : (regs[7] & 0x0f);
-				uint8_t bg = (color & 0x0f) ? (color & 0x0f) : (regs[7] & 0x0f);
-				uint8_t* buffer = screen[y * 8 + yy] + x * 8;
-				buffer[0] = (pattern & 0x80) ? fg : bg;
-				buffer[1] = (pattern & 0x40) ? fg : bg;
-				buffer[2] = (pattern & 0x20) ? fg : bg;
-				buffer[3] = (pattern & 0x10) ? fg : bg;
-				buffer[4] = (pattern & 0x08) ? fg : bg;
-				buffer[5] = (pattern & 0x04) ? fg : bg;
-				buffer[6] = (pattern & 0x02) ? fg : bg;
-				buffer[7] = (pattern & 0x01) ? fg : bg;
-			}
-		}
+	uint8_t* name_ptr = render_vram + render_name_table + (y >> 3) * 32;
+	int bank = ((y >> 3) & 0xf8) * 32;
+	for(int x = 0; x < 32; x++) {
+		memcpy(dest + x * 8, pattern_cache[name_ptr[x] + bank][y & 7], 8);
 	}
 }
 
-void TMS9918A::draw_mode12()
+void TMS9918A::draw_mode12(uint8_t* dest, int y)
 {
-	uint8_t fg = regs[7] >> 4;
-	uint8_t bg = regs[7] & 0x0f;
-	memset(screen, bg, sizeof(screen));
-	for(int y = 0, name = 0; y < 24; y++) {
-		for(int x = 0; x < 40; x++) {
-			uint16_t code = vram[name_table + (name++)] + (y & 0xf8) * 32;
-			uint8_t* pattern_ptr = vram + pattern_table + (code & pattern_mask) * 8;
-			for(int yy = 0; yy < 8; yy++) {
-				uint8_t pattern = *pattern_ptr++;
-				uint8_t* buffer = screen[y * 8 + yy] + x * 6 + 8;
-				buffer[0] = (pattern & 0x80) ? fg : bg;
-				buffer[1] = (pattern & 0x40) ? fg : bg;
-				buffer[2] = (pattern & 0x20) ? fg : bg;
-				buffer[3] = (pattern & 0x10) ? fg : bg;
-				buffer[4] = (pattern & 0x08) ? fg : bg;
-				buffer[5] = (pattern & 0x04) ? fg : bg;
-			}
-		}
+	uint8_t* name_ptr = render_vram + render_name_table + (y >> 3) * 40;
+	int bank = ((y >> 3) & 0xf8) * 32;
+	memset(dest, render_regs[7] & 0x0f, 256);
+	for(int x = 0; x < 40; x++) {
+		memcpy(dest + x * 6 + 8, pattern_cache[name_ptr[x] + bank][y & 7], 6);
 	}
 }
 
-void TMS9918A::draw_mode3()
+void TMS9918A::draw_mode3(uint8_t* dest, int y)
 {
-	for(int y = 0, name = 0; y < 24; y++) {
-		for(int x = 0; x < 32; x++) {
-			uint16_t code = vram[name_table + (name++)];
-			uint8_t* pattern_ptr = vram + pattern_table + code * 8 + (y & 3) * 2;
-			for(int yy = 0; yy < 2; yy++) {
-				uint8_t color = *pattern_ptr++;
-				uint8_t fg = (color & 0xf0) ? (color >> 4) : (regs[7] & 0x0f);
-				uint8_t bg = (color & 0x0f) ? (color & 0x0f) : (regs[7] & 0x0f);
-				for(int yyy = 0; yyy < 4; yyy++) {
-					uint8_t* buffer = screen[y * 8 + yy * 4 + yyy] + x * 8;
-					buffer[0] = buffer[1] = buffer[2] = buffer[3] = fg;
-					buffer[4] = buffer[5] = buffer[6] = buffer[7] = bg;
-				}
-			}
-		}
+	uint8_t* name_ptr = render_vram + render_name_table + (y >> 3) * 32;
+	for(int x = 0; x < 32; x++) {
+		uint16_t code = name_ptr[x];
+		uint8_t color = render_vram[render_pattern_table + code * 8 + ((y >> 3) & 3) * 2 + ((y >> 2) & 1)];
+		uint8_t fg = (color & 0xf0) ? (color >> 4) : (render_regs[7] & 0x0f);
+		uint8_t bg = (color & 0x0f) ? (color & 0x0f) : (render_regs[7] & 0x0f);
+		memset(dest + x * 8 + 0, fg, 4);
+		memset(dest + x * 8 + 4, bg, 4);
 	}
 }
 
-void TMS9918A::draw_mode23()
+void TMS9918A::draw_mode23(uint8_t* dest, int y)
 {
-	for(int y = 0, name = 0; y < 24;y++) {
-		for(int x = 0; x < 32; x++) {
-			uint16_t code = vram[name_table + (name++)];
-			uint8_t* pattern_ptr = vram + pattern_table + ((code + (y & 3) * 2 + (y & 0xf8) * 32) & pattern_mask) * 8;
-			for(int yy = 0; yy < 2; yy++) {
-				uint8_t color = *pattern_ptr++;
-				uint8_t fg = (color & 0xf0) ? (color >> 4) : (regs[7] & 0x0f);
-				uint8_t bg = (color & 0x0f) ? (color & 0x0f) : (regs[7] & 0x0f);
-				for(int yyy = 0; yyy < 4; yyy++) {
-					uint8_t* buffer = screen[y * 8 + yy * 4 + yyy] + x * 8;
-					buffer[0] = buffer[1] = buffer[2] = buffer[3] = fg;
-					buffer[4] = buffer[5] = buffer[6] = buffer[7] = bg;
-				}
-			}
-		}
+	uint8_t* name_ptr = render_vram + render_name_table + (y >> 3) * 32;
+	int cy = y >> 3;
+	for(int x = 0; x < 32; x++) {
+		uint16_t code = name_ptr[x];
+		uint8_t color = render_vram[render_pattern_table + ((code + (cy & 3) * 2 + (cy & 0xf8) * 32) & render_pattern_mask) * 8 + ((y >> 2) & 1)];
+		uint8_t fg = (color & 0xf0) ? (color >> 4) : (render_regs[7] & 0x0f);
+		uint8_t bg = (color & 0x0f) ? (color & 0x0f) : (render_regs[7] & 0x0f);
+		memset(dest + x * 8 + 0, fg, 4);
+		memset(dest + x * 8 + 4, bg, 4);
 	}
 }
 
-void TMS9918A::draw_modebogus()
+void TMS9918A::draw_modebogus(uint8_t* dest, int y)
 {
-	uint8_t fg = regs[7] >> 4;
-	uint8_t bg = regs[7] & 0x0f;
-	for(int y = 0; y < 192; y++) {
-		uint8_t* buffer = screen[y];
-		int x = 0;
-		for(int i = 0; i < 8; i++) {
-			buffer[x++] = bg;
-		}
-		for(int i = 0; i < 40; i++) {
-			for(int j = 0; j < 4; j++) {
-				buffer[x++] = fg;
-			}
-			for(int j = 0; j < 2; j++) {
-				buffer[x++] = bg;
-			}
+	uint8_t fg = render_regs[7] >> 4;
+	uint8_t bg = render_regs[7] & 0x0f;
+	int x = 0;
+	for(int i = 0; i < 8; i++) {
+		dest[x++] = bg;
+	}
+	for(int i = 0; i < 40; i++) {
+		for(int j = 0; j < 4; j++) {
+			dest[x++] = fg;
 		}
-		for(int i = 0; i < 8; i++) {
-			buffer[x++] = bg;
+		for(int j = 0; j < 2; j++) {
+			dest[x++] = bg;
 		}
 	}
+	for(int i = 0; i < 8; i++) {
+		dest[x++] = bg;
+	}
 }
 
 void TMS9918A::draw_sprites()
@@ -540,7 +641,8 @@ void TMS9918A::draw_sprites()
 							}
 							if(c && !(collision[yy][xx] & 2)) {
 								collision[yy][xx] |= 2;
-								screen[yy][xx] = c;
+								sprite_screen[yy][xx] = c;
+								sprite_line[yy] = true;
 							}
 						}
 					}
@@ -581,7 +683,8 @@ void TMS9918A::draw_sprites()
 									}
 									if(c && !(collision[yy][xx] & 2)) {
 										collision[yy][xx] |= 2;
-										screen[yy][xx] = c;
+										sprite_screen[yy][xx] = c;
+										sprite_line[yy] = true;
 									}
 								}
 								if(0 <= xx + 1 && xx + 1 < 256) {
@@ -592,7 +695,8 @@ void TMS9918A::draw_sprites()
 									}
 									if(c && !(collision[yy][xx + 1] & 2)) {
 										collision[yy][xx + 1] |= 2;
-										screen[yy][xx + 1] = c;
+										sprite_screen[yy][xx + 1] = c;
+										sprite_line[yy] = true;
 									}
 								}
 							}
@@ -650,6 +754,11 @@ bool TMS9918A::process_state(FILEIO* state_fio, bool loading)
 #ifdef TMS9918A_SUPER_IMPOSE
 	state_fio->StateValue(now_super_impose);
 #endif
+	
+	// post process
+	if(loading) {
+		render_redraw = true;
+	}
 	return true;
 }
 
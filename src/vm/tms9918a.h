@@ -18,6 +18,12 @@
 
 #define SIG_TMS9918A_SUPER_IMPOSE	0
 
+#if SCREEN_WIDTH == 512
+#define TMS9918A_SCREEN_WIDTH	512
+#else
+#define TMS9918A_SCREEN_WIDTH	256
+#endif
+
 #ifdef USE_DEBUGGER
 class DEBUGGER;
 #endif
@@ -33,7 +39,6 @@ private:
 	outputs_t outputs_irq;
 	
 	uint8_t vram[TMS9918A_VRAM_SIZE];
-	uint8_t screen[192][256];
 	uint8_t regs[8], status_reg, read_ahead, first_byte;
 	uint16_t vram_addr;
 	bool latch, intstat;
@@ -44,14 +49,39 @@ private:
 	bool now_super_impose;
 #endif
 	
+	// snapshot at vblank, the screen is rendered from it by worker threads
+	uint8_t render_vram[TMS9918A_VRAM_SIZE];
+	uint8_t render_regs[8];
+	uint16_t render_color_table, render_pattern_table, render_name_table;
+	uint16_t render_color_mask, render_pattern_mask;
+	uint8_t sprite_screen[192][256];
+	bool sprite_line[192], prev_sprite_line[192];
+	bool render_sprites;
+	
+	// vram blocks of 8 bytes written after the previous snapshot
+	uint8_t vram_dirty[TMS9918A_VRAM_SIZE >> 3];
+	bool render_redraw;
+	// decoded pattern cache: 8 pixels of each line of each character
+	uint8_t pattern_cache[768][8][8];
+	bool pattern_updated[768];
+	bool row_dirty[24];
+	
+	scrntype_t screen[192][TMS9918A_SCREEN_WIDTH];
+#if defined(TMS9918A_SUPER_IMPOSE) && !defined(USE_ALPHA_BLENDING_TO_IMPOSE)
+	uint8_t screen_index[192][256];
+#endif
+	
 	void set_intstat(bool val);
-	void draw_mode0();
-	void draw_mode1();
-	void draw_mode2();
-	void draw_mode12();
-	void draw_mode3();
-	void draw_mode23();
-	void draw_modebogus();
+	void update_snapshot();
+	void update_pattern_cache(int mode, bool redraw);
+	void update_row_dirty(int mode, bool redraw);
+	void draw_mode0(uint8_t* dest, int y);
+	void draw_mode1(uint8_t* dest, int y);
+	void draw_mode2(uint8_t* dest, int y);
+	void draw_mode12(uint8_t* dest, int y);
+	void draw_mode3(uint8_t* dest, int y);
+	void draw_mode23(uint8_t* dest, int y);
+	void draw_modebogus(uint8_t* dest, int y);
 	void draw_sprites();
 	
 public:
@@ -82,6 +112,7 @@ public:
 	void write_signal(int id, uint32_t data, uint32_t mask);
 #endif
 	void event_vline(int v, int clock);
+	void render_lines(int top, int bottom);
 #ifdef USE_DEBUGGER
 	bool is_debugger_available()
 	{
@@ -721,6 +721,7 @@ void UPD7220::cmd_vecte()
 	if(vect[0] & 0x40) {
 		draw_vectr();
 	}
+	draw_flush();
 	reset_vect();
 	statreg |= STAT_DRAW;
 	cmdreg = -1;
@@ -754,6 +755,7 @@ void UPD7220::cmd_texte()
 	if(vect[0] & 0x40) {
 		draw_vectr();
 	}
+	draw_flush();
 	reset_vect();
 	statreg |= STAT_DRAW;
 	cmdreg = -1;
@@ -1285,6 +1287,29 @@ void UPD7220::draw_pset(int x, int y)
 	}
 	if(egc_access) {
 		write_vram_word(addr, bit);
+	} else if((vram != NULL || vram_bus_direct) && vram_data_mask == 0xffff) {
+		// merge the operation into the pending word
+		if(!dot && mod != 0) {
+			return;
+		}
+		if(!pset_pending || pset_addr != addr) {
+			draw_flush();
+			pset_pending = true;
+			pset_addr = addr;
+			pset_set = pset_reset = pset_xor = 0;
+		}
+		if(mod == 1) {
+			pset_xor ^= bit;
+		} else if(dot && mod != 2) {
+			// replace with 1 or set
+			pset_set |= bit;
+			pset_xor &= ~bit;
+		} else {
+			// replace with 0 or reset
+			pset_reset |= bit;
+			pset_set &= ~bit;
+			pset_xor &= ~bit;
+		}
 	} else {
 		switch(mod) {
 		case 0: // replace
@@ -1313,6 +1338,14 @@ void UPD7220::draw_pset(int x, int y)
 	}
 }
 
+void UPD7220::draw_flush()
+{
+	if(pset_pending) {
+		write_vram_word(pset_addr, ((read_vram_word(pset_addr) & ~pset_reset) | pset_set) ^ pset_xor);
+		pset_pending = false;
+	}
+}
+
 #define STATE_VERSION	4
 
 bool UPD7220::process_state(FILEIO* state_fio, bool loading)
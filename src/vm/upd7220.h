@@ -38,6 +38,7 @@ private:
 	uint32_t vram_size;
 	uint32_t plane_size;
 	uint16_t vram_data_mask;
+	bool vram_bus_direct;
 	
 	// regs
 	int cmdreg;
@@ -86,6 +87,10 @@ private:
 	uint8_t dgd;
 	uint16_t pattern;
 	uint8_t egc_access;
+	// pixels in the same word are written at once
+	bool pset_pending;
+	uint32_t pset_addr;
+	uint16_t pset_set, pset_reset, pset_xor;
 	
 	// command
 	void check_cmd();
@@ -128,6 +133,7 @@ private:
 	void draw_vectr();
 	void draw_text();
 	void draw_pset(int x, int y);
+	void draw_flush();
 	
 public:
 	UPD7220(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
@@ -138,7 +144,9 @@ public:
 		vram = NULL;
 		vram_size = plane_size = 0;
 		vram_data_mask = 0xffff;
+		vram_bus_direct = false;
 		egc_access = false;
+		pset_pending = false;
 		set_device_name(_T("uPD7220 GDC"));
 	}
 	~UPD7220() {}
@@ -187,6 +195,12 @@ public:
 		set_vram_bus_ptr(device, size);
 		vram_data_mask = mask;
 	}
+	// the vram bus device reads back the data written (no grcg/egc logic),
+	// so the pixels in the same word can be drawn with one read-modify-write
+	void set_vram_bus_direct(bool value)
+	{
+		vram_bus_direct = value;
+	}
 	void set_plane_size(uint32_t size)
 	{
 		plane_size = size;
@@ -0,0 +1,304 @@
+/*
+	Skelton for retropc emulator
+
+	Author : agent
+	Date   : 2026.10.19-
+
+	[ vgm/s98 register logger ]
+*/
+
+#ifndef _VGM_LOGGER_H_
+#define _VGM_LOGGER_H_
+
+#include <string.h>
+#include "../common.h"
+#include "../fileio.h"
+
+// register writes of sound chips are logged with the clock when they are written.
+// the time is counted by the samples of 44.1KHz (vgm) or 1/44100 sec ticks (s98).
+// the first 2 chips of each type are logged to vgm, and the first 8 chips to s98.
+
+#define VGM_SN76489	0
+#define VGM_YM2413	1
+#define VGM_YM2151	2
+#define VGM_YM2203	3
+#define VGM_YM2608	4
+#define VGM_AY8910	5
+#define VGM_K051649	6
+#define VGM_CHIP_TYPES	7
+
+#define VGM_FORMAT_VGM	1
+#define VGM_FORMAT_S98	2
+
+#define VGM_SAMPLE_RATE	44100
+#define VGM_HEADER_SIZE	0x100
+#define S98_MAX_DEVICES	8
+#define S98_HEADER_SIZE	(0x20 + 0x10 * S98_MAX_DEVICES)
+#define VGM_BUFFER_SIZE	0x10000
+
+class VGM_LOGGER
+{
+private:
+	FILEIO* fio;
+	int format;
+	uint8_t buffer[VGM_BUFFER_SIZE];
+	int buffer_ptr;
+	uint32_t data_size;
+	
+	struct {
+		const void* owner;
+		int type;
+		int index;	// index in the chips of the same type (vgm) or device number (s98), -1 if not logged
+		uint32_t clock;
+	} chips[S98_MAX_DEVICES];
+	int chip_count;
+	
+	bool started;
+	uint32_t prev_clock;
+	uint64_t remain;
+	uint32_t pending_samples, total_samples;
+	
+	void put(uint8_t data)
+	{
+		if(buffer_ptr == VGM_BUFFER_SIZE) {
+			fio->Fwrite(buffer, buffer_ptr, 1);
+			buffer_ptr = 0;
+		}
+		buffer[buffer_ptr++] = data;
+		data_size++;
+	}
+	void flush_wait()
+	{
+		uint32_t samples = pending_samples;
+		
+		if(format == VGM_FORMAT_VGM) {
+			while(samples > 0) {
+				if(samples <= 16) {
+					put(0x70 + samples - 1);
+					break;
+				} else if(samples == 735 || samples == 882) {
+					put(samples == 735 ? 0x62 : 0x63);
+					break;
+				}
+				uint32_t n = (samples > 0xffff) ? 0xffff : samples;
+				put(0x61);
+				put(n & 0xff);
+				put(n >> 8);
+				samples -= n;
+			}
+		} else {
+			if(samples == 1) {
+				put(0xff);
+			} else if(samples > 1) {
+				// variable length: 7bits per byte, lsb first
+				uint32_t n = samples - 2;
+				put(0xfe);
+				while(n >= 0x80) {
+					put((n & 0x7f) | 0x80);
+					n >>= 7;
+				}
+				put(n);
+			}
+		}
+		total_samples += pending_samples;
+		pending_samples = 0;
+	}
+	int find_chip(int type, const void* owner, uint32_t clock)
+	{
+		for(int i = 0; i < chip_count; i++) {
+			if(chips[i].owner == owner) {
+				return i;
+			}
+		}
+		if(chip_count == S98_MAX_DEVICES) {
+			return -1;
+		}
+		int index = 0;
+		for(int i = 0; i < chip_count; i++) {
+			if(chips[i].index >= 0 && (chips[i].type == type || format == VGM_FORMAT_S98)) {
+				index++;
+			}
+		}
+		if(format == VGM_FORMAT_VGM && index >= 2) {
+			index = -1;
+		} else if(format == VGM_FORMAT_S98 && type == VGM_K051649) {
+			index = -1;
+		}
+		chips[chip_count].owner = owner;
+		chips[chip_count].type = type;
+		chips[chip_count].index = index;
+		chips[chip_count].clock = clock;
+		return chip_count++;
+	}
+	void put_header_uint32(uint8_t* header, int offset, uint32_t value)
+	{
+		header[offset + 0] = (value >>  0) & 0xff;
+		header[offset + 1] = (value >>  8) & 0xff;
+		header[offset + 2] = (value >> 16) & 0xff;
+		header[offset + 3] = (value >> 24) & 0xff;
+	}
+	void write_header()
+	{
+		uint8_t header[VGM_HEADER_SIZE];
+		memset(header, 0, sizeof(header));
+		
+		if(format == VGM_FORMAT_VGM) {
+			static const int clock_offset[VGM_CHIP_TYPES] = {0x0c, 0x10, 0x30, 0x44, 0x48, 0x74, 0x9c};
+			memcpy(header, "Vgm ", 4);
+			put_header_uint32(header, 0x04, VGM_HEADER_SIZE + data_size - 4);
+			put_header_uint32(header, 0x08, 0x171);
+			put_header_uint32(header, 0x18, total_samples);
+			put_header_uint32(header, 0x34, VGM_HEADER_SIZE - 0x34);
+			for(int i = 0; i < chip_count; i++) {
+				if(chips[i].index < 0) {
+					continue;
+				}
+				uint32_t clock = chips[i].clock;
+				if(chips[i].index == 1) {
+					// dual chips
+					clock |= 0x40000000;
+				}
+				put_header_uint32(header, clock_offset[chips[i].type], clock);
+				if(chips[i].type == VGM_SN76489) {
+					// SN76489AN: feedback = 0x0003, shift register width = 15
+					header[0x28] = 0x03;
+					header[0x2a] = 15;
+				} else if(chips[i].type == VGM_AY8910) {
+					header[0x79] = 0x01;	// legacy output
+				}
+			}
+			fio->Fseek(0, FILEIO_SEEK_SET);
+			fio->Fwrite(header, VGM_HEADER_SIZE, 1);
+		} else {
+			// s98v3 device types: 2 = OPN, 4 = OPNA, 5 = OPM, 6 = OPLL, 15 = PSG (AY-3-8910), 16 = DCSG (SN76489)
+			static const uint32_t device_type[VGM_CHIP_TYPES] = {16, 6, 5, 2, 4, 15, 0};
+			memcpy(header, "S983", 4);
+			put_header_uint32(header, 0x04, 1);
+			put_header_uint32(header, 0x08, VGM_SAMPLE_RATE);
+			put_header_uint32(header, 0x14, S98_HEADER_SIZE);
+			int count = 0;
+			for(int i = 0; i < chip_count; i++) {
+				if(chips[i].index >= 0) {
+					put_header_uint32(header, 0x20 + 0x10 * count + 0, device_type[chips[i].type]);
+					put_header_uint32(header, 0x20 + 0x10 * count + 4, chips[i].clock);
+					count++;
+				}
+			}
+			put_header_uint32(header, 0x1c, count);
+			fio->Fseek(0, FILEIO_SEEK_SET);
+			fio->Fwrite(header, S98_HEADER_SIZE, 1);
+		}
+	}
+	
+public:
+	VGM_LOGGER()
+	{
+		fio = NULL;
+	}
+	~VGM_LOGGER()
+	{
+		close();
+	}
+	bool open(const _TCHAR* file_path, int file_format)
+	{
+		close();
+		fio = new FILEIO();
+		if(!fio->Fopen(file_path, FILEIO_WRITE_BINARY)) {
+			delete fio;
+			fio = NULL;
+			return false;
+		}
+		format = file_format;
+		buffer_ptr = 0;
+		data_size = 0;
+		chip_count = 0;
+		started = false;
+		remain = 0;
+		pending_samples = total_samples = 0;
+		
+		// header is written again when the file is closed
+		write_header();
+		return true;
+	}
+	void close()
+	{
+		if(fio != NULL) {
+			flush_wait();
+			put((format == VGM_FORMAT_VGM) ? 0x66 : 0xfd);
+			if(buffer_ptr > 0) {
+				fio->Fwrite(buffer, buffer_ptr, 1);
+			}
+			write_header();
+			fio->Fclose();
+			delete fio;
+			fio = NULL;
+		}
+	}
+	// returns false if the chip is not registered, then the chip should log all registers
+	bool is_registered(const void* owner)
+	{
+		for(int i = 0; i < chip_count; i++) {
+			if(chips[i].owner == owner) {
+				return true;
+			}
+		}
+		return false;
+	}
+	// clock = current clock of event manager, clocks_per_sec = clock frequency of event manager
+	// chip_clock = clock frequency of chip for the header
+	// port = port of YM2608, or register group of K051649
+	void write(int type, const void* owner, uint32_t chip_clock, uint32_t clock, uint32_t clocks_per_sec, int port, uint32_t addr, uint32_t data)
+	{
+		int id = find_chip(type, owner, chip_clock);
+		if(id < 0 || chips[id].index < 0) {
+			return;
+		}
+		if(started) {
+			remain += (uint64_t)(clock - prev_clock) * VGM_SAMPLE_RATE;
+			pending_samples += (uint32_t)(remain / clocks_per_sec);
+			remain %= clocks_per_sec;
+		}
+		prev_clock = clock;
+		started = true;
+		flush_wait();
+		
+		int index = chips[id].index;
+		if(format == VGM_FORMAT_VGM) {
+			switch(type) {
+			case VGM_SN76489:
+				put(index ? 0x30 : 0x50);
+				put(data);
+				break;
+			case VGM_YM2413:
+			case VGM_YM2151:
+			case VGM_YM2203:
+				put((index ? 0xa0 : 0x50) | ((type == VGM_YM2413) ? 0x01 : (type == VGM_YM2151) ? 0x04 : 0x05));
+				put(addr);
+				put(data);
+				break;
+			case VGM_YM2608:
+				put((index ? 0xa6 : 0x56) + (port & 1));
+				put(addr);
+				put(data);
+				break;
+			case VGM_AY8910:
+				put(0xa0);
+				put(addr | (index ? 0x80 : 0));
+				put(data);
+				break;
+			case VGM_K051649:
+				put(0xd2);
+				put(port | (index ? 0x80 : 0));
+				put(addr);
+				put(data);
+				break;
+			}
+		} else {
+			put(index * 2 + (port & 1));
+			put((type == VGM_SN76489) ? 0 : addr);
+			put(data);
+		}
+	}
+};
+
+#endif
@@ -15,6 +15,7 @@
 #include "display.h"
 #include "../hd46505.h"
 #include "../i8255.h"
+#include "../planar.h"
 
 #ifdef _X1TURBO_FEATURE
 #define EVENT_AFTER_BLANK	0
@@ -121,11 +122,20 @@ void DISPLAY::initialize()
 	memset(gaiji_g, 0, sizeof(gaiji_g));
 #endif
 	
+	glyph_cache = new GLYPH_CACHE(8, 1024);
+	text_redraw = 2;
+	
 	// register event
 	register_frame_event(this);
 	register_vline_event(this);
 }
 
+void DISPLAY::release()
+{
+	glyph_cache->release();
+	delete glyph_cache;
+}
+
 void DISPLAY::reset()
 {
 #ifdef _X1TURBO_FEATURE
@@ -150,6 +160,7 @@ void DISPLAY::reset()
 	
 	kaddr = kofs = kflag = 0;
 	kanji_ptr = &kanji[0];
+	text_redraw = 2;
 }
 
 void DISPLAY::write_io8(uint32_t addr, uint32_t data)
@@ -237,22 +248,31 @@ void DISPLAY::write_io8(uint32_t addr, uint32_t data)
 	case 0x1500:
 		get_cur_pcg(addr);
 		pcg_b[cur_code][cur_line] = data;
+		glyph_cache->invalidate(2);
+		text_redraw = 2;
 #ifdef _X1TURBO_FEATURE
 		gaiji_b[cur_code >> 1][(cur_line << 1) | (cur_code & 1)] = data;
+		glyph_cache->invalidate(3);
 #endif
 		break;
 	case 0x1600:
 		get_cur_pcg(addr);
 		pcg_r[cur_code][cur_line] = data;
+		glyph_cache->invalidate(2);
+		text_redraw = 2;
 #ifdef _X1TURBO_FEATURE
 		gaiji_r[cur_code >> 1][(cur_line << 1) | (cur_code & 1)] = data;
+		glyph_cache->invalidate(3);
 #endif
 		break;
 	case 0x1700:
 		get_cur_pcg(addr);
 		pcg_g[cur_code][cur_line] = data;
+		glyph_cache->invalidate(2);
+		text_redraw = 2;
 #ifdef _X1TURBO_FEATURE
 		gaiji_g[cur_code >> 1][(cur_line << 1) | (cur_code & 1)] = data;
+		glyph_cache->invalidate(3);
 #endif
 		break;
 #ifdef _X1TURBO_FEATURE
@@ -560,7 +580,10 @@ void DISPLAY::event_frame()
 #endif
 	
 	// initialize draw screen
-	memset(text, 0, sizeof(text));
+	// text is not cleared, the cells drawn in the previous frame are kept
+	if(text_redraw > 0) {
+		text_redraw--;
+	}
 	memset(cg, 0, sizeof(cg));
 	memset(pri_line, 0, sizeof(pri_line));
 #ifdef _X1TURBOZ
@@ -945,7 +968,10 @@ void DISPLAY::draw_text(int yy)
 	uint16_t src = st_addr + hz_disp * y;
 	
 	bool cur_vert_double = true;
-	uint8_t prev_attr = 0, prev_pattern_b[32], prev_pattern_r[32], prev_pattern_g[32];
+	uint8_t prev_attr = 0;
+	const uint8_t *prev_pattern_b = NULL, *prev_pattern_r = NULL, *prev_pattern_g = NULL;
+	int prev_source = 0, prev_max_line = 8;
+	uint32_t prev_ofs = 0;
 	
 	for(int x = 0; x < hz_disp && x < width; x++) {
 		src &= 0x7ff;
@@ -963,6 +989,8 @@ void DISPLAY::draw_text(int yy)
 		
 		// select pcg or ank
 		const uint8_t *pattern_b, *pattern_r, *pattern_g;
+		int source;
+		uint32_t ofs;
 #ifdef _X1TURBO_FEATURE
 		int shift = 0;
 		int max_line = 8;
@@ -976,32 +1004,41 @@ void DISPLAY::draw_text(int yy)
 				pattern_b = gaiji_b[code >> 1];
 				pattern_r = gaiji_r[code >> 1];
 				pattern_g = gaiji_g[code >> 1];
+				source = 3;
+				ofs = code >> 1;
 				max_line = 16;
 			} else {
 #endif
 				pattern_b = pcg_b[code];
 				pattern_r = pcg_r[code];
 				pattern_g = pcg_g[code];
+				source = 2;
+				ofs = code;
 #ifdef _X1TURBO_FEATURE
 				shift = (mode1 & 1) ? 1 : 0;
 			}
 #endif
 #ifdef _X1TURBO_FEATURE
 		} else if(knj & 0x80) {
-			uint32_t ofs = adr2knj_x1t((knj << 8) | code);
+			ofs = adr2knj_x1t((knj << 8) | code);
 			if(knj & 0x40) {
 				ofs += 16; // right
 			}
 			pattern_b = pattern_r = pattern_g = &kanji[ofs];
+			source = 1;
 			max_line = 16;
 		} else if((mode1 & 5) != 0) {
 			// ank 8x16 or kanji
 			pattern_b = pattern_r = pattern_g = &kanji[code << 4];
+			source = 1;
+			ofs = code << 4;
 			max_line = 16;
 #endif
 		} else {
 			// ank 8x8
 			pattern_b = pattern_r = pattern_g = &font[code << 3];
+			source = 0;
+			ofs = code << 3;
 		}
 #ifdef _X1TURBO_FEATURE
 		if(max_line == 16) {
@@ -1018,7 +1055,6 @@ void DISPLAY::draw_text(int yy)
 //		for(int l = 0; l < ch_height; l++)
 		{
 			int l = yy % ch_height;
-			uint8_t b, r, g;
 			int line = cur_vert_double ? raster + (l >> 1) : l;
 #ifdef _X1TURBO_FEATURE
 			if(shift == 1) {
@@ -1030,25 +1066,6 @@ void DISPLAY::draw_text(int yy)
 				}
 			}
 #endif
-			if((x & 1) && (prev_attr & 0x80)) {
-				b = prev_pattern_b[line] << 4;
-				r = prev_pattern_r[line] << 4;
-				g = prev_pattern_g[line] << 4;
-			} else {
-				b = prev_pattern_b[line] = pattern_b[line % max_line];
-				r = prev_pattern_r[line] = pattern_r[line % max_line];
-				g = prev_pattern_g[line] = pattern_g[line % max_line];
-			}
-			if(reverse) {
-				b = (!(col & 1)) ? 0xff : ~b;
-				r = (!(col & 2)) ? 0xff : ~r;
-				g = (!(col & 4)) ? 0xff : ~g;
-			} else {
-				b = (!(col & 1)) ? 0 : b;
-				r = (!(col & 2)) ? 0 : r;
-				g = (!(col & 4)) ? 0 : g;
-			}
-			
 //			int yy = y * ch_height + l;
 #ifdef _X1TURBO_FEATURE
 			if(yy >= 400) {
@@ -1057,27 +1074,81 @@ void DISPLAY::draw_text(int yy)
 #endif
 				break;
 			}
-			uint8_t* d = &text[yy][x << 3];
 			
-			if(attr & 0x80) {
-				// horizontal doubled char
-				d[ 0] = d[ 1] = ((b & 0x80) >> 7) | ((r & 0x80) >> 6) | ((g & 0x80) >> 5);
-				d[ 2] = d[ 3] = ((b & 0x40) >> 6) | ((r & 0x40) >> 5) | ((g & 0x40) >> 4);
-				d[ 4] = d[ 5] = ((b & 0x20) >> 5) | ((r & 0x20) >> 4) | ((g & 0x20) >> 3);
-				d[ 6] = d[ 7] = ((b & 0x10) >> 4) | ((r & 0x10) >> 3) | ((g & 0x10) >> 2);
-			} else {
-				d[0] = ((b & 0x80) >> 7) | ((r & 0x80) >> 6) | ((g & 0x80) >> 5);
-				d[1] = ((b & 0x40) >> 6) | ((r & 0x40) >> 5) | ((g & 0x40) >> 4);
-				d[2] = ((b & 0x20) >> 5) | ((r & 0x20) >> 4) | ((g & 0x20) >> 3);
-				d[3] = ((b & 0x10) >> 4) | ((r & 0x10) >> 3) | ((g & 0x10) >> 2);
-				d[4] = ((b & 0x08) >> 3) | ((r & 0x08) >> 2) | ((g & 0x08) >> 1);
-				d[5] = ((b & 0x04) >> 2) | ((r & 0x04) >> 1) | ((g & 0x04) >> 0);
-				d[6] = ((b & 0x02) >> 1) | ((r & 0x02) >> 0) | ((g & 0x02) << 1);
-				d[7] = ((b & 0x01) >> 0) | ((r & 0x01) << 1) | ((g & 0x01) << 2);
+			// the right half of horizontal doubled char is from the previous char
+			bool right_half = ((x & 1) && (prev_attr & 0x80));
+			uint32_t flags = col | (reverse ? 8 : 0) | ((attr & 0x80) ? 0x10 : 0) | (right_half ? 0x20 : 0);
+			uint64_t key = right_half ? glyph_key(prev_source, prev_ofs, flags, line % prev_max_line) : glyph_key(source, ofs, flags, line % max_line);
+			// skip the cell if it was drawn with the same row and its glyphs are not changed
+			if(text_redraw != 0 || text_cell[yy][x] != key) {
+				text_cell[yy][x] = key;
+				uint8_t* d = glyph_cache->find(key);
+				
+				if(d == NULL) {
+					// expand the pattern with the color and attribute
+					d = glyph_cache->insert(key);
+					uint8_t b, r, g;
+					if(right_half) {
+						b = prev_pattern_b[line % prev_max_line] << 4;
+						r = prev_pattern_r[line % prev_max_line] << 4;
+						g = prev_pattern_g[line % prev_max_line] << 4;
+					} else {
+						b = pattern_b[line % max_line];
+						r = pattern_r[line % max_line];
+						g = pattern_g[line % max_line];
+					}
+					if(reverse) {
+						b = (!(col & 1)) ? 0xff : ~b;
+						r = (!(col & 2)) ? 0xff : ~r;
+						g = (!(col & 4)) ? 0xff : ~g;
+					} else {
+						b = (!(col & 1)) ? 0 : b;
+						r = (!(col & 2)) ? 0 : r;
+						g = (!(col & 4)) ? 0 : g;
+					}
+					if(attr & 0x80) {
+						// horizontal doubled char
+						d[ 0] = d[ 1] = ((b & 0x80) >> 7) | ((r & 0x80) >> 6) | ((g & 0x80) >> 5);
+						d[ 2] = d[ 3] = ((b & 0x40) >> 6) | ((r & 0x40) >> 5) | ((g & 0x40) >> 4);
+						d[ 4] = d[ 5] = ((b & 0x20) >> 5) | ((r & 0x20) >> 4) | ((g & 0x20) >> 3);
+						d[ 6] = d[ 7] = ((b & 0x10) >> 4) | ((r & 0x10) >> 3) | ((g & 0x10) >> 2);
+					} else {
+						d[0] = ((b & 0x80) >> 7) | ((r & 0x80) >> 6) | ((g & 0x80) >> 5);
+						d[1] = ((b & 0x40) >> 6) | ((r & 0x40) >> 5) | ((g & 0x40) >> 4);
+						d[2] = ((b & 0x20) >> 5) | ((r & 0x20) >> 4) | ((g & 0x20) >> 3);
+						d[3] = ((b & 0x10) >> 4) | ((r & 0x10) >> 3) | ((g & 0x10) >> 2);
+						d[4] = ((b & 0x08) >> 3) | ((r & 0x08) >> 2) | ((g & 0x08) >> 1);
+						d[5] = ((b & 0x04) >> 2) | ((r & 0x04) >> 1) | ((g & 0x04) >> 0);
+						d[6] = ((b & 0x02) >> 1) | ((r & 0x02) >> 0) | ((g & 0x02) << 1);
+						d[7] = ((b & 0x01) >> 0) | ((r & 0x01) << 1) | ((g & 0x01) << 2);
+					}
+				}
+				memcpy(&text[yy][x << 3], d, 8);
 			}
 		}
+		if(!((x & 1) && (prev_attr & 0x80))) {
+			prev_pattern_b = pattern_b;
+			prev_pattern_r = pattern_r;
+			prev_pattern_g = pattern_g;
+			prev_source = source;
+			prev_ofs = ofs;
+			prev_max_line = max_line;
+		}
 		prev_attr = attr;
 	}
+	// clear the cells out of the display width
+#ifdef _X1TURBO_FEATURE
+	if(yy < 400) {
+#else
+	if(yy < 200) {
+#endif
+		for(int x = min(hz_disp, width); x < 80; x++) {
+			if(text_redraw != 0 || text_cell[yy][x] != TEXT_CELL_BLANK) {
+				memset(&text[yy][x << 3], 0, 8);
+				text_cell[yy][x] = TEXT_CELL_BLANK;
+			}
+		}
+	}
 	if((yy % ch_height) == (ch_height - 1)) {
 		if(cur_vert_double && !prev_vert_double) {
 			prev_vert_double = true;
@@ -1207,16 +1278,8 @@ void DISPLAY::draw_cg(int line, int plane)
 			uint8_t b = vram_ptr[ofs_b | src];
 			uint8_t r = vram_ptr[ofs_r | src];
 			uint8_t g = vram_ptr[ofs_g | src++];
-			uint8_t* d = &cg[line][x << 3];
 			
-			d[0] = ((b & 0x80) >> 7) | ((r & 0x80) >> 6) | ((g & 0x80) >> 5);
-			d[1] = ((b & 0x40) >> 6) | ((r & 0x40) >> 5) | ((g & 0x40) >> 4);
-			d[2] = ((b & 0x20) >> 5) | ((r & 0x20) >> 4) | ((g & 0x20) >> 3);
-			d[3] = ((b & 0x10) >> 4) | ((r & 0x10) >> 3) | ((g & 0x10) >> 2);
-			d[4] = ((b & 0x08) >> 3) | ((r & 0x08) >> 2) | ((g & 0x08) >> 1);
-			d[5] = ((b & 0x04) >> 2) | ((r & 0x04) >> 1) | ((g & 0x04) >> 0);
-			d[6] = ((b & 0x02) >> 1) | ((r & 0x02) >> 0) | ((g & 0x02) << 1);
-			d[7] = ((b & 0x01) >> 0) | ((r & 0x01) << 1) | ((g & 0x01) << 2);
+			planar_to_chunky_msb(&cg[line][x << 3], b, r, g);
 		}
 	}
 }
@@ -1571,6 +1634,8 @@ bool DISPLAY::process_state(FILEIO* state_fio, bool loading)
 #ifdef _X1TURBOZ
 		zpalette_changed = true;
 #endif
+		glyph_cache->clear();
+		text_redraw = 2;
 		update_crtc(); // force update timing
 	}
 	return true;
@@ -16,6 +16,7 @@
 #include "../vm.h"
 #include "../../emu.h"
 #include "../device.h"
+#include "../glyph_cache.h"
 
 #define SIG_DISPLAY_VBLANK		0
 #define SIG_DISPLAY_COLUMN40		1
@@ -51,6 +52,10 @@ private:
 	
 	uint8_t cur_code, cur_line;
 	
+	// expanded rows of font (0), kanji (1), pcg (2) and gaiji (3)
+	GLYPH_CACHE* glyph_cache;
+	int text_redraw;	// frames to redraw all cells after pcg/gaiji is changed
+	
 	int kaddr, kofs, kflag;
 	uint8_t* kanji_ptr;
 	
@@ -77,12 +82,15 @@ private:
 	int zpal_num;
 #endif
 	
+	#define TEXT_CELL_BLANK	(~(uint64_t)0)	// the cell is cleared
 #ifdef _X1TURBO_FEATURE
 	uint8_t text[400][640];
+	uint64_t text_cell[400][80];	// row keys of cells drawn in text
 	uint8_t cg[400][640];
 	uint8_t pri_line[400][8][8];
 #else
 	uint8_t text[200][640+8];
+	uint64_t text_cell[200][80];
 	uint8_t cg[200][640];
 	uint8_t pri_line[200][8][8];
 #endif
@@ -141,6 +149,7 @@ public:
 	
 	// common functions
 	void initialize();
+	void release();
 	void reset();
 	void write_io8(uint32_t addr, uint32_t data);
 	uint32_t read_io8(uint32_t addr);
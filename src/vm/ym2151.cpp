@@ -8,6 +8,7 @@
 */
 
 #include "ym2151.h"
+#include "vgm_logger.h"
 #ifdef USE_DEBUGGER
 #include "debugger.h"
 #endif
@@ -209,6 +210,13 @@ void YM2151::set_volume(int ch, int decibel_l, int decibel_r)
 
 void YM2151::initialize_sound(int rate, int clock, int samples, int decibel)
 {
+	if(config.sound_native_rate) {
+		// render at the sampling rate of the chip, and the sound manager resamples it
+		rate = clock / 64;
+		set_sound_native_rate(this, rate);
+	} else {
+		set_sound_native_rate(this, 0);
+	}
 	opm->Init(clock, rate, false);
 	opm->SetVolume(decibel, decibel);
 	base_decibel = decibel;
@@ -244,8 +252,27 @@ void YM2151::initialize_sound(int rate, int clock, int samples, int decibel)
 	chip_clock = clock;
 }
 
+void YM2151::log_reg(uint32_t addr, uint32_t data)
+{
+	VGM_LOGGER* logger = emu->get_vgm_logger();
+	uint32_t clock = get_current_clock(), clocks_per_sec = get_event_clocks();
+	
+	if(!logger->is_registered(this)) {
+		// log the current registers except key on/off
+		for(int i = 0; i < 0x100; i++) {
+			if(port_log[i].written && i != 0x08) {
+				logger->write(VGM_YM2151, this, chip_clock, clock, clocks_per_sec, 0, i, port_log[i].data);
+			}
+		}
+	}
+	logger->write(VGM_YM2151, this, chip_clock, clock, clocks_per_sec, 0, addr, data);
+}
+
 void YM2151::set_reg(uint32_t addr, uint32_t data)
 {
+	if(emu->get_vgm_logger() != NULL) {
+		log_reg(addr, data);
+	}
 	touch_sound();
 	opm->SetReg(addr, data);
 #ifdef SUPPORT_MAME_FM_DLL
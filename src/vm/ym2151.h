@@ -61,6 +61,7 @@ private:
 	void update_count();
 	void update_event();
 	void update_interrupt();
+	void log_reg(uint32_t addr, uint32_t data);
 	
 public:
 	YM2151(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
@@ -84,6 +85,14 @@ public:
 	void event_vline(int v, int clock);
 	void event_callback(int event_id, int error);
 	void mix(int32_t* buffer, int cnt);
+	bool is_mix_thread_safe()
+	{
+#ifdef SUPPORT_MAME_FM_DLL
+		return (dllchip == NULL);
+#else
+		return true;
+#endif
+	}
 	void set_volume(int ch, int decibel_l, int decibel_r);
 	void update_timing(int new_clocks, double new_frames_per_sec, int new_lines_per_frame);
 	// for debugging
@@ -8,6 +8,7 @@
 */
 
 #include "ym2203.h"
+#include "vgm_logger.h"
 #ifdef USE_DEBUGGER
 #include "debugger.h"
 #endif
@@ -45,6 +46,8 @@ void YM2203::initialize()
 	register_vline_event(this);
 	mute = false;
 	clock_prev = clock_accum = clock_busy = 0;
+	reg_log_read = reg_log_write = 0;
+	sample_pos = 0;
 	
 #ifdef USE_DEBUGGER
 	if(d_debugger != NULL) {
@@ -82,6 +85,7 @@ void YM2203::release()
 void YM2203::reset()
 {
 	touch_sound();
+	reg_log_read = reg_log_write;
 	if(is_ym2608) {
 		opna->Reset();
 	} else {
@@ -289,6 +293,15 @@ uint32_t YM2203::read_via_debugger_data8(uint32_t addr)
 				return (mode & 0x80) ? port[1].wreg : port[1].rreg;
 			}
 		}
+		if(reg_log_read != reg_log_write && is_deferred_reg(addr)) {
+			// the last value in the log is not applied to the chip yet
+			for(int i = reg_log_write; i != reg_log_read;) {
+				i = (i - 1) & (YM2203_REG_LOG_SIZE - 1);
+				if(reg_log[i].addr == addr) {
+					return reg_log[i].data;
+				}
+			}
+		}
 		if(is_ym2608) {
 			return opna->GetReg(addr);
 		} else {
@@ -381,17 +394,43 @@ void YM2203::update_interrupt()
 
 void YM2203::mix(int32_t* buffer, int cnt)
 {
-	if(cnt > 0 && !mute) {
-		if(is_ym2608) {
-			opna->Mix(buffer, cnt);
-		} else {
-			opn->Mix(buffer, cnt);
+	if(cnt > 0) {
+		uint32_t sample_end = sample_pos + cnt;
+		
+		// render the blocks between the logged register writes
+		while(reg_log_read != reg_log_write) {
+			int samples = (int)(reg_log[reg_log_read].sample - sample_pos);
+			if(samples >= cnt) {
+				break;
+			}
+			if(samples > 0 && !mute) {
+				if(is_ym2608) {
+					opna->Mix(buffer, samples);
+				} else {
+					opn->Mix(buffer, samples);
+				}
+			}
+			if(samples > 0) {
+				buffer += samples * 2;
+				cnt -= samples;
+				sample_pos += samples;
+			}
+			apply_reg_log(sample_pos);
 		}
+		if(!mute) {
+			if(is_ym2608) {
+				opna->Mix(buffer, cnt);
+			} else {
+				opn->Mix(buffer, cnt);
+			}
 #ifdef SUPPORT_MAME_FM_DLL
-		if(dllchip) {
-			fmdll->Mix(dllchip, buffer, cnt);
-		}
+			if(dllchip) {
+				fmdll->Mix(dllchip, buffer, cnt);
+			}
 #endif
+		}
+		sample_pos = sample_end;
+		apply_reg_log(sample_pos);
 	}
 }
 
@@ -432,6 +471,13 @@ void YM2203::set_volume(int ch, int decibel_l, int decibel_r)
 
 void YM2203::initialize_sound(int rate, int clock, int samples, int decibel_fm, int decibel_psg)
 {
+	if(config.sound_native_rate) {
+		// render at the sampling rate of the chip, and the sound manager resamples it
+		rate = is_ym2608 ? clock / 144 : clock / 72;
+		set_sound_native_rate(this, rate);
+	} else {
+		set_sound_native_rate(this, 0);
+	}
 	if(is_ym2608) {
 		opna->Init(clock, rate, false, get_application_path());
 		opna->SetVolumeFM(decibel_fm, decibel_fm);
@@ -489,9 +535,95 @@ void YM2203::initialize_sound(int rate, int clock, int samples, int decibel_fm,
 	chip_clock = clock;
 }
 
+bool YM2203::is_deferred_reg(uint32_t addr)
+{
+	// timer, prescaler, irq mask and adpcm (memory access and status flags)
+	// should be applied immediately
+	addr &= 0x1ff;
+	if(addr < 0x0e || (0x10 <= addr && addr <= 0x1f) || addr == 0x22 || addr == 0x28 || (0x30 <= addr && addr <= 0xb6)) {
+		return true;
+	}
+	if(0x130 <= addr && addr <= 0x1b6) {
+		return true;
+	}
+	return false;
+}
+
+void YM2203::apply_reg_log(uint32_t sample)
+{
+	while(reg_log_read != reg_log_write) {
+		int index = reg_log_read;
+		if((int)(reg_log[index].sample - sample) > 0) {
+			break;
+		}
+		write_reg(reg_log[index].addr, reg_log[index].data);
+		reg_log_read = (index + 1) & (YM2203_REG_LOG_SIZE - 1);
+	}
+}
+
+void YM2203::log_reg(uint32_t addr, uint32_t data)
+{
+	VGM_LOGGER* logger = emu->get_vgm_logger();
+	int type = is_ym2608 ? VGM_YM2608 : VGM_YM2203;
+	uint32_t clock = get_current_clock(), clocks_per_sec = get_event_clocks();
+	
+	if(!logger->is_registered(this)) {
+		// log the current registers except key on/off and rhythm/adpcm control
+		for(int i = 0; i < (is_ym2608 ? 0x200 : 0x100); i++) {
+			if(port_log[i].written && i != 0x28 && !(is_ym2608 && (i == 0x10 || (i >= 0x100 && i <= 0x110)))) {
+				logger->write(type, this, chip_clock, clock, clocks_per_sec, i >> 8, i & 0xff, port_log[i].data);
+			}
+		}
+	}
+	logger->write(type, this, chip_clock, clock, clocks_per_sec, addr >> 8, addr & 0xff, data);
+}
+
 void YM2203::set_reg(uint32_t addr, uint32_t data)
 {
+	if(emu->get_vgm_logger() != NULL) {
+		log_reg(addr, data);
+	}
+#ifdef SUPPORT_MAME_FM_DLL
+	if(dllchip == NULL)
+#endif
+	if(is_deferred_reg(addr)) {
+		int pending = get_sound_pending_samples();
+		if(pending > 0 || reg_log_read != reg_log_write) {
+			int next = (reg_log_write + 1) & (YM2203_REG_LOG_SIZE - 1);
+			if(next == reg_log_read) {
+				// log is full
+				touch_sound();
+				apply_reg_log(sample_pos + pending);
+				next = (reg_log_write + 1) & (YM2203_REG_LOG_SIZE - 1);
+				// the pending samples are rendered by touch_sound()
+				pending = get_sound_pending_samples();
+			}
+			reg_log[reg_log_write].sample = sample_pos + pending;
+			reg_log[reg_log_write].addr = addr;
+			reg_log[reg_log_write].data = data;
+			reg_log_write = next;
+			port_log[addr].written = true;
+			port_log[addr].data = data;
+			return;
+		}
+	}
 	touch_sound();
+	if(reg_log_read != reg_log_write) {
+		// touch_sound() may not render all pending samples
+		apply_reg_log(sample_pos + get_sound_pending_samples());
+	}
+	write_reg(addr, data);
+#ifdef SUPPORT_MAME_FM_DLL
+	if(0x2d <= addr && addr <= 0x2f) {
+		port_log[0x2d].written = port_log[0x2e].written = port_log[0x2f].written = false;
+	}
+#endif
+	port_log[addr].written = true;
+	port_log[addr].data = data;
+}
+
+void YM2203::write_reg(uint32_t addr, uint32_t data)
+{
 	if(is_ym2608) {
 		opna->SetReg(addr, data);
 	} else {
@@ -511,12 +643,7 @@ void YM2203::set_reg(uint32_t addr, uint32_t data)
 	if(dllchip) {
 		fmdll->SetReg(dllchip, addr, data);
 	}
-	if(0x2d <= addr && addr <= 0x2f) {
-		port_log[0x2d].written = port_log[0x2e].written = port_log[0x2f].written = false;
-	}
 #endif
-	port_log[addr].written = true;
-	port_log[addr].data = data;
 }
 
 void YM2203::update_timing(int new_clocks, double new_frames_per_sec, int new_lines_per_frame)
@@ -538,6 +665,12 @@ bool YM2203::process_state(FILEIO* state_fio, bool loading)
 	if(!state_fio->StateCheckInt32(this_device_id)) {
 		return false;
 	}
+	if(loading) {
+		reg_log_read = reg_log_write;
+	} else {
+		// apply all logged register writes before the chip is saved
+		apply_reg_log(sample_pos + 0x7fffffff);
+	}
 	if(is_ym2608) {
 		if(!opna->ProcessState((void *)state_fio, loading)) {
 			return false;
@@ -71,8 +71,24 @@ private:
 	uint32_t clock_busy;
 	bool busy;
 	
+	// register writes to fm/psg/rhythm are logged with the sample position,
+	// and they are applied in mix() so that the chip is rendered in large blocks.
+	// single producer (cpu) and single consumer (mix) ring buffer without lock
+	#define YM2203_REG_LOG_SIZE	4096
+	struct {
+		uint32_t sample;
+		uint16_t addr;
+		uint8_t data;
+	} reg_log[YM2203_REG_LOG_SIZE];
+	volatile int reg_log_read, reg_log_write;
+	uint32_t sample_pos;
+	
 	void update_count();
 	void update_event();
+	bool is_deferred_reg(uint32_t addr);
+	void write_reg(uint32_t addr, uint32_t data);
+	void apply_reg_log(uint32_t sample);
+	void log_reg(uint32_t addr, uint32_t data);
 	
 	// output signals
 	outputs_t outputs_irq;
@@ -109,6 +125,14 @@ public:
 	void event_vline(int v, int clock);
 	void event_callback(int event_id, int error);
 	void mix(int32_t* buffer, int cnt);
+	bool is_mix_thread_safe()
+	{
+#ifdef SUPPORT_MAME_FM_DLL
+		return (dllchip == NULL);
+#else
+		return true;
+#endif
+	}
 	void set_volume(int ch, int decibel_l, int decibel_r);
 	void update_timing(int new_clocks, double new_frames_per_sec, int new_lines_per_frame);
 	// for debugging
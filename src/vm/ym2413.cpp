@@ -32,6 +32,7 @@ to do:
 
 #include <math.h>
 #include "ym2413.h"
+#include "vgm_logger.h"
 
 #define MAME_INLINE static
 #define logerror(...)
@@ -135,7 +136,7 @@ static FILE *sample[1];
       fputc(((unsigned short)pom>>8)&0xff,sample[0]); \
     }
     #define SAVE_SEPARATE_CHANNEL(j) \
-    {  signed int pom = outchan; \
+    {  signed int pom = chip->outchan; \
       fputc((unsigned short)pom&0xff,sample[0]); \
       fputc(((unsigned short)pom>>8)&0xff,sample[0]); \
       pom = chip->instvol_r[j]>>4; \
@@ -205,7 +206,7 @@ typedef struct{
 } YM2413_OPLL_CH;
 
 /* chip state */
-typedef struct {
+typedef struct YM2413C {
     YM2413_OPLL_CH P_CH[9];                /* OPLL chips have 9 channels*/
   UINT8  instvol_r[9];      /* instrument/volume (or volume/volume in percussive mode)*/
 
@@ -221,6 +222,11 @@ typedef struct {
   UINT32  lfo_am_inc;
   UINT32  lfo_pm_cnt;
   UINT32  lfo_pm_inc;
+  UINT32  LFO_AM;          /* current LFO AM level */
+  INT32   LFO_PM;          /* current LFO PM index */
+
+  signed int output[2];      /* output of current sample */
+  signed int outchan;
 
   UINT32  noise_rng;        /* 23 bit noise shift register  */
   UINT32  noise_p;        /* current noise 'phase'    */
@@ -235,14 +241,9 @@ typedef struct {
 */
   UINT8 inst_tab[19][8];
 
-  /* external event callback handlers */
-  OPLL_UPDATEHANDLER UpdateHandler; /* stream update handler    */
-  int UpdateParam;        /* stream update parameter    */
-
   UINT32  fn_tab[1024];      /* fnumber->increment counter  */
 
   UINT8 address;          /* address register        */
-  UINT8 status;          /* status flag          */
 
   int clock;            /* master clock  (Hz)      */
   int rate;            /* sampling rate (Hz)      */
@@ -592,16 +593,6 @@ static unsigned char table[19][8] = {
 /* lock level of common table */
 static int num_lock = 0;
 
-/* work table */
-static void *cur_chip = NULL;  /* current chip pointer */
-static YM2413_OPLL_SLOT *SLOT7_1,*SLOT7_2,*SLOT8_1,*SLOT8_2;
-
-static signed int output[2];
-static signed int outchan;
-
-static UINT32  LFO_AM;
-static INT32  LFO_PM;
-
 
 MAME_INLINE int limit( int val, int max, int min ) {
   if ( val > max )
@@ -621,10 +612,10 @@ MAME_INLINE void advance_lfo(YM2413C *chip)
   if (chip->lfo_am_cnt >= (LFO_AM_TAB_ELEMENTS<<LFO_SH) )  /* lfo_am_table is 210 elements long */
     chip->lfo_am_cnt -= (LFO_AM_TAB_ELEMENTS<<LFO_SH);
 
-  LFO_AM = lfo_am_table[ chip->lfo_am_cnt >> LFO_SH ] >> 1;
+  chip->LFO_AM = lfo_am_table[ chip->lfo_am_cnt >> LFO_SH ] >> 1;
 
   chip->lfo_pm_cnt += chip->lfo_pm_inc;
-  LFO_PM = (chip->lfo_pm_cnt>>LFO_SH) & 7;
+  chip->LFO_PM = (chip->lfo_pm_cnt>>LFO_SH) & 7;
 }
 
 /* advance to next sample */
@@ -807,7 +798,7 @@ MAME_INLINE void advance(YM2413C *chip)
 
       unsigned int fnum_lfo   = 8*((CH->block_fnum&0x01c0) >> 6);
       unsigned int block_fnum = CH->block_fnum * 2;
-      signed int lfo_fn_table_index_offset = lfo_pm_table[LFO_PM + fnum_lfo ];
+      signed int lfo_fn_table_index_offset = lfo_pm_table[chip->LFO_PM + fnum_lfo ];
 
       if (lfo_fn_table_index_offset)  /* LFO phase modulation active */
       {
@@ -895,10 +886,10 @@ MAME_INLINE signed int op_calc1(UINT32 phase, unsigned int env, signed int pm, u
 }
 
 
-#define volume_calc(OP) ((OP)->TLL + ((UINT32)(OP)->volume) + (LFO_AM & (OP)->AMmask))
+#define volume_calc(OP) ((OP)->TLL + ((UINT32)(OP)->volume) + (chip->LFO_AM & (OP)->AMmask))
 
 /* calculate output */
-MAME_INLINE void chan_calc( YM2413_OPLL_CH *CH )
+MAME_INLINE void chan_calc( YM2413C *chip, YM2413_OPLL_CH *CH )
 {
     YM2413_OPLL_SLOT *SLOT;
   unsigned int env;
@@ -925,15 +916,15 @@ MAME_INLINE void chan_calc( YM2413_OPLL_CH *CH )
 
   /* SLOT 2 */
 
-outchan=0;
+chip->outchan=0;
 
   SLOT++;
   env = volume_calc(SLOT);
   if( env < ENV_QUIET )
   {
     signed int outp = op_calc(SLOT->phase, env, phase_modulation, SLOT->wavetable);
-    output[0] += outp;
-    outchan = outp;
+    chip->output[0] += outp;
+    chip->outchan = outp;
     //output[0] += op_calc(SLOT->phase, env, phase_modulation, SLOT->wavetable);
   }
 }
@@ -975,9 +966,14 @@ number   number    BLK/FNUM2 FNUM    Drum  Hat   Drum  Tom  Cymbal
 
 /* calculate rhythm */
 
-MAME_INLINE void rhythm_calc( YM2413_OPLL_CH *CH, unsigned int noise )
+MAME_INLINE void rhythm_calc( YM2413C *chip, YM2413_OPLL_CH *CH, unsigned int noise )
 {
     YM2413_OPLL_SLOT *SLOT;
+    /* rhythm slots */
+    YM2413_OPLL_SLOT *SLOT7_1 = &CH[7].SLOT[SLOT1];
+    YM2413_OPLL_SLOT *SLOT7_2 = &CH[7].SLOT[SLOT2];
+    YM2413_OPLL_SLOT *SLOT8_1 = &CH[8].SLOT[SLOT1];
+    YM2413_OPLL_SLOT *SLOT8_2 = &CH[8].SLOT[SLOT2];
   signed int out;
   unsigned int env;
   signed int phase_modulation;  /* phase modulation input (SLOT 2) */
@@ -1012,7 +1008,7 @@ MAME_INLINE void rhythm_calc( YM2413_OPLL_CH *CH, unsigned int noise )
   SLOT++;
   env = volume_calc(SLOT);
   if( env < ENV_QUIET )
-    output[1] += op_calc(SLOT->phase, env, phase_modulation, SLOT->wavetable) * 2;
+    chip->output[1] += op_calc(SLOT->phase, env, phase_modulation, SLOT->wavetable) * 2;
 
 
   /* Phase generation is based on: */
@@ -1080,7 +1076,7 @@ MAME_INLINE void rhythm_calc( YM2413_OPLL_CH *CH, unsigned int noise )
         phase = 0xd0>>2;
     }
 
-    output[1] += op_calc(phase<<FREQ_SH, env, 0, SLOT7_1->wavetable) * 2;
+    chip->output[1] += op_calc(phase<<FREQ_SH, env, 0, SLOT7_1->wavetable) * 2;
   }
 
   /* Snare Drum (verified on real YM3812) */
@@ -1101,13 +1097,13 @@ MAME_INLINE void rhythm_calc( YM2413_OPLL_CH *CH, unsigned int noise )
     if (noise)
       phase ^= 0x100;
 
-    output[1] += op_calc(phase<<FREQ_SH, env, 0, SLOT7_2->wavetable) * 2;
+    chip->output[1] += op_calc(phase<<FREQ_SH, env, 0, SLOT7_2->wavetable) * 2;
   }
 
   /* Tom Tom (verified on real YM3812) */
   env = volume_calc(SLOT8_1);
   if( env < ENV_QUIET )
-    output[1] += op_calc(SLOT8_1->phase, env, 0, SLOT8_1->wavetable) * 2;
+    chip->output[1] += op_calc(SLOT8_1->phase, env, 0, SLOT8_1->wavetable) * 2;
 
   /* Top Cymbal (verified on real YM2413) */
   env = volume_calc(SLOT8_2);
@@ -1134,7 +1130,7 @@ MAME_INLINE void rhythm_calc( YM2413_OPLL_CH *CH, unsigned int noise )
     if (res2)
       phase = 0x300;
 
-    output[1] += op_calc(phase<<FREQ_SH, env, 0, SLOT8_2->wavetable) * 2;
+    chip->output[1] += op_calc(phase<<FREQ_SH, env, 0, SLOT8_2->wavetable) * 2;
   }
 
 }
@@ -1846,8 +1842,9 @@ static int OPLL_LockTable(void)
   if(num_lock>1) return 0;
 
   /* first time */
+  /* tables are shared by all chips, they are made when no chip exists
+     and are only read while chips are rendered */
 
-  cur_chip = NULL;
   /* allocate total level table (128kb space) */
   if( !init_tables() )
   {
@@ -1873,7 +1870,6 @@ static void OPLL_UnLockTable(void)
 
   /* last time */
 
-  cur_chip = NULL;
   OPLCloseTable();
 
 #ifdef LOG_CYM_FILE
@@ -1965,14 +1961,6 @@ static void OPLLDestroy(YM2413C *chip)
   free(chip);
 }
 
-/* Option handlers */
-
-static void OPLLSetUpdateHandler(YM2413C *chip,OPLL_UPDATEHANDLER UpdateHandler,int param)
-{
-  chip->UpdateHandler = UpdateHandler;
-  chip->UpdateParam = param;
-}
-
 /* YM3812 I/O interface */
 static void OPLLWrite(YM2413C *chip,int a,int v)
 {
@@ -1982,165 +1970,63 @@ static void OPLLWrite(YM2413C *chip,int a,int v)
   }
   else
   {  /* data port */
-    if(chip->UpdateHandler)
-		chip->UpdateHandler(chip->UpdateParam,0);
     OPLLWriteReg(chip,chip->address,v);
   }
 }
 
-static unsigned char OPLLRead(YM2413C *chip,int a)
-{
-  if( !(a&1) )
-  {
-    /* status port */
-    return chip->status;
-  }
-  return 0xff;
-}
-
-#define MAX_OPLL_CHIPS 4
-
-static YM2413C *OPLL_YM2413[MAX_OPLL_CHIPS];  /* array of pointers to the YM2413's */
-static int YM2413NumChips = 0;        /* number of chips */
-
-int YM2413Init(int num, int clock, int rate)
-{
-  int i;
-
-  if (YM2413NumChips)
-    return -1;  /* duplicate init. */
-
-  YM2413NumChips = num;
-
-  for (i = 0;i < YM2413NumChips; i++)
-  {
-    /* emulator create */
-    OPLL_YM2413[i] = OPLLCreate(clock, rate);
-    if(OPLL_YM2413[i] == NULL)
-    {
-      /* it's really bad - we run out of memeory */
-      YM2413NumChips = 0;
-      return -1;
-    }
-  }
-
-  return 0;
-}
-
-void YM2413Shutdown(void)
-{
-  int i;
-
-  for (i = 0;i < YM2413NumChips; i++)
-  {
-    /* emulator shutdown */
-        if(OPLL_YM2413[i])
-            OPLLDestroy(OPLL_YM2413[i]);
-    OPLL_YM2413[i] = NULL;
-  }
-  YM2413NumChips = 0;
-}
-
-void YM2413ResetChip(int which)
-{
-  OPLLResetChip(OPLL_YM2413[which]);
-}
-
-void YM2413Write(int which, int a, int v)
-{
-  OPLLWrite(OPLL_YM2413[which], a, v);
-}
-
-unsigned char YM2413Read(int which, int a)
-{
-  return OPLLRead(OPLL_YM2413[which], a) & 0x03 ;
-}
-
-void YM2413SetUpdateHandler(int which,OPLL_UPDATEHANDLER UpdateHandler,int param)
-{
-  OPLLSetUpdateHandler(OPLL_YM2413[which], UpdateHandler, param);
-}
-
-
 /*
-** Generate samples for one of the YM2413's
+** Generate one sample of the YM2413
 **
-** 'which' is the virtual YM2413 number
-** '*buffer' is the output buffer pointer
-** 'length' is the number of samples that should be generated
+** 'mo' and 'ro' are the output of melody and rhythm
 */
-void YM2413UpdateOne(int which, INT16 **buffers, int length)
+MAME_INLINE void OPLLCalcSample(YM2413C *chip, int *mo_out, int *ro_out)
 {
-  YM2413C    *chip  = OPLL_YM2413[which];
-  UINT8    rhythm = chip->rhythm&0x20;
-  SAMP    *bufMO = buffers[0];
-  SAMP    *bufRO = buffers[1];
+  int mo,ro;
 
-  int i;
+  chip->output[0] = 0;
+  chip->output[1] = 0;
 
-  if( (void *)chip != cur_chip ){
-    cur_chip = (void *)chip;
-    /* rhythm slots */
-    SLOT7_1 = &chip->P_CH[7].SLOT[SLOT1];
-    SLOT7_2 = &chip->P_CH[7].SLOT[SLOT2];
-    SLOT8_1 = &chip->P_CH[8].SLOT[SLOT1];
-    SLOT8_2 = &chip->P_CH[8].SLOT[SLOT2];
-  }
-
-
-  for( i=0; i < length ; i++ )
-  {
-    int mo,ro;
-
-    output[0] = 0;
-    output[1] = 0;
+  advance_lfo(chip);
 
-    advance_lfo(chip);
-
-    /* FM part */
-    chan_calc(&chip->P_CH[0]);
+  /* FM part */
+  chan_calc(chip, &chip->P_CH[0]);
 //SAVE_SEPARATE_CHANNEL(0);
-    chan_calc(&chip->P_CH[1]);
-    chan_calc(&chip->P_CH[2]);
-    chan_calc(&chip->P_CH[3]);
-    chan_calc(&chip->P_CH[4]);
-    chan_calc(&chip->P_CH[5]);
+  chan_calc(chip, &chip->P_CH[1]);
+  chan_calc(chip, &chip->P_CH[2]);
+  chan_calc(chip, &chip->P_CH[3]);
+  chan_calc(chip, &chip->P_CH[4]);
+  chan_calc(chip, &chip->P_CH[5]);
 
-    if(!rhythm)
-    {
-      chan_calc(&chip->P_CH[6]);
-      chan_calc(&chip->P_CH[7]);
-      chan_calc(&chip->P_CH[8]);
-    }
-    else    /* Rhythm part */
-    {
-      rhythm_calc(&chip->P_CH[0], (chip->noise_rng>>0)&1 );
-    }
-
-    mo = output[0];
-    ro = output[1];
+  if(!(chip->rhythm&0x20))
+  {
+    chan_calc(chip, &chip->P_CH[6]);
+    chan_calc(chip, &chip->P_CH[7]);
+    chan_calc(chip, &chip->P_CH[8]);
+  }
+  else    /* Rhythm part */
+  {
+    rhythm_calc(chip, &chip->P_CH[0], (chip->noise_rng>>0)&1 );
+  }
 
-    mo >>= FINAL_SH;
-    ro >>= FINAL_SH;
+  mo = chip->output[0];
+  ro = chip->output[1];
 
-    /* limit check */
-    mo = limit( mo , MAXOUT, MINOUT );
-    ro = limit( ro , MAXOUT, MINOUT );
+  mo >>= FINAL_SH;
+  ro >>= FINAL_SH;
 
-    #ifdef SAVE_SAMPLE
-    if (which==0)
-    {
-      SAVE_ALL_CHANNELS
-    }
-    #endif
+  /* limit check */
+  mo = limit( mo , MAXOUT, MINOUT );
+  ro = limit( ro , MAXOUT, MINOUT );
 
-    /* store to sound buffer */
-    bufMO[i] = mo;
-    bufRO[i] = ro;
+  #ifdef SAVE_SAMPLE
+  SAVE_ALL_CHANNELS
+  #endif
 
-    advance(chip);
-  }
+  /* store to sound buffer */
+  *mo_out = mo;
+  *ro_out = ro;
 
+  advance(chip);
 }
 
 /*
@@ -2154,29 +2040,50 @@ void YM2413UpdateOne(int which, INT16 **buffers, int length)
 
 void YM2413::initialize()
 {
-	buf[0] = buf[1] = NULL;
+	chip = NULL;
 	mute = false;
+	memset(reg, 0, sizeof(reg));
 }
 
 void YM2413::release()
 {
-	if(buf[0]) {
-		free(buf[0]);
+	if(chip) {
+		OPLLDestroy(chip);
+		chip = NULL;
 	}
-	if(buf[1]) {
-		free(buf[1]);
-	}
-	YM2413Shutdown();
 }
 
 void YM2413::reset()
 {
 	touch_sound();
-	YM2413ResetChip(0);
+	if(chip) {
+		OPLLResetChip(chip);
+	}
+}
+
+void YM2413::log_reg(uint32_t addr, uint32_t data)
+{
+	VGM_LOGGER* logger = emu->get_vgm_logger();
+	uint32_t clock = get_current_clock(), clocks_per_sec = get_event_clocks();
+	
+	if(!logger->is_registered(this)) {
+		// log the current registers with key off
+		for(int i = 0; i < 0x39; i++) {
+			if((i & 0x0f) <= 8) {
+				logger->write(VGM_YM2413, this, chip_clock, clock, clocks_per_sec, 0, i, (i >= 0x20 && i < 0x30) ? (reg[i] & 0xef) : reg[i]);
+			} else if(i == 0x0e) {
+				logger->write(VGM_YM2413, this, chip_clock, clock, clocks_per_sec, 0, i, reg[i] & 0xe0);
+			}
+		}
+	}
+	logger->write(VGM_YM2413, this, chip_clock, clock, clocks_per_sec, 0, addr, data);
 }
 
 void YM2413::write_io8(uint32_t addr, uint32_t data)
 {
+	if((addr & 1) && emu->get_vgm_logger() != NULL) {
+		log_reg(latch & 0x3f, data);
+	}
 	touch_sound();
 	if (addr & 1) {
 		reg[ latch & 0x3F] = data;
@@ -2184,7 +2091,7 @@ void YM2413::write_io8(uint32_t addr, uint32_t data)
 	} else {
 		latch = data;
 	}
-	YM2413Write(0, addr & 1, data);
+	OPLLWrite(chip, addr & 1, data);
 }
 
 uint32_t YM2413::read_io8(uint32_t addr)
@@ -2204,20 +2111,16 @@ void YM2413::mix(int32_t* buffer, int cnt)
 	if(mute) {
 		return;
 	}
-	if(cnt > 0) YM2413UpdateOne(0, buf, cnt);
+	// render samples into the buffer directly
 	for(int i = 0; i < cnt; i++) {
-//		int32_t vol1 = 0;
-//		int32_t vol2 = 0;
-//		vol1 += buf[0][i];
-//		vol2 += buf[1][i];
-//		*buffer++ += vol1<<2; // L
-//		*buffer++ += vol2<<2; // R
+		int mo, ro;
+		OPLLCalcSample(chip, &mo, &ro);
 #if defined(_MSX1_VARIANTS) || defined(_MSX2_VARIANTS) || defined(_MSX2P_VARIANTS)
-		*buffer++ += apply_volume((buf[0][i] + buf[1][i]) * 4, volume_l); // L
-		*buffer++ += apply_volume((buf[0][i] + buf[1][i]) * 4, volume_r); // R
+		*buffer++ += apply_volume((mo + ro) * 4, volume_l); // L
+		*buffer++ += apply_volume((mo + ro) * 4, volume_r); // R
 #else
-		*buffer++ += apply_volume(buf[0][i] * 4, volume_l); // L
-		*buffer++ += apply_volume(buf[1][i] * 4, volume_r); // R
+		*buffer++ += apply_volume(mo * 4, volume_l); // L
+		*buffer++ += apply_volume(ro * 4, volume_r); // R
 #endif
 	}
 }
@@ -2230,8 +2133,16 @@ void YM2413::set_volume(int ch, int decibel_l, int decibel_r)
 
 void YM2413::initialize_sound(int rate, int clock, int samples)
 {
-	YM2413Init(1, clock, rate);
-	YM2413ResetChip(0);
-	buf[0] = (INT16 *)malloc(sizeof(INT16) * samples * 2);
-	buf[1] = (INT16 *)malloc(sizeof(INT16) * samples * 2);
+	if(config.sound_native_rate) {
+		// render at the sampling rate of the chip, and the sound manager resamples it
+		rate = clock / 72;
+		set_sound_native_rate(this, rate);
+	} else {
+		set_sound_native_rate(this, 0);
+	}
+	if(chip) {
+		OPLLDestroy(chip);
+	}
+	chip = OPLLCreate(clock, rate);
+	chip_clock = clock;
 }
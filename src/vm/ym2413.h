@@ -16,9 +16,8 @@
 
 #define SIG_YM2413_MUTE		0
 
-typedef INT16 SAMP;
-typedef void (*OPLL_UPDATEHANDLER)(int param,int min_interval_us);
-void YM2413SetUpdateHandler(int which, OPLL_UPDATEHANDLER UpdateHandler, int param);
+// state of each chip, the core keeps no state of chips in static variables
+struct YM2413C;
 
 class YM2413 : public DEVICE
 {
@@ -26,9 +25,12 @@ private:
 	uint8_t latch;
 	uint8_t reg[0x40];
 	bool mute;
-	INT16 *buf[2];
+	YM2413C *chip;
+	int chip_clock;
 	int volume_l, volume_r;
 	
+	void log_reg(uint32_t addr, uint32_t data);
+	
 public:
 	YM2413(VM_TEMPLATE* parent_vm, EMU* parent_emu) : DEVICE(parent_vm, parent_emu)
 	{
@@ -45,6 +47,10 @@ public:
 	uint32_t read_io8(uint32_t addr);
 	void write_signal(int id, uint32_t data, uint32_t mask);
 	void mix(int32_t* buffer, int cnt);
+	bool is_mix_thread_safe()
+	{
+		return true;
+	}
 	void set_volume(int ch, int decibel_l, int decibel_r);
 	
 	// unique functions
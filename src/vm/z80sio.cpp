@@ -86,13 +86,13 @@ void Z80SIO::initialize()
 {
 	for(int ch = 0; ch < 2; ch++) {
 #ifdef HAS_UPD7201
-		port[ch].send = new FIFO(16);
-		port[ch].recv = new FIFO(16);
-		port[ch].rtmp = new FIFO(16);
+		port[ch].send = new RING_BUFFER<uint8_t>(16);
+		port[ch].recv = new RING_BUFFER<uint8_t>(16);
+		port[ch].rtmp = new RING_BUFFER<uint8_t>(16);
 #else
-		port[ch].send = new FIFO(1);
-		port[ch].recv = new FIFO(4);
-		port[ch].rtmp = new FIFO(8);
+		port[ch].send = new RING_BUFFER<uint8_t>(1);
+		port[ch].recv = new RING_BUFFER<uint8_t>(4);
+		port[ch].rtmp = new RING_BUFFER<uint8_t>(8);
 #endif
 		// input signals
 		port[ch].dcd = true;
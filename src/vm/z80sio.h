@@ -32,7 +32,7 @@
 #define SIG_Z80SIO_CLEAR_CH0	14
 #define SIG_Z80SIO_CLEAR_CH1	15
 
-class FIFO;
+template <class T> class RING_BUFFER;
 
 class Z80SIO : public DEVICE
 {
@@ -61,9 +61,9 @@ private:
 		bool prev_tx_clock_signal;
 		bool prev_rx_clock_signal;
 		// buffer
-		FIFO* send;
-		FIFO* recv;
-		FIFO* rtmp;
+		RING_BUFFER<uint8_t>* send;
+		RING_BUFFER<uint8_t>* recv;
+		RING_BUFFER<uint8_t>* rtmp;
 		int shift_reg;
 		int send_id;
 		int recv_id;
@@ -8,6 +8,13 @@
 */
 
 #include "osd.h"
+#include "../fileio.h"
+
+#if defined(USE_STATE) && defined(USE_ZLIB)
+	#define ZLIB_WINAPI
+	#include "../zlib-1.2.11/zlib.h"
+	#include "../zlib-1.2.11/zconf.h"
+#endif
 
 void OSD::initialize(int rate, int samples)
 {
@@ -32,6 +39,11 @@ void OSD::initialize(int rate, int samples)
 #ifdef USE_MIDI
 	initialize_midi();
 #endif
+#ifdef USE_STATE
+	hStateThread = (HANDLE)0;
+	save_state_thread_param.buffer = NULL;
+	save_state_thread_param.result = 0;
+#endif
 }
 
 void OSD::release()
@@ -49,6 +61,9 @@ void OSD::release()
 #endif
 #ifdef USE_MIDI
 	release_midi();
+#endif
+#ifdef USE_STATE
+	wait_save_state();
 #endif
 	GdiplusShutdown(gdiToken);
 }
@@ -100,6 +115,272 @@ void OSD::sleep(uint32_t ms)
 	Sleep(ms);
 }
 
+#ifdef USE_STATE
+// compressed state file is split into independent zlib streams,
+// so that both saving and loading can be spread over processors
+#define STATE_CHUNK_SIGNATURE	"CSPSTATECHUNK.0"
+#define STATE_CHUNK_SIZE	0x100000
+#define MAX_STATE_THREADS	8
+
+#ifdef USE_ZLIB
+typedef struct {
+	uint8_t* raw;
+	size_t raw_size;
+	size_t chunk_size;
+	uint8_t** chunk;
+	uint32_t* chunk_length;
+	int chunks;
+	bool deflate;
+	volatile LONG next;
+	volatile LONG error;
+} state_chunk_job_t;
+
+static void process_state_chunks(state_chunk_job_t *p)
+{
+	LONG i;
+	
+	while((i = InterlockedIncrement(&p->next) - 1) < p->chunks && p->error == 0) {
+		size_t offset = p->chunk_size * i;
+		uLong length = (uLong)((p->raw_size - offset < p->chunk_size) ? p->raw_size - offset : p->chunk_size);
+		
+		if(p->deflate) {
+			uLongf dest_length = compressBound(length);
+			if((p->chunk[i] = (uint8_t *)malloc(dest_length)) == NULL || compress2(p->chunk[i], &dest_length, p->raw + offset, length, Z_BEST_SPEED) != Z_OK) {
+				InterlockedExchange(&p->error, 1);
+				break;
+			}
+			p->chunk_length[i] = (uint32_t)dest_length;
+		} else {
+			uLongf dest_length = length;
+			if(uncompress(p->raw + offset, &dest_length, p->chunk[i], p->chunk_length[i]) != Z_OK || dest_length != length) {
+				InterlockedExchange(&p->error, 1);
+				break;
+			}
+		}
+	}
+}
+
+unsigned __stdcall state_chunk_thread(void *lpx)
+{
+	process_state_chunks((state_chunk_job_t *)lpx);
+	_endthreadex(0);
+	return 0;
+}
+
+static bool run_state_chunks(state_chunk_job_t *p)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int threads = (int)info.dwNumberOfProcessors;
+	if(threads > p->chunks) {
+		threads = p->chunks;
+	}
+	if(threads > MAX_STATE_THREADS) {
+		threads = MAX_STATE_THREADS;
+	}
+	HANDLE hThread[MAX_STATE_THREADS];
+	int started = 0;
+	
+	p->next = 0;
+	p->error = 0;
+	for(int i = 1; i < threads; i++) {
+		if((hThread[started] = (HANDLE)_beginthreadex(NULL, 0, state_chunk_thread, p, 0, NULL)) != (HANDLE)0) {
+			started++;
+		}
+	}
+	// this thread also takes chunks, so the job completes even if no helper could be started
+	process_state_chunks(p);
+	if(started != 0) {
+		WaitForMultipleObjects(started, hThread, TRUE, INFINITE);
+		for(int i = 0; i < started; i++) {
+			CloseHandle(hThread[i]);
+		}
+	}
+	return (p->error == 0);
+}
+
+static bool write_state_chunks(FILEIO *fio, uint8_t *buffer, size_t size)
+{
+	state_chunk_job_t job;
+	bool result = false;
+	
+	job.raw = buffer;
+	job.raw_size = size;
+	job.chunk_size = STATE_CHUNK_SIZE;
+	job.chunks = (int)((size + STATE_CHUNK_SIZE - 1) / STATE_CHUNK_SIZE);
+	job.deflate = true;
+	job.chunk = (uint8_t **)calloc(job.chunks + 1, sizeof(uint8_t *));
+	job.chunk_length = (uint32_t *)calloc(job.chunks + 1, sizeof(uint32_t));
+	
+	if(job.chunk != NULL && job.chunk_length != NULL && run_state_chunks(&job)) {
+		fio->Fwrite(STATE_CHUNK_SIGNATURE, 16, 1);
+		fio->FputUint32_LE((uint32_t)job.raw_size);
+		fio->FputUint32_LE((uint32_t)job.chunk_size);
+		fio->FputUint32_LE((uint32_t)job.chunks);
+		fio->FputUint32_LE(0);
+		for(int i = 0; i < job.chunks; i++) {
+			fio->FputUint32_LE(job.chunk_length[i]);
+		}
+		result = true;
+		for(int i = 0; i < job.chunks && result; i++) {
+			result = (fio->Fwrite(job.chunk[i], job.chunk_length[i], 1) == 1);
+		}
+	}
+	if(job.chunk != NULL) {
+		for(int i = 0; i < job.chunks; i++) {
+			if(job.chunk[i] != NULL) {
+				free(job.chunk[i]);
+			}
+		}
+		free(job.chunk);
+	}
+	if(job.chunk_length != NULL) {
+		free(job.chunk_length);
+	}
+	return result;
+}
+#endif
+
+unsigned __stdcall save_state_thread(void *lpx)
+{
+	save_state_thread_param_t *p = (save_state_thread_param_t *)lpx;
+	_TCHAR tmp_path[_MAX_PATH];
+	bool result = false;
+	
+	// write to the temporary file first not to break the previous state file
+	my_stprintf_s(tmp_path, _MAX_PATH, _T("%s.tmp"), p->file_path);
+	FILEIO* fio = new FILEIO();
+	if(fio->Fopen(tmp_path, FILEIO_WRITE_BINARY)) {
+#ifdef USE_ZLIB
+		if(p->compress) {
+			result = write_state_chunks(fio, p->buffer, p->size);
+		} else
+#endif
+		result = (fio->Fwrite(p->buffer, p->size, 1) == 1);
+		fio->Fclose();
+		
+		if(result) {
+			if(FILEIO::IsFileExisting(p->file_path)) {
+				FILEIO::RemoveFile(p->file_path);
+			}
+			result = FILEIO::RenameFile(tmp_path, p->file_path);
+		}
+		if(!result) {
+			FILEIO::RemoveFile(tmp_path);
+		}
+	}
+	delete fio;
+	
+	free(p->buffer);
+	p->buffer = NULL;
+	InterlockedExchange(&p->result, result ? SAVE_STATE_SUCCESS : SAVE_STATE_ERROR);
+	_endthreadex(0);
+	return 0;
+}
+
+void OSD::start_save_state(const _TCHAR* file_path, uint8_t* buffer, size_t size, bool compress)
+{
+	// the state buffer is owned by the thread and released when it is written
+	wait_save_state();
+	
+	my_tcscpy_s(save_state_thread_param.file_path, _MAX_PATH, file_path);
+	save_state_thread_param.buffer = buffer;
+	save_state_thread_param.size = size;
+	save_state_thread_param.compress = compress;
+	save_state_thread_param.result = 0;
+	
+	if((hStateThread = (HANDLE)_beginthreadex(NULL, 0, save_state_thread, &save_state_thread_param, 0, NULL)) == (HANDLE)0) {
+		// failed to create thread
+		save_state_thread_param.buffer = NULL;
+		save_state_thread_param.result = SAVE_STATE_ERROR;
+		free(buffer);
+	}
+}
+
+void OSD::wait_save_state()
+{
+	if(hStateThread != (HANDLE)0) {
+		WaitForSingleObject(hStateThread, INFINITE);
+		CloseHandle(hStateThread);
+		hStateThread = (HANDLE)0;
+	}
+}
+
+int OSD::check_save_state()
+{
+	// returns the result only once when the thread is finished
+	int result = (int)InterlockedCompareExchange(&save_state_thread_param.result, 0, 0);
+	
+	if(result != 0) {
+		wait_save_state();
+		InterlockedExchange(&save_state_thread_param.result, 0);
+	}
+	return result;
+}
+
+bool OSD::load_state_image(const _TCHAR* file_path, uint8_t** buffer, size_t* size)
+{
+	bool result = false;
+	
+	wait_save_state();
+	
+#ifdef USE_ZLIB
+	FILEIO* fio = new FILEIO();
+	if(fio->Fopen(file_path, FILEIO_READ_BINARY)) {
+		char signature[16];
+		if(fio->Fread(signature, sizeof(signature), 1) == 1 && memcmp(signature, STATE_CHUNK_SIGNATURE, 16) == 0) {
+			state_chunk_job_t job;
+			job.raw_size = fio->FgetUint32_LE();
+			job.chunk_size = fio->FgetUint32_LE();
+			job.chunks = (int)fio->FgetUint32_LE();
+			job.deflate = false;
+			fio->FgetUint32_LE(); // reserved
+			
+			if(job.chunk_size != 0 && job.chunks == (int)((job.raw_size + job.chunk_size - 1) / job.chunk_size)) {
+				job.raw = (uint8_t *)malloc(job.raw_size + 1);
+				job.chunk = (uint8_t **)calloc(job.chunks + 1, sizeof(uint8_t *));
+				job.chunk_length = (uint32_t *)calloc(job.chunks + 1, sizeof(uint32_t));
+				
+				if(job.raw != NULL && job.chunk != NULL && job.chunk_length != NULL) {
+					bool loaded = true;
+					for(int i = 0; i < job.chunks && loaded; i++) {
+						job.chunk_length[i] = fio->FgetUint32_LE();
+						loaded = (job.chunk_length[i] != 0 && job.chunk_length[i] <= compressBound((uLong)job.chunk_size));
+					}
+					for(int i = 0; i < job.chunks && loaded; i++) {
+						loaded = ((job.chunk[i] = (uint8_t *)malloc(job.chunk_length[i])) != NULL && fio->Fread(job.chunk[i], job.chunk_length[i], 1) == 1);
+					}
+					if(loaded && run_state_chunks(&job)) {
+						*buffer = job.raw;
+						*size = job.raw_size;
+						job.raw = NULL;
+						result = true;
+					}
+				}
+				if(job.raw != NULL) {
+					free(job.raw);
+				}
+				if(job.chunk != NULL) {
+					for(int i = 0; i < job.chunks; i++) {
+						if(job.chunk[i] != NULL) {
+							free(job.chunk[i]);
+						}
+					}
+					free(job.chunk);
+				}
+				if(job.chunk_length != NULL) {
+					free(job.chunk_length);
+				}
+			}
+		}
+		fio->Fclose();
+	}
+	delete fio;
+#endif
+	return result;
+}
+#endif
+
 #ifdef USE_DEBUGGER
 FARPROC hWndProc = NULL;
 OSD *my_osd = NULL;
@@ -51,6 +51,7 @@
 //#include "../emu.h"
 #include "../common.h"
 #include "../config.h"
+#include "../scaler.h"
 
 #if defined(USE_ZLIB) && !defined(USE_VCPKG)				// zlib not installed by vcpkg
 	// relative path from *.vcproj/*.vcxproj, not from this directory :-(
@@ -197,6 +198,7 @@ public:
 // osd common
 
 class FIFO;
+class DEVICE;
 class FILEIO;
 
 #define OSD_CONSOLE_BLUE	1 // text color contains blue
@@ -258,6 +260,39 @@ typedef struct {
 	int result;
 } rec_video_thread_param_t;
 
+#define MAX_SCALER_THREADS	8
+
+typedef struct {
+	DEVICE* device;		// render lines of vm device if not NULL
+	DEVICE** mix_devices;	// mix sound of vm devices if not NULL
+	int32_t** mix_buffers;
+	int* mix_samples;
+	scaler_image_t source, dest;
+	bool rgb_filter, skip_line;
+	int pow_x, pow_y;
+	int lines, band_lines, bands;
+	volatile LONG next;
+} scaler_job_t;
+
+typedef struct {
+	scaler_job_t* job;
+	HANDLE hStart, hDone;
+	bool terminate;
+} scaler_thread_param_t;
+
+#ifdef USE_STATE
+#define SAVE_STATE_SUCCESS	1
+#define SAVE_STATE_ERROR	2
+
+typedef struct {
+	_TCHAR file_path[_MAX_PATH];
+	uint8_t* buffer;
+	size_t size;
+	bool compress;
+	volatile LONG result;	// written by the thread with InterlockedExchange
+} save_state_thread_param_t;
+#endif
+
 #ifdef USE_MIDI
 typedef struct midi_thread_params_s {
 	FIFO *send_buffer;
@@ -266,6 +301,24 @@ typedef struct midi_thread_params_s {
 } midi_thread_params_t;
 #endif
 
+// the emulation thread pushes the rendered samples to the ring,
+// and the audio thread pulls them to the secondary buffer
+typedef struct sound_thread_params_s {
+	LPDIRECTSOUNDBUFFER lpdsSecondaryBuffer;
+	DWORD buffer_size;	// bytes of secondary buffer
+	DWORD lead_size;	// bytes written ahead of the play cursor
+	DWORD write_pos;
+	int16_t *ring;		// L, R
+	int ring_size;		// samples
+	int ring_target;	// samples kept in the ring
+	volatile LONG ring_read;	// modified only by the audio thread
+	volatile LONG ring_write;	// modified only by the emulation thread
+	uint32_t ring_frac;	// fraction of the read position in 16.16 fixed point
+	double ring_fill;
+	volatile LONG underruns;
+	volatile bool started, muted, flush, terminate;
+} sound_thread_params_t;
+
 class OSD
 {
 private:
@@ -344,16 +397,14 @@ private:
 	void release_screen_buffer(bitmap_t *buffer);
 #ifdef USE_SCREEN_FILTER
 	void apply_rgb_filter_to_screen_buffer(bitmap_t *source, bitmap_t *dest);
-	void apply_rgb_filter_x3_y3(bitmap_t *source, bitmap_t *dest);
-	void apply_rgb_filter_x3_y2(bitmap_t *source, bitmap_t *dest);
-	void apply_rgb_filter_x2_y3(bitmap_t *source, bitmap_t *dest);
-	void apply_rgb_filter_x2_y2(bitmap_t *source, bitmap_t *dest);
-	void apply_rgb_filter_x1_y1(bitmap_t *source, bitmap_t *dest);
 #endif
 //#ifdef USE_SCREEN_ROTATE
 	void rotate_screen_buffer(bitmap_t *source, bitmap_t *dest);
 //#endif
 	void stretch_screen_buffer(bitmap_t *source, bitmap_t *dest);
+	void initialize_scaler();
+	void release_scaler();
+	void run_scaler(bitmap_t *source, bitmap_t *dest, bool rgb_filter);
 #ifdef SUPPORT_D2D1
 	bool initialize_d2d1();
 	bool initialize_d2d1_surface(bitmap_t *buffer);
@@ -385,6 +436,12 @@ private:
 	bitmap_t reversed_screen_buffer;
 	bitmap_t video_screen_buffer;
 	
+	int scaler_threads, render_threads;
+	HANDLE hScalerThread[MAX_SCALER_THREADS];
+	HANDLE hScalerDone[MAX_SCALER_THREADS];
+	scaler_job_t scaler_job;
+	scaler_thread_param_t scaler_thread_param[MAX_SCALER_THREADS];
+	
 	bitmap_t* draw_screen_buffer;
 	
 	int host_window_width, host_window_height;
@@ -433,6 +490,7 @@ private:
 	// sound
 	void initialize_sound(int rate, int samples);
 	void release_sound();
+	void record_sound(uint16_t* sound_buffer);
 	
 	int sound_rate, sound_samples;
 	bool sound_available, sound_started, sound_muted;
@@ -441,6 +499,10 @@ private:
 	LPDIRECTSOUNDBUFFER lpdsPrimaryBuffer, lpdsSecondaryBuffer;
 	bool sound_first_half;
 	
+	HANDLE hSoundThread;
+	sound_thread_params_t sound_thread_params;
+	int sound_overruns;
+	
 	_TCHAR sound_file_path[_MAX_PATH];
 	FILEIO* rec_sound_fio;
 	int rec_sound_bytes;
@@ -507,6 +569,12 @@ private:
 	midi_thread_params_t midi_thread_params;
 #endif
 	
+	// state
+#ifdef USE_STATE
+	HANDLE hStateThread;
+	save_state_thread_param_t save_state_thread_param;
+#endif
+	
 public:
 	OSD()
 	{
@@ -612,6 +680,9 @@ public:
 		return vm_window_height_aspect;
 	}
 	scrntype_t* get_vm_screen_buffer(int y);
+	void start_render_lines(DEVICE* device, int lines);
+	void finish_render_lines();
+	void run_mix_sound(DEVICE** devices, int32_t** buffers, int count, int* samples);
 	int draw_screen();
 #ifdef ONE_BOARD_MICRO_COMPUTER
 	void reload_bitmap()
@@ -637,6 +708,14 @@ public:
 	void stop_record_sound();
 	void restart_record_sound();
 	bool now_record_sound;
+	int get_sound_underrun_count()
+	{
+		return (hSoundThread != NULL) ? sound_thread_params.underruns : 0;
+	}
+	int get_sound_overrun_count()
+	{
+		return sound_overruns;
+	}
 #ifdef _UNITY	// MARU
 	int16_t	* get_sound_buffer();
 #endif // !_UNITY
@@ -729,6 +808,14 @@ public:
 	bool recv_from_midi(uint8_t *data);
 #endif
 	
+	// common state
+#ifdef USE_STATE
+	void start_save_state(const _TCHAR* file_path, uint8_t* buffer, size_t size, bool compress);
+	void wait_save_state();
+	int check_save_state();
+	bool load_state_image(const _TCHAR* file_path, uint8_t** buffer, size_t* size);
+#endif
+	
 	// win32 dependent
 	void invalidate_screen();
 	void update_screen(HDC hdc);
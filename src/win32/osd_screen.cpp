@@ -8,6 +8,7 @@
 */
 
 #include "osd.h"
+#include "../vm/device.h"
 
 #ifdef _UNITY
 #include "..\winplugin\emuwrap.h"
@@ -65,11 +66,14 @@ void OSD::initialize_screen()
 	first_draw_screen = false;
 	first_invalidate = true;
 	self_invalidate = false;
+	
+	initialize_scaler();
 }
 
 void OSD::release_screen()
 {
 	stop_record_video();
+	release_scaler();
 	
 #ifdef SUPPORT_D2D1
 	release_d2d1();
@@ -607,13 +611,6 @@ void OSD::release_screen_buffer(bitmap_t *buffer)
 }
 
 #ifdef USE_SCREEN_FILTER
-#define _3_8(v) (((((v) * 3) >> 3) * 180) >> 8)
-#define _5_8(v) (((((v) * 3) >> 3) * 180) >> 8)
-#define _8_8(v) (((v) * 180) >> 8)
-
-static uint8_t r0[2048], g0[2048], b0[2048], t0[2048];
-static uint8_t r1[2048], g1[2048], b1[2048];
-
 void OSD::apply_rgb_filter_to_screen_buffer(bitmap_t *source, bitmap_t *dest)
 {
 	if(source->width * 6 == dest->width && source->height * 6 == dest->height) {
@@ -623,7 +620,7 @@ void OSD::apply_rgb_filter_to_screen_buffer(bitmap_t *source, bitmap_t *dest)
 		}
 		stretch_screen_buffer(source, &tmp_filtered_screen_buffer);
 		screen_skip_line = true;
-		apply_rgb_filter_x3_y3(&tmp_filtered_screen_buffer, dest);
+		run_scaler(&tmp_filtered_screen_buffer, dest, true);
 	} else if(source->width * 3 == dest->width && source->height * 6 == dest->height) {
 		// FM-77AV: 640x200 -> 640x400 -> 1920x1200
 		if(tmp_filtered_screen_buffer.width != source->width || tmp_filtered_screen_buffer.height != source->height * 2) {
@@ -631,7 +628,7 @@ void OSD::apply_rgb_filter_to_screen_buffer(bitmap_t *source, bitmap_t *dest)
 		}
 		stretch_screen_buffer(source, &tmp_filtered_screen_buffer);
 		screen_skip_line = true;
-		apply_rgb_filter_x3_y3(&tmp_filtered_screen_buffer, dest);
+		run_scaler(&tmp_filtered_screen_buffer, dest, true);
 	} else if(source->width * 4 == dest->width && source->height * 4 == dest->height) {
 		// FM-77AV: 320x200 -> 640x400 -> 1280x800
 		if(tmp_filtered_screen_buffer.width != source->width * 2 || tmp_filtered_screen_buffer.height != source->height * 2) {
@@ -639,7 +636,7 @@ void OSD::apply_rgb_filter_to_screen_buffer(bitmap_t *source, bitmap_t *dest)
 		}
 		stretch_screen_buffer(source, &tmp_filtered_screen_buffer);
 		screen_skip_line = true;
-		apply_rgb_filter_x2_y2(&tmp_filtered_screen_buffer, dest);
+		run_scaler(&tmp_filtered_screen_buffer, dest, true);
 	} else if(source->width * 2 == dest->width && source->height * 4 == dest->height) {
 		// FM-77AV: 640x200 -> 640x400 -> 1280x800
 		if(tmp_filtered_screen_buffer.width != source->width || tmp_filtered_screen_buffer.height != source->height * 2) {
@@ -647,371 +644,18 @@ void OSD::apply_rgb_filter_to_screen_buffer(bitmap_t *source, bitmap_t *dest)
 		}
 		stretch_screen_buffer(source, &tmp_filtered_screen_buffer);
 		screen_skip_line = true;
-		apply_rgb_filter_x2_y2(&tmp_filtered_screen_buffer, dest);
-	} else if(source->width * 3 == dest->width && source->height * 3 == dest->height) {
-		apply_rgb_filter_x3_y3(source, dest);
-	} else if(source->width * 3 == dest->width && source->height * 2 == dest->height) {
-		apply_rgb_filter_x3_y2(source, dest);
-	} else if(source->width * 2 == dest->width && source->height * 3 == dest->height) {
-		apply_rgb_filter_x2_y3(source, dest);
-	} else if(source->width * 2 == dest->width && source->height * 2 == dest->height) {
-		apply_rgb_filter_x2_y2(source, dest);
+		run_scaler(&tmp_filtered_screen_buffer, dest, true);
+	} else if((source->width * 3 == dest->width || source->width * 2 == dest->width) && (source->height * 3 == dest->height || source->height * 2 == dest->height)) {
+		// x3_y3, x3_y2, x2_y3, x2_y2
+		run_scaler(source, dest, true);
 	} else if(source->width != dest->width || source->height != dest->height) {
 		if(tmp_filtered_screen_buffer.width != source->width || tmp_filtered_screen_buffer.height != source->height) {
 			initialize_screen_buffer(&tmp_filtered_screen_buffer, source->width, source->height, COLORONCOLOR);
 		}
-		apply_rgb_filter_x1_y1(source, &tmp_filtered_screen_buffer);
+		run_scaler(source, &tmp_filtered_screen_buffer, true);
 		stretch_screen_buffer(&tmp_filtered_screen_buffer, dest);
 	} else {
-		apply_rgb_filter_x1_y1(source, dest);
-	}
-}
-
-void OSD::apply_rgb_filter_x3_y3(bitmap_t *source, bitmap_t *dest)
-{
-	if(!screen_skip_line) {
-		for(int y = 0, yy = 0; y < source->height; y++, yy += 3) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(yy + 0);
-			scrntype_t* out2 = dest->get_buffer(yy + 1);
-			scrntype_t* out3 = dest->get_buffer(yy + 2);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				t0[x] = A_OF_COLOR(c);
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1, xx = 0; x <= source->width; x++, xx += 3) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[xx    ] = out2[xx    ] = (32 + _8_8(r)) << 16;
-				out1[xx + 1] = out2[xx + 1] = (32 + _8_8(g)) << 8;
-				out1[xx + 2] = out2[xx + 2] = (32 + _8_8(b));
-				if(t0[x]) {
-					out3[xx    ] = (32 + _8_8(r)) << 16;
-					out3[xx + 1] = (32 + _8_8(g)) << 8;
-					out3[xx + 2] = (32 + _8_8(b));
-				} else {
-					out3[xx    ] = (32 + _5_8(r)) << 16;
-					out3[xx + 1] = (32 + _5_8(g)) << 8;
-					out3[xx + 2] = (32 + _5_8(b));
-				}
-			}
-		}
-	} else {
-		for(int y = 0, yy = 0; y < source->height; y += 2, yy += 6) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(yy + 0);
-			scrntype_t* out2 = dest->get_buffer(yy + 1);
-			scrntype_t* out3 = dest->get_buffer(yy + 2);
-			scrntype_t* out4 = dest->get_buffer(yy + 3);
-			scrntype_t* out5 = dest->get_buffer(yy + 4);
-			scrntype_t* out6 = dest->get_buffer(yy + 5);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				t0[x] = A_OF_COLOR(c);
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1, xx = 0; x <= source->width; x++, xx += 3) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[xx    ] = out2[xx    ] = out3[xx    ] = out4[xx    ] = (32 + _8_8(r)) << 16;
-				out1[xx + 1] = out2[xx + 1] = out3[xx + 1] = out4[xx + 1] = (32 + _8_8(g)) << 8;
-				out1[xx + 2] = out2[xx + 2] = out3[xx + 2] = out4[xx + 2] = (32 + _8_8(b));
-				if(t0[x]) {
-					out5[xx    ] = out6[xx    ] = (32 + _8_8(r)) << 16;
-					out5[xx + 1] = out6[xx + 1] = (32 + _8_8(g)) << 8;
-					out5[xx + 2] = out6[xx + 2] = (32 + _8_8(b));
-				} else {
-					out5[xx    ] = out6[xx    ] = (32 + _5_8(r)) << 16;
-					out5[xx + 1] = out6[xx + 1] = (32 + _5_8(g)) << 8;
-					out5[xx + 2] = out6[xx + 2] = (32 + _5_8(b));
-				}
-			}
-		}
-	}
-}
-
-void OSD::apply_rgb_filter_x3_y2(bitmap_t *source, bitmap_t *dest)
-{
-	if(!screen_skip_line) {
-		for(int y = 0, yy = 0; y < source->height; y++, yy += 2) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(yy + 0);
-			scrntype_t* out2 = dest->get_buffer(yy + 1);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				t0[x] = A_OF_COLOR(c);
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1, xx = 0; x <= source->width; x++, xx += 3) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[xx    ] = (32 + _8_8(r)) << 16;
-				out1[xx + 1] = (32 + _8_8(g)) << 8;
-				out1[xx + 2] = (32 + _8_8(b));
-				if(t0[x]) {
-					out2[xx    ] = (32 + _8_8(r)) << 16;
-					out2[xx + 1] = (32 + _8_8(g)) << 8;
-					out2[xx + 2] = (32 + _8_8(b));
-				} else {
-					out2[xx    ] = (32 + _5_8(r)) << 16;
-					out2[xx + 1] = (32 + _5_8(g)) << 8;
-					out2[xx + 2] = (32 + _5_8(b));
-				}
-			}
-		}
-	} else {
-		for(int y = 0, yy = 0; y < source->height; y += 2, yy += 4) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(yy + 0);
-			scrntype_t* out2 = dest->get_buffer(yy + 1);
-			scrntype_t* out3 = dest->get_buffer(yy + 2);
-			scrntype_t* out4 = dest->get_buffer(yy + 3);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				t0[x] = A_OF_COLOR(c);
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1, xx = 0; x <= source->width; x++, xx += 3) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[xx    ] = out2[xx    ] = out3[xx    ] = (32 + _8_8(r)) << 16;
-				out1[xx + 1] = out2[xx + 1] = out3[xx + 1] = (32 + _8_8(g)) << 8;
-				out1[xx + 2] = out2[xx + 2] = out3[xx + 2] = (32 + _8_8(b));
-				if(t0[x]) {
-					out4[xx    ] = (32 + _8_8(r)) << 16;
-					out4[xx + 1] = (32 + _8_8(g)) << 8;
-					out4[xx + 2] = (32 + _8_8(b));
-				} else {
-					out4[xx    ] = (32 + _5_8(r)) << 16;
-					out4[xx + 1] = (32 + _5_8(g)) << 8;
-					out4[xx + 2] = (32 + _5_8(b));
-				}
-			}
-		}
-	}
-}
-
-void OSD::apply_rgb_filter_x2_y3(bitmap_t *source, bitmap_t *dest)
-{
-	if(!screen_skip_line) {
-		for(int y = 0, yy = 0; y < source->height; y++, yy += 3) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(yy + 0);
-			scrntype_t* out2 = dest->get_buffer(yy + 1);
-			scrntype_t* out3 = dest->get_buffer(yy + 2);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				t0[x] = A_OF_COLOR(c);
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1, xx = 0; x <= source->width; x++, xx += 2) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[xx    ] = out2[xx    ] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-				out1[xx + 1] = out2[xx + 1] = RGB_COLOR(16 + _5_8(r), 16 + _5_8(g), 16 + _5_8(b));
-				if(t0[x]) {
-					out3[xx    ] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-					out3[xx + 1] = RGB_COLOR(16 + _5_8(r), 16 + _5_8(g), 16 + _5_8(b));
-				} else {
-					out3[xx    ] = RGB_COLOR(32 + _3_8(r), 32 + _3_8(g), 32 + _3_8(b));
-					out3[xx + 1] = RGB_COLOR(16 + _3_8(r), 16 + _3_8(g), 16 + _3_8(b));
-				}
-			}
-		}
-	} else {
-		for(int y = 0, yy = 0; y < source->height; y += 2, yy += 6) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(yy + 0);
-			scrntype_t* out2 = dest->get_buffer(yy + 1);
-			scrntype_t* out3 = dest->get_buffer(yy + 2);
-			scrntype_t* out4 = dest->get_buffer(yy + 3);
-			scrntype_t* out5 = dest->get_buffer(yy + 4);
-			scrntype_t* out6 = dest->get_buffer(yy + 5);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				t0[x] = A_OF_COLOR(c);
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1, xx = 0; x <= source->width; x++, xx += 2) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[xx    ] = out2[xx    ] = out3[xx    ] = out4[xx    ] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-				out1[xx + 1] = out2[xx + 1] = out3[xx + 1] = out4[xx + 1] = RGB_COLOR(16 + _5_8(r), 16 + _5_8(g), 16 + _5_8(b));
-				if(t0[x]) {
-					out5[xx    ] = out6[xx    ] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-					out5[xx + 1] = out6[xx + 1] = RGB_COLOR(16 + _5_8(r), 16 + _5_8(g), 16 + _5_8(b));
-				} else {
-					out5[xx    ] = out6[xx    ] = RGB_COLOR(32 + _3_8(r), 32 + _3_8(g), 32 + _3_8(b));
-					out5[xx + 1] = out6[xx + 1] = RGB_COLOR(16 + _3_8(r), 16 + _3_8(g), 16 + _3_8(b));
-				}
-			}
-		}
-	}
-}
-
-void OSD::apply_rgb_filter_x2_y2(bitmap_t *source, bitmap_t *dest)
-{
-	if(!screen_skip_line) {
-		for(int y = 0, yy = 0; y < source->height; y++, yy += 2) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(yy + 0);
-			scrntype_t* out2 = dest->get_buffer(yy + 1);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				t0[x] = A_OF_COLOR(c);
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1, xx = 0; x <= source->width; x++, xx += 2) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[xx    ] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-				out1[xx + 1] = RGB_COLOR(16 + _5_8(r), 16 + _5_8(g), 16 + _5_8(b));
-				if(t0[x]) {
-					out2[xx    ] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-					out2[xx + 1] = RGB_COLOR(16 + _5_8(r), 16 + _5_8(g), 16 + _5_8(b));
-				} else {
-					out2[xx    ] = RGB_COLOR(32 + _3_8(r), 32 + _3_8(g), 32 + _3_8(b));
-					out2[xx + 1] = RGB_COLOR(16 + _3_8(r), 16 + _3_8(g), 16 + _3_8(b));
-				}
-			}
-		}
-	} else {
-		for(int y = 0, yy = 0; y < source->height; y += 2, yy += 4) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(yy + 0);
-			scrntype_t* out2 = dest->get_buffer(yy + 1);
-			scrntype_t* out3 = dest->get_buffer(yy + 2);
-			scrntype_t* out4 = dest->get_buffer(yy + 3);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				t0[x] = A_OF_COLOR(c);
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1, xx = 0; x <= source->width; x++, xx += 2) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[xx    ] = out2[xx    ] = out3[xx    ] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-				out1[xx + 1] = out2[xx + 1] = out3[xx + 1] = RGB_COLOR(16 + _5_8(r), 16 + _5_8(g), 16 + _5_8(b));
-				if(t0[x]) {
-					out4[xx    ] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-					out4[xx + 1] = RGB_COLOR(16 + _5_8(r), 16 + _5_8(g), 16 + _5_8(b));
-				} else {
-					out4[xx    ] = RGB_COLOR(32 + _3_8(r), 32 + _3_8(g), 32 + _3_8(b));
-					out4[xx + 1] = RGB_COLOR(16 + _3_8(r), 16 + _3_8(g), 16 + _3_8(b));
-				}
-			}
-		}
-	}
-}
-
-void OSD::apply_rgb_filter_x1_y1(bitmap_t *source, bitmap_t *dest)
-{
-	if(!screen_skip_line) {
-		for(int y = 0; y < source->height; y++) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(y + 0);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1; x <= source->width; x++) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[x - 1] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-			}
-		}
-	} else {
-		for(int y = 0; y < source->height; y += 2) {
-			scrntype_t* src = source->get_buffer(y);
-			scrntype_t* out1 = dest->get_buffer(y + 0);
-			scrntype_t* out2 = dest->get_buffer(y + 1);
-			
-			for(int x = 1; x <= source->width; x++) {
-				scrntype_t c = src[x - 1];
-				t0[x] = A_OF_COLOR(c);
-				r0[x] = R_OF_COLOR(c);
-				g0[x] = G_OF_COLOR(c);
-				b0[x] = B_OF_COLOR(c);
-				r1[x] = r0[x] >> 3;
-				g1[x] = g0[x] >> 3;
-				b1[x] = b0[x] >> 3;
-			}
-			for(int x = 1; x <= source->width; x++) {
-				uint32_t r = r1[x - 1] + r0[x] + r1[x + 1];
-				uint32_t g = g1[x - 1] + g0[x] + g1[x + 1];
-				uint32_t b = b1[x - 1] + b0[x] + b1[x + 1];
-				out1[x - 1] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-				if(t0[x]) {
-					out2[x - 1] = RGB_COLOR(32 + _8_8(r), 32 + _8_8(g), 32 + _8_8(b));
-				} else {
-					out2[x - 1] = RGB_COLOR(32 + _3_8(r), 32 + _3_8(g), 32 + _3_8(b));
-				}
-			}
-		}
+		run_scaler(source, dest, true);
 	}
 }
 #endif
@@ -1064,40 +708,206 @@ void OSD::stretch_screen_buffer(bitmap_t *source, bitmap_t *dest)
 {
 	if((dest->width % source->width) == 0 && (dest->height % source->height) == 0) {
 		// faster than StretchBlt()
-		int pow_x = dest->width / source->width;
-		int pow_y = dest->height / source->height;
+		run_scaler(source, dest, false);
+	} else {
+		StretchBlt(dest->hdcDib, 0, 0, dest->width, dest->height, source->hdcDib, 0, 0, source->width, source->height, SRCCOPY);
+	}
+}
+
+// scaler, rgb filter and rendering of vm device are processed by bands of lines in parallel,
+// and sound devices are mixed by one device per band
+
+#define SCALER_BAND_LINES	32
+#define SCALER_PARALLEL_PIXELS	(1024 * 512)
+#define RENDER_BAND_LINES	16
+
+static void process_scaler_bands(scaler_job_t *p)
+{
+	LONG i;
+	
+	while((i = InterlockedIncrement(&p->next) - 1) < p->bands) {
+		int y_begin = p->band_lines * i;
+		int y_end = (y_begin + p->band_lines < p->lines) ? y_begin + p->band_lines : p->lines;
 		
-		for(int y = 0, yy = 0; y < source->height; y++, yy += pow_y) {
-			scrntype_t* source_buffer = source->get_buffer(y);
-			scrntype_t* dest_buffer = dest->get_buffer(yy);
-			
-			if(pow_x != 1) {
-				scrntype_t* tmp_buffer = dest_buffer;
-				for(int x = 0; x < source->width; x++) {
-					scrntype_t c = source_buffer[x];
-					for(int px = 0; px < pow_x; px++) {
-						tmp_buffer[px] = c;
-					}
-					tmp_buffer += pow_x;
-				}
-			} else {
-				// about 10% faster than memcpy()
-				for(int x = 0; x < source->width; x++) {
-					dest_buffer[x] = source_buffer[x];
-				}
+		if(p->mix_devices != NULL) {
+			p->mix_devices[i]->mix(p->mix_buffers[i], p->mix_samples[i]);
+		} else if(p->device != NULL) {
+			p->device->render_lines(y_begin, y_end);
+		} else if(p->rgb_filter) {
+			scaler_rgb_filter(&p->source, &p->dest, p->pow_x, p->pow_y, p->skip_line, y_begin, y_end);
+		} else {
+			scaler_stretch(&p->source, &p->dest, y_begin, y_end);
+		}
+	}
+}
+
+unsigned __stdcall scaler_thread(void *lpx)
+{
+	volatile scaler_thread_param_t *p = (scaler_thread_param_t *)lpx;
+	
+	while(1) {
+		WaitForSingleObject(p->hStart, INFINITE);
+		if(p->terminate) {
+			break;
+		}
+		process_scaler_bands(p->job);
+		SetEvent(p->hDone);
+	}
+	_endthreadex(0);
+	return 0;
+}
+
+void OSD::initialize_scaler()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int threads = (int)info.dwNumberOfProcessors - 1;
+	if(threads > MAX_SCALER_THREADS) {
+		threads = MAX_SCALER_THREADS;
+	}
+	scaler_threads = render_threads = 0;
+	
+	for(int i = 0; i < threads; i++) {
+		scaler_thread_param_t *p = &scaler_thread_param[scaler_threads];
+		p->job = &scaler_job;
+		p->hStart = CreateEvent(NULL, FALSE, FALSE, NULL);
+		p->hDone = CreateEvent(NULL, FALSE, FALSE, NULL);
+		p->terminate = false;
+		
+		if(p->hStart != NULL && p->hDone != NULL && (hScalerThread[scaler_threads] = (HANDLE)_beginthreadex(NULL, 0, scaler_thread, p, 0, NULL)) != (HANDLE)0) {
+			hScalerDone[scaler_threads++] = p->hDone;
+		} else {
+			if(p->hStart != NULL) {
+				CloseHandle(p->hStart);
 			}
-			if(pow_y != 1) {
-				for(int py = 1; py < pow_y; py++) {
-					// about 10% faster than memcpy()
-					scrntype_t* tmp_buffer = dest->get_buffer(yy + py);
-					for(int x = 0; x < dest->width; x++) {
-						tmp_buffer[x] = dest_buffer[x];
-					}
-				}
+			if(p->hDone != NULL) {
+				CloseHandle(p->hDone);
 			}
+			break;
 		}
-	} else {
-		StretchBlt(dest->hdcDib, 0, 0, dest->width, dest->height, source->hdcDib, 0, 0, source->width, source->height, SRCCOPY);
+	}
+}
+
+void OSD::release_scaler()
+{
+	finish_render_lines();
+	
+	for(int i = 0; i < scaler_threads; i++) {
+		scaler_thread_param[i].terminate = true;
+		SetEvent(scaler_thread_param[i].hStart);
+	}
+	if(scaler_threads != 0) {
+		WaitForMultipleObjects(scaler_threads, hScalerThread, TRUE, INFINITE);
+	}
+	for(int i = 0; i < scaler_threads; i++) {
+		CloseHandle(hScalerThread[i]);
+		CloseHandle(scaler_thread_param[i].hStart);
+		CloseHandle(scaler_thread_param[i].hDone);
+	}
+	scaler_threads = 0;
+}
+
+void OSD::run_scaler(bitmap_t *source, bitmap_t *dest, bool rgb_filter)
+{
+	scaler_job_t *p = &scaler_job;
+	
+	// the job is shared with the renderer of vm device
+	finish_render_lines();
+	
+	// bitmap is bottom-up
+	p->source.top = source->get_buffer(0);
+	p->source.pitch = -source->width;
+	p->source.width = source->width;
+	p->source.height = source->height;
+	p->dest.top = dest->get_buffer(0);
+	p->dest.pitch = -dest->width;
+	p->dest.width = dest->width;
+	p->dest.height = dest->height;
+	p->device = NULL;
+	p->mix_devices = NULL;
+	p->rgb_filter = rgb_filter;
+#ifdef USE_SCREEN_FILTER
+	p->skip_line = rgb_filter && screen_skip_line;
+#else
+	p->skip_line = false;
+#endif
+	p->pow_x = dest->width / source->width;
+	p->pow_y = dest->height / source->height;
+	p->lines = source->height;
+	p->band_lines = SCALER_BAND_LINES;
+	p->bands = (source->height + SCALER_BAND_LINES - 1) / SCALER_BAND_LINES;
+	p->next = 0;
+	
+	int threads = 0;
+	if(dest->width * dest->height >= SCALER_PARALLEL_PIXELS) {
+		threads = (scaler_threads < p->bands - 1) ? scaler_threads : p->bands - 1;
+	}
+	for(int i = 0; i < threads; i++) {
+		SetEvent(scaler_thread_param[i].hStart);
+	}
+	// this thread also takes bands
+	process_scaler_bands(p);
+	if(threads != 0) {
+		WaitForMultipleObjects(threads, hScalerDone, TRUE, INFINITE);
+	}
+}
+
+void OSD::start_render_lines(DEVICE* device, int lines)
+{
+	scaler_job_t *p = &scaler_job;
+	
+	finish_render_lines();
+	
+	p->device = device;
+	p->mix_devices = NULL;
+	p->lines = lines;
+	p->band_lines = RENDER_BAND_LINES;
+	p->bands = (lines + RENDER_BAND_LINES - 1) / RENDER_BAND_LINES;
+	p->next = 0;
+	
+	if(scaler_threads == 0) {
+		// no worker thread, render now
+		process_scaler_bands(p);
+		return;
+	}
+	// workers render lines while this thread continues to emulate the next lines
+	render_threads = (scaler_threads < p->bands) ? scaler_threads : p->bands;
+	for(int i = 0; i < render_threads; i++) {
+		SetEvent(scaler_thread_param[i].hStart);
+	}
+}
+
+void OSD::finish_render_lines()
+{
+	if(render_threads != 0) {
+		WaitForMultipleObjects(render_threads, hScalerDone, TRUE, INFINITE);
+		render_threads = 0;
+	}
+}
+
+void OSD::run_mix_sound(DEVICE** devices, int32_t** buffers, int count, int* samples)
+{
+	scaler_job_t *p = &scaler_job;
+	
+	// the job is shared with the renderer of vm device
+	finish_render_lines();
+	
+	p->device = NULL;
+	p->mix_devices = devices;
+	p->mix_buffers = buffers;
+	p->mix_samples = samples;
+	p->lines = p->bands = count;
+	p->band_lines = 1;
+	p->next = 0;
+	
+	int threads = (scaler_threads < count - 1) ? scaler_threads : count - 1;
+	for(int i = 0; i < threads; i++) {
+		SetEvent(scaler_thread_param[i].hStart);
+	}
+	// this thread also mixes devices
+	process_scaler_bands(p);
+	if(threads != 0) {
+		WaitForMultipleObjects(threads, hScalerDone, TRUE, INFINITE);
 	}
 }
 
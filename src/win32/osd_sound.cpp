@@ -13,12 +13,109 @@
 #define DSOUND_BUFFER_SIZE (DWORD)(sound_samples * 8)
 #define DSOUND_BUFFER_HALF (DWORD)(sound_samples * 4)
 
+#define SOUND_THREAD_PERIOD	5	// msec
+#define SOUND_THREAD_LEAD	20	// msec
+#define SOUND_RATE_CONTROL	0.005	// +/-0.5%
+
+static void write_sound_ring(sound_thread_params_t *p, DWORD offset, DWORD size)
+{
+	int16_t *ptr[2];
+	DWORD len[2];
+	
+	if(p->lpdsSecondaryBuffer->Lock(offset, size, (void **)&ptr[0], &len[0], (void **)&ptr[1], &len[1], 0) == DSERR_BUFFERLOST) {
+		p->lpdsSecondaryBuffer->Restore();
+		return;
+	}
+	int read = p->ring_read;
+	int count = (p->ring_write - read + p->ring_size) % p->ring_size;
+	
+	// consume a little faster or slower to keep the samples in the ring
+	p->ring_fill += (count - p->ring_fill) / 16.0;
+	double error = (p->ring_fill - p->ring_target) / p->ring_target;
+	if(error > 1.0) {
+		error = 1.0;
+	} else if(error < -1.0) {
+		error = -1.0;
+	}
+	uint32_t step = (uint32_t)(65536.0 * (1.0 + SOUND_RATE_CONTROL * error) + 0.5);
+	bool underrun = false;
+	
+	for(int i = 0; i < 2; i++) {
+		int16_t *dest = ptr[i];
+		for(DWORD j = 0; dest != NULL && j < len[i]; j += 4) {
+			if(count >= 2) {
+				// linear interpolation between the samples
+				int next = (read + 1 < p->ring_size) ? read + 1 : 0;
+				int frac = (p->ring_frac & 0xffff) >> 1;
+				*dest++ = (int16_t)(p->ring[read * 2    ] + (((p->ring[next * 2    ] - p->ring[read * 2    ]) * frac) >> 15));
+				*dest++ = (int16_t)(p->ring[read * 2 + 1] + (((p->ring[next * 2 + 1] - p->ring[read * 2 + 1]) * frac) >> 15));
+				p->ring_frac += step;
+				while(p->ring_frac >= 0x10000 && count >= 2) {
+					read = next;
+					next = (read + 1 < p->ring_size) ? read + 1 : 0;
+					p->ring_frac -= 0x10000;
+					count--;
+				}
+			} else {
+				*dest++ = 0;
+				*dest++ = 0;
+				underrun = !p->muted;
+			}
+		}
+	}
+	p->lpdsSecondaryBuffer->Unlock(ptr[0], len[0], ptr[1], len[1]);
+	InterlockedExchange(&p->ring_read, read);
+	
+	if(underrun) {
+		InterlockedIncrement(&p->underruns);
+	}
+}
+
+static unsigned __stdcall sound_thread(void *lpx)
+{
+	sound_thread_params_t *p = (sound_thread_params_t *)lpx;
+	
+	while(!p->terminate) {
+		DWORD play_c, write_c;
+		
+		if(p->flush) {
+			// discard the samples in the ring
+			InterlockedExchange(&p->ring_read, p->ring_write);
+			p->ring_frac = 0;
+			p->flush = false;
+		}
+		if(p->started && SUCCEEDED(p->lpdsSecondaryBuffer->GetCurrentPosition(&play_c, &write_c))) {
+			DWORD lead = (p->write_pos + p->buffer_size - play_c) % p->buffer_size;
+			DWORD safe = (write_c + p->buffer_size - play_c) % p->buffer_size;
+			
+			if(p->write_pos == 0xffffffff || lead < safe) {
+				// the play cursor passed the written samples
+				if(p->write_pos != 0xffffffff && !p->muted) {
+					InterlockedIncrement(&p->underruns);
+				}
+				p->write_pos = write_c;
+				lead = safe;
+			}
+			if(lead < p->lead_size) {
+				DWORD size = (p->lead_size - lead) & ~3;
+				write_sound_ring(p, p->write_pos, size);
+				p->write_pos = (p->write_pos + size) % p->buffer_size;
+			}
+		}
+		Sleep(SOUND_THREAD_PERIOD);
+	}
+	_endthreadex(0);
+	return 0;
+}
+
 void OSD::initialize_sound(int rate, int samples)
 {
 	sound_rate = rate;
 	sound_samples = samples;
 	sound_available = sound_started = sound_muted = now_record_sound = false;
 	rec_sound_buffer_ptr = 0;
+	hSoundThread = NULL;
+	sound_overruns = 0;
 	
 	// initialize direct sound
 	PCMWAVEFORMAT pcmwf;
@@ -68,10 +165,49 @@ void OSD::initialize_sound(int rate, int samples)
 	}
 	
 	sound_available = sound_first_half = true;
+	
+	// start audio thread
+	if(config.sound_audio_thread) {
+		sound_thread_params_t *p = &sound_thread_params;
+		
+		p->lpdsSecondaryBuffer = lpdsSecondaryBuffer;
+		p->buffer_size = DSOUND_BUFFER_SIZE;
+		p->lead_size = (DWORD)(sound_rate * SOUND_THREAD_LEAD / 1000) * 4;
+		if(p->lead_size > DSOUND_BUFFER_HALF) {
+			p->lead_size = DSOUND_BUFFER_HALF;
+		}
+		p->write_pos = 0xffffffff;
+		p->ring_size = sound_samples * 2 + 1;
+		p->ring = (int16_t *)calloc(p->ring_size * 2, sizeof(int16_t));
+		p->ring_target = sound_samples;
+		p->ring_read = p->ring_write = 0;
+		p->ring_frac = 0;
+		p->ring_fill = p->ring_target;
+		p->underruns = 0;
+		p->started = p->muted = p->flush = p->terminate = false;
+		
+		if(p->ring != NULL && (hSoundThread = (HANDLE)_beginthreadex(NULL, 0, sound_thread, p, 0, NULL)) == (HANDLE)0) {
+			hSoundThread = NULL;
+		}
+		if(hSoundThread == NULL && p->ring != NULL) {
+			free(p->ring);
+			p->ring = NULL;
+		}
+	}
 }
 
 void OSD::release_sound()
 {
+	// stop audio thread
+	if(hSoundThread != NULL) {
+		sound_thread_params.terminate = true;
+		WaitForSingleObject(hSoundThread, INFINITE);
+		CloseHandle(hSoundThread);
+		hSoundThread = NULL;
+		free(sound_thread_params.ring);
+		sound_thread_params.ring = NULL;
+	}
+	
 	// release direct sound
 	if(lpdsPrimaryBuffer) {
 		lpdsPrimaryBuffer->Release();
@@ -108,6 +244,38 @@ void OSD::update_sound(int* extra_frames)
 		if(!sound_started) {
 			lpdsSecondaryBuffer->Play(0, 0, DSBPLAY_LOOPING);
 			sound_started = true;
+			if(hSoundThread != NULL) {
+				sound_thread_params.write_pos = 0xffffffff;
+				sound_thread_params.started = true;
+			}
+			return;
+		}
+		if(hSoundThread != NULL) {
+			sound_thread_params_t *p = &sound_thread_params;
+			int count = (p->ring_write - p->ring_read + p->ring_size) % p->ring_size;
+			
+			p->muted = false;
+			
+			// push the samples when the ring is going to be empty
+			if(count >= p->ring_target / 2) {
+				if(vm->get_sound_buffer_ptr() >= sound_samples * 2) {
+					// the sound buffer of vm is full, and the samples are lost
+					sound_overruns++;
+				}
+				return;
+			}
+			uint16_t* sound_buffer = vm->create_sound(extra_frames);
+			record_sound(sound_buffer);
+			
+			int write = p->ring_write;
+			for(int i = 0; i < sound_samples; i++) {
+				p->ring[write * 2    ] = (int16_t)sound_buffer[i * 2    ];
+				p->ring[write * 2 + 1] = (int16_t)sound_buffer[i * 2 + 1];
+				if(++write == p->ring_size) {
+					write = 0;
+				}
+			}
+			InterlockedExchange(&p->ring_write, write);
 			return;
 		}
 		
@@ -129,35 +297,7 @@ void OSD::update_sound(int* extra_frames)
 		
 		// sound buffer must be updated
 		uint16_t* sound_buffer = vm->create_sound(extra_frames);
-		if(now_record_sound) {
-			// record sound
-			if(sound_samples > rec_sound_buffer_ptr) {
-				int samples = sound_samples - rec_sound_buffer_ptr;
-				int length = samples * sizeof(uint16_t) * 2; // stereo
-				rec_sound_fio->Fwrite(sound_buffer + rec_sound_buffer_ptr * 2, length, 1);
-				rec_sound_bytes += length;
-				if(now_record_video) {
-					// sync video recording
-					static double frames = 0;
-					static int prev_samples = -1;
-					static double prev_fps = -1;
-					double fps = vm->get_frame_rate();
-					if(prev_samples != samples || prev_fps != fps) {
-						prev_samples = samples;
-						prev_fps = fps;
-						frames = fps * (double)samples / (double)sound_rate;
-					}
-					rec_video_frames -= frames;
-					if(rec_video_frames > 2) {
-						rec_video_run_frames -= (rec_video_frames - 2);
-					} else if(rec_video_frames < -2) {
-						rec_video_run_frames -= (rec_video_frames + 2);
-					}
-//					rec_video_run_frames -= rec_video_frames;
-				}
-			}
-			rec_sound_buffer_ptr = 0;
-		}
+		record_sound(sound_buffer);
 		if(lpdsSecondaryBuffer->Lock(offset, DSOUND_BUFFER_HALF, (void **)&ptr1, &size1, (void**)&ptr2, &size2, 0) == DSERR_BUFFERLOST) {
 			lpdsSecondaryBuffer->Restore();
 		}
@@ -174,9 +314,46 @@ void OSD::update_sound(int* extra_frames)
 	}
 }
 
+void OSD::record_sound(uint16_t* sound_buffer)
+{
+	if(now_record_sound) {
+		// record sound
+		if(sound_samples > rec_sound_buffer_ptr) {
+			int samples = sound_samples - rec_sound_buffer_ptr;
+			int length = samples * sizeof(uint16_t) * 2; // stereo
+			rec_sound_fio->Fwrite(sound_buffer + rec_sound_buffer_ptr * 2, length, 1);
+			rec_sound_bytes += length;
+			if(now_record_video) {
+				// sync video recording
+				static double frames = 0;
+				static int prev_samples = -1;
+				static double prev_fps = -1;
+				double fps = vm->get_frame_rate();
+				if(prev_samples != samples || prev_fps != fps) {
+					prev_samples = samples;
+					prev_fps = fps;
+					frames = fps * (double)samples / (double)sound_rate;
+				}
+				rec_video_frames -= frames;
+				if(rec_video_frames > 2) {
+					rec_video_run_frames -= (rec_video_frames - 2);
+				} else if(rec_video_frames < -2) {
+					rec_video_run_frames -= (rec_video_frames + 2);
+				}
+//				rec_video_run_frames -= rec_video_frames;
+			}
+		}
+		rec_sound_buffer_ptr = 0;
+	}
+}
+
 void OSD::mute_sound()
 {
-	if(sound_available && !sound_muted) {
+	if(hSoundThread != NULL) {
+		// the audio thread writes silence while the ring is empty
+		sound_thread_params.muted = true;
+		sound_thread_params.flush = true;
+	} else if(sound_available && !sound_muted) {
 		// check current position
 		DWORD size1, size2;
 		WORD *ptr1, *ptr2;
@@ -198,6 +375,10 @@ void OSD::mute_sound()
 void OSD::stop_sound()
 {
 	if(sound_available && sound_started) {
+		if(hSoundThread != NULL) {
+			sound_thread_params.started = false;
+			sound_thread_params.flush = true;
+		}
 		lpdsSecondaryBuffer->Stop();
 		sound_started = false;
 	}
@@ -81,6 +81,7 @@ void open_recent_quick_disk(int drv, int index);
 void open_hard_disk_dialog(HWND hWnd, int drv);
 void open_recent_hard_disk(int drv, int index);
 void open_blank_hard_disk_dialog(HWND hWnd, int drv, int sector_size, int sectors, int surfaces, int cylinders);
+void open_hard_disk_overlay_dialog(HWND hWnd, int drv);
 #endif
 #ifdef USE_TAPE
 void open_tape_dialog(HWND hWnd, int drv, bool play);
@@ -310,6 +311,7 @@ int WINAPI _tWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR szCmdL
 	DWORD next_time = 0;
 	bool prev_skip = false;
 	DWORD update_fps_time = 0;
+	int prev_underruns = 0, prev_overruns = 0;
 	DWORD update_status_bar_time = 0;
 	DWORD disable_screen_saver_time = 0;
 	MSG msg;
@@ -388,6 +390,16 @@ int WINAPI _tWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR szCmdL
 			DWORD current_time = timeGetTime();
 			if(update_fps_time <= current_time) {
 				if(update_fps_time != 0) {
+					// check the sound buffer underrun/overrun in this period
+					int underruns = emu->get_sound_underrun_count();
+					int overruns = emu->get_sound_overrun_count();
+					bool sound_error = (underruns > prev_underruns || overruns > prev_overruns);
+					if(sound_error) {
+						emu->out_debug_log(_T("Sound: %d underruns, %d overruns\n"), underruns, overruns);
+					}
+					prev_underruns = underruns;
+					prev_overruns = overruns;
+					
 					if(emu->message_count > 0) {
 						SetWindowText(hWnd, create_string(_T("%s - %s"), _T(DEVICE_NAME), emu->message));
 						emu->message_count--;
@@ -396,7 +408,11 @@ int WINAPI _tWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR szCmdL
 						SetWindowText(hWnd, create_string(_T("%s - Skip Frames (%d %%)"), _T(DEVICE_NAME), ratio));
 					} else {
 						int ratio = (int)(100.0 * (double)draw_frames / (double)total_frames + 0.5);
-						SetWindowText(hWnd, create_string(_T("%s - %d fps (%d %%)"), _T(DEVICE_NAME), draw_frames, ratio));
+						if(sound_error) {
+							SetWindowText(hWnd, create_string(_T("%s - %d fps (%d %%) - Sound Buffer Error"), _T(DEVICE_NAME), draw_frames, ratio));
+						} else {
+							SetWindowText(hWnd, create_string(_T("%s - %d fps (%d %%)"), _T(DEVICE_NAME), draw_frames, ratio));
+						}
 					}
 					update_fps_time += 1000;
 					total_frames = draw_frames = 0;
@@ -1241,7 +1257,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT iMsg, WPARAM wParam, LPARAM lParam)
 #endif
 #ifdef USE_HARD_DISK
 	#if USE_HARD_DISK >= 1
-		#define HD_MENU_ITEMS(drv, ID_OPEN_HD, ID_CLOSE_HD, ID_OPEN_BLANK_20MB_HD, ID_OPEN_BLANK_20MB_1024_HD, ID_OPEN_BLANK_40MB_HD, ID_RECENT_HD) \
+		#define HD_MENU_ITEMS(drv, ID_OPEN_HD, ID_CLOSE_HD, ID_OPEN_BLANK_20MB_HD, ID_OPEN_BLANK_20MB_1024_HD, ID_OPEN_BLANK_40MB_HD, ID_OPEN_OVERLAY_HD, ID_COMMIT_OVERLAY_HD, ID_DISCARD_OVERLAY_HD, ID_RECENT_HD) \
 		case ID_OPEN_HD: \
 			if(emu) { \
 				open_hard_disk_dialog(hWnd, drv); \
@@ -1267,34 +1283,49 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT iMsg, WPARAM wParam, LPARAM lParam)
 				open_blank_hard_disk_dialog(hWnd, drv, 256, 33, 8, 615); \
 			} \
 			break; \
+		case ID_OPEN_OVERLAY_HD: \
+			if(emu) { \
+				open_hard_disk_overlay_dialog(hWnd, drv); \
+			} \
+			break; \
+		case ID_COMMIT_OVERLAY_HD: \
+			if(emu) { \
+				emu->commit_hard_disk_overlay(drv); \
+			} \
+			break; \
+		case ID_DISCARD_OVERLAY_HD: \
+			if(emu) { \
+				emu->discard_hard_disk_overlay(drv); \
+			} \
+			break; \
 		case ID_RECENT_HD + 0: case ID_RECENT_HD + 1: case ID_RECENT_HD + 2: case ID_RECENT_HD + 3: \
 		case ID_RECENT_HD + 4: case ID_RECENT_HD + 5: case ID_RECENT_HD + 6: case ID_RECENT_HD + 7: \
 			if(emu) { \
 				open_recent_hard_disk(drv, LOWORD(wParam) - ID_RECENT_HD); \
 			} \
 			break;
-		HD_MENU_ITEMS(0, ID_OPEN_HD1, ID_CLOSE_HD1, ID_OPEN_BLANK_20MB_HD1, ID_OPEN_BLANK_20MB_1024_HD1, ID_OPEN_BLANK_40MB_HD1, ID_RECENT_HD1)
+		HD_MENU_ITEMS(0, ID_OPEN_HD1, ID_CLOSE_HD1, ID_OPEN_BLANK_20MB_HD1, ID_OPEN_BLANK_20MB_1024_HD1, ID_OPEN_BLANK_40MB_HD1, ID_OPEN_OVERLAY_HD1, ID_COMMIT_OVERLAY_HD1, ID_DISCARD_OVERLAY_HD1, ID_RECENT_HD1)
 	#endif
 	#if USE_HARD_DISK >= 2
-		HD_MENU_ITEMS(1, ID_OPEN_HD2, ID_CLOSE_HD2, ID_OPEN_BLANK_20MB_HD2, ID_OPEN_BLANK_20MB_1024_HD2, ID_OPEN_BLANK_40MB_HD2, ID_RECENT_HD2)
+		HD_MENU_ITEMS(1, ID_OPEN_HD2, ID_CLOSE_HD2, ID_OPEN_BLANK_20MB_HD2, ID_OPEN_BLANK_20MB_1024_HD2, ID_OPEN_BLANK_40MB_HD2, ID_OPEN_OVERLAY_HD2, ID_COMMIT_OVERLAY_HD2, ID_DISCARD_OVERLAY_HD2, ID_RECENT_HD2)
 	#endif
 	#if USE_HARD_DISK >= 3
-		HD_MENU_ITEMS(2, ID_OPEN_HD3, ID_CLOSE_HD3, ID_OPEN_BLANK_20MB_HD3, ID_OPEN_BLANK_20MB_1024_HD3, ID_OPEN_BLANK_40MB_HD3, ID_RECENT_HD3)
+		HD_MENU_ITEMS(2, ID_OPEN_HD3, ID_CLOSE_HD3, ID_OPEN_BLANK_20MB_HD3, ID_OPEN_BLANK_20MB_1024_HD3, ID_OPEN_BLANK_40MB_HD3, ID_OPEN_OVERLAY_HD3, ID_COMMIT_OVERLAY_HD3, ID_DISCARD_OVERLAY_HD3, ID_RECENT_HD3)
 	#endif
 	#if USE_HARD_DISK >= 4
-		HD_MENU_ITEMS(3, ID_OPEN_HD4, ID_CLOSE_HD4, ID_OPEN_BLANK_20MB_HD4, ID_OPEN_BLANK_20MB_1024_HD4, ID_OPEN_BLANK_40MB_HD4, ID_RECENT_HD4)
+		HD_MENU_ITEMS(3, ID_OPEN_HD4, ID_CLOSE_HD4, ID_OPEN_BLANK_20MB_HD4, ID_OPEN_BLANK_20MB_1024_HD4, ID_OPEN_BLANK_40MB_HD4, ID_OPEN_OVERLAY_HD4, ID_COMMIT_OVERLAY_HD4, ID_DISCARD_OVERLAY_HD4, ID_RECENT_HD4)
 	#endif
 	#if USE_HARD_DISK >= 5
-		HD_MENU_ITEMS(4, ID_OPEN_HD5, ID_CLOSE_HD5, ID_OPEN_BLANK_20MB_HD5, ID_OPEN_BLANK_20MB_1024_HD5, ID_OPEN_BLANK_40MB_HD5, ID_RECENT_HD5)
+		HD_MENU_ITEMS(4, ID_OPEN_HD5, ID_CLOSE_HD5, ID_OPEN_BLANK_20MB_HD5, ID_OPEN_BLANK_20MB_1024_HD5, ID_OPEN_BLANK_40MB_HD5, ID_OPEN_OVERLAY_HD5, ID_COMMIT_OVERLAY_HD5, ID_DISCARD_OVERLAY_HD5, ID_RECENT_HD5)
 	#endif
 	#if USE_HARD_DISK >= 6
-		HD_MENU_ITEMS(5, ID_OPEN_HD6, ID_CLOSE_HD6, ID_OPEN_BLANK_20MB_HD6, ID_OPEN_BLANK_20MB_1024_HD6, ID_OPEN_BLANK_40MB_HD6, ID_RECENT_HD6)
+		HD_MENU_ITEMS(5, ID_OPEN_HD6, ID_CLOSE_HD6, ID_OPEN_BLANK_20MB_HD6, ID_OPEN_BLANK_20MB_1024_HD6, ID_OPEN_BLANK_40MB_HD6, ID_OPEN_OVERLAY_HD6, ID_COMMIT_OVERLAY_HD6, ID_DISCARD_OVERLAY_HD6, ID_RECENT_HD6)
 	#endif
 	#if USE_HARD_DISK >= 7
-		HD_MENU_ITEMS(6, ID_OPEN_HD7, ID_CLOSE_HD7, ID_OPEN_BLANK_20MB_HD7, ID_OPEN_BLANK_20MB_1024_HD7, ID_OPEN_BLANK_40MB_HD7, ID_RECENT_HD7)
+		HD_MENU_ITEMS(6, ID_OPEN_HD7, ID_CLOSE_HD7, ID_OPEN_BLANK_20MB_HD7, ID_OPEN_BLANK_20MB_1024_HD7, ID_OPEN_BLANK_40MB_HD7, ID_OPEN_OVERLAY_HD7, ID_COMMIT_OVERLAY_HD7, ID_DISCARD_OVERLAY_HD7, ID_RECENT_HD7)
 	#endif
 	#if USE_HARD_DISK >= 8
-		HD_MENU_ITEMS(7, ID_OPEN_HD8, ID_CLOSE_HD8, ID_OPEN_BLANK_20MB_HD8, ID_OPEN_BLANK_20MB_1024_HD8, ID_OPEN_BLANK_40MB_HD8, ID_RECENT_HD8)
+		HD_MENU_ITEMS(7, ID_OPEN_HD8, ID_CLOSE_HD8, ID_OPEN_BLANK_20MB_HD8, ID_OPEN_BLANK_20MB_1024_HD8, ID_OPEN_BLANK_40MB_HD8, ID_OPEN_OVERLAY_HD8, ID_COMMIT_OVERLAY_HD8, ID_DISCARD_OVERLAY_HD8, ID_RECENT_HD8)
 	#endif
 #endif
 #ifdef USE_TAPE
@@ -1715,7 +1746,7 @@ void update_quick_disk_menu(HMENU hMenu, int drv, UINT ID_RECENT_QD, UINT ID_CLO
 #endif
 
 #ifdef USE_HARD_DISK
-void update_hard_disk_menu(HMENU hMenu, int drv, UINT ID_RECENT_HD, UINT ID_CLOSE_HD)
+void update_hard_disk_menu(HMENU hMenu, int drv, UINT ID_RECENT_HD, UINT ID_CLOSE_HD, UINT ID_COMMIT_OVERLAY_HD, UINT ID_DISCARD_OVERLAY_HD)
 {
 	bool flag = false;
 	for(int i = 0; i < MAX_HISTORY; i++) {
@@ -1731,6 +1762,8 @@ void update_hard_disk_menu(HMENU hMenu, int drv, UINT ID_RECENT_HD, UINT ID_CLOS
 		AppendMenu(hMenu, MF_GRAYED | MF_STRING, ID_RECENT_HD, _T("None"));
 	}
 	EnableMenuItem(hMenu, ID_CLOSE_HD, emu->is_hard_disk_inserted(drv) ? MF_ENABLED : MF_GRAYED);
+	EnableMenuItem(hMenu, ID_COMMIT_OVERLAY_HD, emu->is_hard_disk_overlay(drv) ? MF_ENABLED : MF_GRAYED);
+	EnableMenuItem(hMenu, ID_DISCARD_OVERLAY_HD, emu->is_hard_disk_overlay(drv) ? MF_ENABLED : MF_GRAYED);
 }
 #endif
 
@@ -2292,42 +2325,42 @@ void update_popup_menu(HWND hWnd, HMENU hMenu)
 #ifdef USE_HARD_DISK
 #if USE_HARD_DISK >= 1
 	else if(id >= ID_HD1_MENU_START && id <= ID_HD1_MENU_END) {
-		update_hard_disk_menu(hMenu, 0, ID_RECENT_HD1, ID_CLOSE_HD1);
+		update_hard_disk_menu(hMenu, 0, ID_RECENT_HD1, ID_CLOSE_HD1, ID_COMMIT_OVERLAY_HD1, ID_DISCARD_OVERLAY_HD1);
 	}
 #endif
 #if USE_HARD_DISK >= 2
 	else if(id >= ID_HD2_MENU_START && id <= ID_HD2_MENU_END) {
-		update_hard_disk_menu(hMenu, 1, ID_RECENT_HD2, ID_CLOSE_HD2);
+		update_hard_disk_menu(hMenu, 1, ID_RECENT_HD2, ID_CLOSE_HD2, ID_COMMIT_OVERLAY_HD2, ID_DISCARD_OVERLAY_HD2);
 	}
 #endif
 #if USE_HARD_DISK >= 3
 	else if(id >= ID_HD3_MENU_START && id <= ID_HD3_MENU_END) {
-		update_hard_disk_menu(hMenu, 2, ID_RECENT_HD3, ID_CLOSE_HD3);
+		update_hard_disk_menu(hMenu, 2, ID_RECENT_HD3, ID_CLOSE_HD3, ID_COMMIT_OVERLAY_HD3, ID_DISCARD_OVERLAY_HD3);
 	}
 #endif
 #if USE_HARD_DISK >= 4
 	else if(id >= ID_HD4_MENU_START && id <= ID_HD4_MENU_END) {
-		update_hard_disk_menu(hMenu, 3, ID_RECENT_HD4, ID_CLOSE_HD4);
+		update_hard_disk_menu(hMenu, 3, ID_RECENT_HD4, ID_CLOSE_HD4, ID_COMMIT_OVERLAY_HD4, ID_DISCARD_OVERLAY_HD4);
 	}
 #endif
 #if USE_HARD_DISK >= 5
 	else if(id >= ID_HD5_MENU_START && id <= ID_HD5_MENU_END) {
-		update_hard_disk_menu(hMenu, 4, ID_RECENT_HD5, ID_CLOSE_HD5);
+		update_hard_disk_menu(hMenu, 4, ID_RECENT_HD5, ID_CLOSE_HD5, ID_COMMIT_OVERLAY_HD5, ID_DISCARD_OVERLAY_HD5);
 	}
 #endif
 #if USE_HARD_DISK >= 6
 	else if(id >= ID_HD6_MENU_START && id <= ID_HD6_MENU_END) {
-		update_hard_disk_menu(hMenu, 5, ID_RECENT_HD6, ID_CLOSE_HD6);
+		update_hard_disk_menu(hMenu, 5, ID_RECENT_HD6, ID_CLOSE_HD6, ID_COMMIT_OVERLAY_HD6, ID_DISCARD_OVERLAY_HD6);
 	}
 #endif
 #if USE_HARD_DISK >= 7
 	else if(id >= ID_HD7_MENU_START && id <= ID_HD7_MENU_END) {
-		update_hard_disk_menu(hMenu, 6, ID_RECENT_HD7, ID_CLOSE_HD7);
+		update_hard_disk_menu(hMenu, 6, ID_RECENT_HD7, ID_CLOSE_HD7, ID_COMMIT_OVERLAY_HD7, ID_DISCARD_OVERLAY_HD7);
 	}
 #endif
 #if USE_HARD_DISK >= 8
 	else if(id >= ID_HD8_MENU_START && id <= ID_HD8_MENU_END) {
-		update_hard_disk_menu(hMenu, 7, ID_RECENT_HD8, ID_CLOSE_HD8);
+		update_hard_disk_menu(hMenu, 7, ID_RECENT_HD8, ID_CLOSE_HD8, ID_COMMIT_OVERLAY_HD8, ID_DISCARD_OVERLAY_HD8);
 	}
 #endif
 #endif
@@ -2901,7 +2934,7 @@ void open_hard_disk_dialog(HWND hWnd, int drv)
 {
 	_TCHAR* path = get_open_file_name(
 		hWnd,
-		_T("Supported Files (*.thd;*.nhd;*.hdi;*.hdd;*.dat)\0*.thd;*.nhd;*.hdi;*.hdd;*.dat\0All Files (*.*)\0*.*\0\0"),
+		_T("Supported Files (*.thd;*.nhd;*.hdi;*.hdd;*.dat;*.hdo)\0*.thd;*.nhd;*.hdi;*.hdd;*.dat;*.hdo\0All Files (*.*)\0*.*\0\0"),
 		_T("Hard Disk"),
 		NULL,
 		config.initial_hard_disk_dir, _MAX_PATH
@@ -2944,6 +2977,27 @@ void open_blank_hard_disk_dialog(HWND hWnd, int drv, int sector_size, int sector
 		}
 	}
 }
+
+void open_hard_disk_overlay_dialog(HWND hWnd, int drv)
+{
+	_TCHAR* path = get_open_file_name(
+		hWnd,
+		_T("Supported Files (*.thd;*.nhd;*.hdi;*.hdd;*.dat)\0*.thd;*.nhd;*.hdi;*.hdd;*.dat\0All Files (*.*)\0*.*\0\0"),
+		_T("Hard Disk [Base Image]"),
+		NULL,
+		config.initial_hard_disk_dir, _MAX_PATH
+	);
+	if(path) {
+		// the overlay is created next to the base image, and reused if it already exists
+		_TCHAR overlay_path[_MAX_PATH];
+		my_stprintf_s(overlay_path, _MAX_PATH, _T("%s.hdo"), path);
+		if(FILEIO::IsFileExisting(overlay_path) || emu->create_hard_disk_overlay(overlay_path, path)) {
+			UPDATE_HISTORY(overlay_path, config.recent_hard_disk_path[drv]);
+			my_tcscpy_s(config.initial_hard_disk_dir, _MAX_PATH, get_parent_dir(path));
+			emu->open_hard_disk(drv, overlay_path);
+		}
+	}
+}
 #endif
 
 #ifdef USE_TAPE
@@ -3204,7 +3258,8 @@ void open_any_file(const _TCHAR* path)
 	if(check_file_extension(path, _T(".thd")) || 
 	   check_file_extension(path, _T(".nhd")) || 
 	   check_file_extension(path, _T(".hdi")) || 
-	   check_file_extension(path, _T(".hdd"))) {
+	   check_file_extension(path, _T(".hdd")) || 
+	   check_file_extension(path, _T(".hdo"))) {
 		UPDATE_HISTORY(path, config.recent_hard_disk_path[0]);
 		my_tcscpy_s(config.initial_hard_disk_dir, _MAX_PATH, get_parent_dir(path));
 		emu->open_hard_disk(0, path);